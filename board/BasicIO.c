@@ -21,11 +21,24 @@
  * v4.2
  *  Created by Todd Morton
  *  Modified to fix bug in BOIGetStrg() so a BS can be the first character pressed.
+ * v4.3
+ *  Khoi Le, 10/19/2026
+ *  Transmit through a ring buffer drained by the UART2 TX interrupt.
+ *  Receive through a ring buffer filled by the UART2 RX interrupt and a
+ *  non-blocking line assembler, BIOLineTask().
+ *  Added BIOWriteBlock() to send binary blocks by eDMA.
+ *  BIOOpen() computes SBR/BRFA from K65TWR_BUS_CLK_HZ for any rate and can
+ *  enable the UART FIFOs.
+ *  Trace records in the UART2 and TX DMA interrupts.
  *******************************************************************************************
 * Project master header file
 ********************************************************************/
 #include "MCUType.h"
+#include "K65TWR_ClkCfg.h"
 #include "BasicIO.h"
+#include "RingBuf.h"
+#include "EventBus.h"
+#include "Trace.h"
 #include "math.h"
 
 /*******************************************************************************************
@@ -34,58 +47,129 @@
 static INT8C bioHtoA(INT8U hnib);   //Convert nibble to ascii
 static INT8U bioIsHex(INT8C c);
 static INT8U bioHtoB(INT8C c);
+void UART2_RX_TX_IRQHandler(void);  /* not static so the linker can see it */
+static INT32U bioRate;              /* achieved bit rate */
+static INT32S bioRateErr;           /* achieved - requested, ppm */
+#if BIO_FIFO_EN
+static INT8U bioTxDepth;            /* TX FIFO entries, 1 without a FIFO */
+#endif
+static void bioTxKick(void);
+#if BIO_TX_INT_EN
+static RINGBUF_T bioTxRing;
+static INT8U bioTxStore[RB_STORE_SIZE(BIO_TX_BUF_SIZE, 1U)];
+static BIO_TX_STATS_T bioTxStats;
+#endif
+#if BIO_TX_DMA_EN
+#define BIO_DMA_SRC_UART2_TX    7U
+void BIO_TX_DMA_IRQHandler(void);
+static volatile INT8U bioTxDmaBusy;
+static INT16U bioTxDmaLen;
+#endif
+static INT8U bioBlockHeld;          /* a multi-block message is being sent */
+#if BIO_RX_INT_EN
+static RINGBUF_T bioRxRing;
+static INT8U bioRxStore[RB_STORE_SIZE(BIO_RX_BUF_SIZE, 1U)];
+static INT32U bioRxDropped;
+static INT8C bioLine[BIO_LINE_LEN];
+static INT8U bioLineCnt;            /* characters in bioLine */
+static INT8U bioLineOvf;            /* characters were lost from this line */
+static INT8U bioLineReady;          /* line complete, waiting for BIOLineGet() */
+static void bioRxPut(INT8U data);
+#endif
 /*******************************************************************************************
- * void BIOOpen(INT8U rate) - Initializes UART to operate at a specified rate.
- * MCU: K65, UART2 configured for debugger USB.
- * Acceptable rates:
- *  BIO_BIT_RATE_9600
- *  BIO_BIT_RATE_19200
- *  BIO_BIT_RATE_38400
- *  BIO_BIT_RATE_57600
- *  BIO_BIT_RATE_115200
+ * INT32S BIOOpen(INT32U rate) - Initializes UART to operate at a specified rate.
+ * MCU: K65, UART2 configured for debugger USB, clocked by the bus clock.
+ * The divisor, SBR + BRFA/32, is rounded to the nearest 1/32 so any rate from
+ * BIO_BIT_RATE_MIN to K65TWR_BUS_CLK_HZ/16 can be used, e.g.
+ *  BIO_BIT_RATE_9600 ... BIO_BIT_RATE_115200
+ *  BIO_BIT_RATE_230400, BIO_BIT_RATE_460800, BIO_BIT_RATE_921600
+ * Rates out of range are clamped.
+ * Return value: error of the achieved rate in ppm, see BIOGetRate().
  ******************************************************************************************/
-void BIOOpen(INT8U rate){
+INT32S BIOOpen(INT32U rate){
+    INT32U div32;                       //bus clock/(16*rate) in 1/32 steps
 
     SIM->SCGC5 |= SIM_SCGC5_PORTE(1); /* Enable clock gate for PORTE */
     SIM->SCGC4 |= SIM_SCGC4_UART2(1); //enables UART2 clock (60MHz)
     PORTE->PCR[16]=PORT_PCR_MUX(3);    //ties peripherals to mux address
     PORTE->PCR[17]=PORT_PCR_MUX(3);
 
-    switch(rate){
-    case(BIO_BIT_RATE_9600):
-        UART2->BDH = 0x01U;
-        UART2->BDL = 0x86U;
-        UART2->C4 = 0x14U;
-        break;
-    case(BIO_BIT_RATE_19200):
-        UART2->BDH = 0x00U;
-        UART2->BDL = 0xC3U;
-        UART2->C4 = 0x0AU;
-        break;
-    case(BIO_BIT_RATE_38400):
-        UART2->BDH = 0x00U;
-        UART2->BDL = 0x61U;
-        UART2->C4 = 0x15U;
-        break;
-    case(BIO_BIT_RATE_57600):
-        UART2->BDH = 0x00U;
-        UART2->BDL = 0x41U;
-        UART2->C4 = 0x04U;
-        break;
-    case(BIO_BIT_RATE_115200):
-        UART2->BDH = 0x00U;
-        UART2->BDL = 0x20U;
-        UART2->C4 = 0x12U;
-        break;
-    default:    //Default to 9600bps
-        UART2->BDH = 0x01U;
-        UART2->BDL = 0x86U;
-        UART2->C4 = 0x14U;
-        break;
-    }
+    if(rate < BIO_BIT_RATE_MIN){
+        rate = BIO_BIT_RATE_MIN;
+    }else if(rate > (K65TWR_BUS_CLK_HZ / 16U)){
+        rate = K65TWR_BUS_CLK_HZ / 16U;
+    }else{}
+    div32 = ((2U * K65TWR_BUS_CLK_HZ) + (rate / 2U)) / rate;
+    if(div32 < 32U){
+        div32 = 32U;                    //SBR of 0 disables the clock
+    }else if(div32 > ((8191U << 5) | 31U)){
+        div32 = (8191U << 5) | 31U;
+    }else{}
+    UART2->C2 &= ~(UART_C2_TE_MASK|UART_C2_RE_MASK);  //rate changes need TE, RE off
+    UART2->BDH = UART_BDH_SBR(div32 >> 13);
+    UART2->BDL = UART_BDL_SBR(div32 >> 5);          //BDL write updates SBR
+    UART2->C4 = (UART2->C4 & ~UART_C4_BRFA_MASK) | UART_C4_BRFA(div32 & 31U);
+    bioRate = (2U * K65TWR_BUS_CLK_HZ) / div32;
+    bioRateErr = (INT32S)((((INT64S)bioRate - (INT64S)rate) * 1000000) / (INT64S)rate);
+#if BIO_FIFO_EN
+    /* 1 entry unless the UART has a FIFO, see PFIFO. TX watermark 0 so TDRE means the
+     * FIFO is empty, RX watermark 1 so every character interrupts. */
+    bioTxDepth = (INT8U)((UART2->PFIFO & UART_PFIFO_TXFIFOSIZE_MASK) >> UART_PFIFO_TXFIFOSIZE_SHIFT);
+    bioTxDepth = (bioTxDepth == 0) ? 1U : (INT8U)(1U << (bioTxDepth + 1U));
+    if(bioTxDepth > 1U){
+        UART2->PFIFO |= UART_PFIFO_TXFE_MASK|UART_PFIFO_RXFE_MASK;
+        UART2->CFIFO |= UART_CFIFO_TXFLUSH_MASK|UART_CFIFO_RXFLUSH_MASK;
+        UART2->TWFIFO = 0;
+        UART2->RWFIFO = 1;
+    }else{}
+#endif
     UART2->C2 |= UART_C2_TE_MASK;    //enables transmission
     UART2->C2 |= UART_C2_RE_MASK;    //enables receive
+#if BIO_TX_INT_EN
+    (void)RingBufInit(&bioTxRing, bioTxStore, 1U, BIO_TX_BUF_SIZE);
+    bioTxStats.sent = 0;
+    bioTxStats.dropped = 0;
+    bioTxStats.high_water = 0;
+#endif
+#if BIO_RX_INT_EN
+    (void)RingBufInit(&bioRxRing, bioRxStore, 1U, BIO_RX_BUF_SIZE);
+    bioRxDropped = 0;
+    bioLineCnt = 0;
+    bioLineOvf = 0;
+    bioLineReady = 0;
+    UART2->C2 |= UART_C2_RIE_MASK;
+#endif
+#if BIO_TX_INT_EN || BIO_RX_INT_EN
+    NVIC_EnableIRQ(UART2_RX_TX_IRQn);
+#endif
+#if BIO_TX_DMA_EN
+    SIM->SCGC6 |= SIM_SCGC6_DMAMUX_MASK;
+    SIM->SCGC7 |= SIM_SCGC7_DMA_MASK;
+    bioTxDmaBusy = 0;
+    DMAMUX->CHCFG[BIO_TX_DMA_CH] = 0;
+    DMA0->TCD[BIO_TX_DMA_CH].ATTR = DMA_ATTR_SSIZE(0)|DMA_ATTR_DSIZE(0);
+    DMA0->TCD[BIO_TX_DMA_CH].SOFF = DMA_SOFF_SOFF(1);
+    DMA0->TCD[BIO_TX_DMA_CH].SLAST = DMA_SLAST_SLAST(0);
+    DMA0->TCD[BIO_TX_DMA_CH].DADDR = DMA_DADDR_DADDR(&UART2->D);
+    DMA0->TCD[BIO_TX_DMA_CH].DOFF = DMA_DOFF_DOFF(0);
+    DMA0->TCD[BIO_TX_DMA_CH].DLAST_SGA = DMA_DLAST_SGA_DLASTSGA(0);
+    DMA0->TCD[BIO_TX_DMA_CH].NBYTES_MLNO = DMA_NBYTES_MLNO_NBYTES(1);
+    DMAMUX->CHCFG[BIO_TX_DMA_CH] = DMAMUX_CHCFG_ENBL(1)|
+                                   DMAMUX_CHCFG_SOURCE(BIO_DMA_SRC_UART2_TX);
+    NVIC_EnableIRQ(BIO_TX_DMA_IRQn);
+#endif
+    return bioRateErr;
+}
 
+/*******************************************************************************************
+* BIOGetRate() - Returns the achieved bit rate. *err, if not NULL, is set to its error from
+*                the rate requested in BIOOpen() in ppm.
+*******************************************************************************************/
+INT32U BIOGetRate(INT32S *err){
+    if(err != (INT32S *)0){
+        *err = bioRateErr;
+    }else{}
+    return bioRate;
 }
 
 /*******************************************************************************************
@@ -95,11 +179,20 @@ void BIOOpen(INT8U rate){
 *******************************************************************************************/
 INT8C BIORead(void){
     INT8C c;
+#if BIO_RX_INT_EN
+    INT8U data;
+    if(RingBufGetByte(&bioRxRing, &data) == 0){  //check if char received
+        c = (INT8C)data;
+    }else{
+        c = '\0';                           //If not return 0
+    }
+#else
     if ((UART2->S1 & UART_S1_RDRF_MASK) != 0){   //check if char received
         c = UART2->D;
     }else{
         c = '\0';                           //If not return 0
     }
+#endif
     return (c);
 }
 /*******************************************************************************************
@@ -116,13 +209,290 @@ INT8C BIOGetChar(void){
 
 /*******************************************************************************************
 * BIOWrite() - Sends an ASCII character
-*              Blocks as much as one character time
+*              With BIO_TX_INT_EN the character is queued for the TX interrupt and this
+*              only blocks if the buffer is full and BIO_TX_POLICY is BIO_TX_BLOCK.
+*              Otherwise it blocks as much as one character time.
+*              The ring buffer has a single producer, so each character is queued with
+*              interrupts masked. With SCHED_PREEMPT_EN tasks of every priority, and
+*              ISRs, can print without corrupting it, though their text may interleave.
 *    MCU: K65, UART2
 *    parameter: c is the ASCII character to be sent
 *******************************************************************************************/
 void BIOWrite(INT8C c){
+#if BIO_TX_INT_EN
+    INT32U primask;
+    INT8U full;
+    INT32U count;
+    do{
+        primask = __get_PRIMASK();
+        __disable_irq();
+        full = RingBufPutByte(&bioTxRing, (INT8U)c);
+        if(full == 0){
+            count = RingBufCount(&bioTxRing);
+            if(count > bioTxStats.high_water){
+                bioTxStats.high_water = count;
+            }else{}
+        }else{
+#if BIO_TX_POLICY != BIO_TX_BLOCK
+            bioTxStats.dropped++;
+            full = 0;                   //dropped, do not wait
+#endif
+        }
+        bioTxKick();                    //TX interrupt drains the buffer
+        __set_PRIMASK(primask);         //a full buffer drains here
+    }while(full != 0);
+#else
     while ((UART2->S1 & UART_S1_TDRE_MASK)==0){} //waits until transmission
     UART2->D = (INT8U)c;                             //is ready
+#endif
+}
+
+/*******************************************************************************************
+* BIOTxIdle() - Returns 1 when every queued character has been shifted out, 0 if not.
+*******************************************************************************************/
+INT8U BIOTxIdle(void){
+    INT8U idle;
+#if BIO_TX_DMA_EN
+    if((bioTxDmaBusy == 0) && (RingBufCount(&bioTxRing) == 0) &&
+       ((UART2->S1 & UART_S1_TC_MASK) != 0)){
+#elif BIO_TX_INT_EN
+    if((RingBufCount(&bioTxRing) == 0) && ((UART2->S1 & UART_S1_TC_MASK) != 0)){
+#else
+    if((UART2->S1 & UART_S1_TC_MASK) != 0){
+#endif
+        idle = 1;
+    }else{
+        idle = 0;
+    }
+    return idle;
+}
+
+/*******************************************************************************************
+* BIOWriteBlock() - Starts sending a binary block by eDMA. Text from BIOWrite() waits in
+*                   the ring buffer until the block is done, so the two never mix inside
+*                   a block. The block must not change until BIOTxIdle() or the next
+*                   accepted BIOWriteBlock().
+* Return value: 0 -> block started
+*               1 -> a block or queued text is still being sent, block not started
+* Arguments: *buf is the block, len is its size in bytes, 1 to 32767
+*******************************************************************************************/
+INT8U BIOWriteBlock(const INT8U *buf, INT16U len){
+    INT8U rval = 1;
+#if BIO_TX_DMA_EN
+    if((bioTxDmaBusy == 0) && ((UART2->C2 & UART_C2_TIE_MASK) == 0) &&
+       (RingBufCount(&bioTxRing) == 0) && (len > 0) && (len <= 0x7FFFU)){
+        bioTxDmaBusy = 1;
+        bioTxDmaLen = len;
+        DMA0->TCD[BIO_TX_DMA_CH].SADDR = DMA_SADDR_SADDR(buf);
+        DMA0->TCD[BIO_TX_DMA_CH].CITER_ELINKNO = DMA_CITER_ELINKNO_CITER(len);
+        DMA0->TCD[BIO_TX_DMA_CH].BITER_ELINKNO = DMA_BITER_ELINKNO_BITER(len);
+        DMA0->TCD[BIO_TX_DMA_CH].CSR = DMA_CSR_INTMAJOR(1)|DMA_CSR_DREQ(1);
+        DMA0->SERQ = DMA_SERQ_SERQ(BIO_TX_DMA_CH);
+        UART2->C5 |= UART_C5_TDMAS_MASK;    //TDRE requests DMA instead of an interrupt
+        UART2->C2 |= UART_C2_TIE_MASK;
+        rval = 0;
+    }else{}
+#endif
+    return rval;
+}
+
+/*******************************************************************************************
+* BIOBlockHold() - Reserves the eDMA block channel for a message sent in several blocks,
+*                  such as a trace dump, so no other block lands inside it. Senders of
+*                  single blocks skip theirs while BIOBlockHeld() is 1.
+* BIOBlockHeld() - Returns 1 while the channel is held, 0 if not.
+* Arguments: hold is 1 to hold the channel, 0 to release it
+*******************************************************************************************/
+void BIOBlockHold(INT8U hold){
+    bioBlockHeld = hold;
+}
+
+INT8U BIOBlockHeld(void){
+    return bioBlockHeld;
+}
+
+/*******************************************************************************************
+* BIOTxFlush() - Blocks until every queued character has been shifted out.
+*******************************************************************************************/
+void BIOTxFlush(void){
+    while(BIOTxIdle() == 0){}
+}
+
+/*******************************************************************************************
+* BIOGetTxStats() - Copies the transmit statistics. All zero without BIO_TX_INT_EN.
+*******************************************************************************************/
+void BIOGetTxStats(BIO_TX_STATS_T *stats){
+#if BIO_TX_INT_EN
+    stats->sent = bioTxStats.sent;
+    stats->dropped = bioTxStats.dropped;
+    stats->high_water = bioTxStats.high_water;
+#else
+    stats->sent = 0;
+    stats->dropped = 0;
+    stats->high_water = 0;
+#endif
+}
+
+/*******************************************************************************************
+* UART2_RX_TX_IRQHandler() - UART2 status interrupt. Queues received characters and
+*                            moves queued characters to the transmitter, turning the TX
+*                            interrupt off when the buffer is empty. While an eDMA block
+*                            is sent TIE is the DMA request enable, so the TX part is
+*                            skipped.
+*******************************************************************************************/
+void UART2_RX_TX_IRQHandler(void){
+    INT8U data;
+    TRACE(TRC_UART2, UART2->S1);
+#if BIO_RX_INT_EN
+    if((UART2->S1 & (UART_S1_RDRF_MASK|UART_S1_OR_MASK)) != 0){
+        bioRxPut(UART2->D);             //S1 read then D read clears RDRF and OR
+#if BIO_FIFO_EN
+        while(UART2->RCFIFO != 0){      //rest of the FIFO
+            bioRxPut(UART2->D);
+        }
+#endif
+    }else{}
+#endif
+#if BIO_TX_INT_EN
+    if(((UART2->C5 & UART_C5_TDMAS_MASK) == 0) &&
+       ((UART2->C2 & UART_C2_TIE_MASK) != 0) && ((UART2->S1 & UART_S1_TDRE_MASK) != 0)){
+        if(RingBufGetByte(&bioTxRing, &data) == 0){
+            UART2->D = data;            //S1 read then D write clears TDRE
+            bioTxStats.sent++;
+#if BIO_FIFO_EN
+            while((UART2->TCFIFO < bioTxDepth) && (RingBufGetByte(&bioTxRing, &data) == 0)){
+                UART2->D = data;        //fill the rest of the FIFO
+                bioTxStats.sent++;
+            }
+#endif
+        }else{
+            UART2->C2 &= ~UART_C2_TIE_MASK;
+        }
+    }else{}
+#endif
+}
+
+/*******************************************************************************************
+* bioTxKick() - Turns the TX interrupt on to drain the ring buffer unless an eDMA block is
+*               being sent, in which case the DMA interrupt turns it on when it is done.
+*******************************************************************************************/
+static void bioTxKick(void){
+#if BIO_TX_DMA_EN
+    if(bioTxDmaBusy == 0){
+        UART2->C2 |= UART_C2_TIE_MASK;
+    }else{}
+#else
+    UART2->C2 |= UART_C2_TIE_MASK;
+#endif
+}
+
+#if BIO_RX_INT_EN
+/*******************************************************************************************
+* bioRxPut() - Queues a received character, counting it if the buffer is full.
+*******************************************************************************************/
+static void bioRxPut(INT8U data){
+    if(RingBufPutByte(&bioRxRing, data) != 0){
+        bioRxDropped++;
+    }else{}
+}
+#endif
+
+#if BIO_TX_DMA_EN
+/*******************************************************************************************
+* BIO_TX_DMA_IRQHandler() - eDMA major loop done. Returns TDRE to the TX interrupt and
+*                           restarts the ring buffer if text was queued meanwhile.
+*******************************************************************************************/
+void BIO_TX_DMA_IRQHandler(void){
+    DMA0->CINT = DMA_CINT_CINT(BIO_TX_DMA_CH);
+    TRACE(TRC_UART2_DMA, bioTxDmaLen);
+    UART2->C2 &= ~UART_C2_TIE_MASK;
+    UART2->C5 &= ~UART_C5_TDMAS_MASK;
+    bioTxStats.sent += bioTxDmaLen;
+    bioTxDmaBusy = 0;
+    if(RingBufCount(&bioTxRing) != 0){
+        UART2->C2 |= UART_C2_TIE_MASK;
+    }else{}
+}
+#endif
+
+/*******************************************************************************************
+* BIOLineTask() - Non-blocking version of BIOGetStrg(). Takes the received characters,
+*                 echoes printable ones and handles backspace the same way. A carriage
+*                 return completes the line, which is posted as EVT_LINE and held until
+*                 BIOLineGet(). Characters past BIO_LINE_LEN-1 are dropped and flagged.
+*                 Must not be mixed with BIOGetStrg()/BIOGetChar(), which read the same
+*                 buffer.
+*******************************************************************************************/
+void BIOLineTask(void){
+#if BIO_RX_INT_EN
+    INT8C c;
+    while(bioLineReady == 0){
+        c = BIORead();
+        if(c == '\0'){
+            break;
+        }else if(c == '\r'){
+            BIOOutCRLF();
+            bioLine[bioLineCnt] = '\0';
+            bioLineReady = 1;
+            (void)EvtPost(EVT_LINE, EVT_PRIO_NORM,
+                          (INT32U)bioLineCnt | ((bioLineOvf != 0) ? BIO_LINE_OVF : 0U));
+        }else if((' ' <= c) && ('~' >= c)){
+            if(bioLineCnt < (BIO_LINE_LEN - 1U)){
+                BIOWrite(c);
+                bioLine[bioLineCnt] = c;
+                bioLineCnt++;
+            }else{
+                bioLineOvf = 1;
+            }
+        }else if((c == '\b') && (bioLineCnt > 0)){
+            BIOWrite('\b');
+            BIOWrite(' ');
+            BIOWrite('\b');
+            bioLineCnt--;
+        }else{ /*non-printable character or BS at first character - ignore */
+        }
+    }
+#endif
+}
+
+/*******************************************************************************************
+* BIOLineGet() - Copies the completed line, with its NULL, to strg and starts the next
+*                line.
+* Return value: 0 -> line copied
+*               1 -> no line ready
+*               2 -> line copied but characters were dropped from it
+* Arguments: strglen is the size of strg, at least BIO_LINE_LEN for a full line
+*            *strg is a pointer to the string array
+*******************************************************************************************/
+INT8U BIOLineGet(INT8U strglen, INT8C *const strg){
+    INT8U rval = 1;
+#if BIO_RX_INT_EN
+    INT8U cnt;
+    if((bioLineReady != 0) && (strglen > 0)){
+        cnt = 0;
+        while((cnt < (strglen - 1U)) && (bioLine[cnt] != '\0')){
+            strg[cnt] = bioLine[cnt];
+            cnt++;
+        }
+        strg[cnt] = '\0';
+        rval = ((bioLineOvf != 0) || (bioLine[cnt] != '\0')) ? 2 : 0;
+        bioLineCnt = 0;
+        bioLineOvf = 0;
+        bioLineReady = 0;
+    }else{}
+#endif
+    return rval;
+}
+
+/*******************************************************************************************
+* BIOGetRxDropped() - Returns the number of received characters lost to a full buffer.
+*******************************************************************************************/
+INT32U BIOGetRxDropped(void){
+#if BIO_RX_INT_EN
+    return bioRxDropped;
+#else
+    return 0;
+#endif
 }
 
 /*******************************************************************************************
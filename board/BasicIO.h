@@ -21,6 +21,15 @@
  * v4.2
  *  Created by Todd Morton
  *  Modified to fix bug in BOIGetStrg() so a BS can be the first character pressed.
+ * v4.3
+ *  Khoi Le, 10/19/2026
+ *  Transmit through a ring buffer drained by the UART2 TX interrupt.
+ *  Receive through a ring buffer filled by the UART2 RX interrupt and a
+ *  non-blocking line assembler, BIOLineTask().
+ *  Added BIOWriteBlock() to send binary blocks by eDMA.
+ *  Added BIOBlockHold() so a message of several blocks is not split.
+ *  BIOOpen() computes SBR/BRFA from K65TWR_BUS_CLK_HZ for any rate and can
+ *  enable the UART FIFOs.
 ********************************************************************/
 #ifndef BIO_INCL
 #define BIO_INCL
@@ -28,11 +37,66 @@
 /******************************************************************************************
  * Defined UART bit rates
  ******************************************************************************************/
-#define BIO_BIT_RATE_9600   0
-#define BIO_BIT_RATE_19200  1
-#define BIO_BIT_RATE_38400  2
-#define BIO_BIT_RATE_57600  3
-#define BIO_BIT_RATE_115200 4
+#define BIO_BIT_RATE_9600   9600U
+#define BIO_BIT_RATE_19200  19200U
+#define BIO_BIT_RATE_38400  38400U
+#define BIO_BIT_RATE_57600  57600U
+#define BIO_BIT_RATE_115200 115200U
+#define BIO_BIT_RATE_230400 230400U
+#define BIO_BIT_RATE_460800 460800U
+#define BIO_BIT_RATE_921600 921600U
+/* Slowest rate, SBR at its 13-bit maximum. K65TWR_ClkCfg.h must be included first. */
+#define BIO_BIT_RATE_MIN    ((K65TWR_BUS_CLK_HZ + (16U * 8191U) - 1U) / (16U * 8191U))
+
+/******************************************************************************************
+ * BIO_FIFO_EN - 1 to use the UART TX/RX FIFOs when PFIFO reports more than one entry.
+ *               The interrupts then move up to a FIFO of characters each.
+ ******************************************************************************************/
+#define BIO_FIFO_EN         1
+
+/******************************************************************************************
+ * Transmit configuration
+ * BIO_TX_INT_EN - 1 to queue output for the TX interrupt, 0 to poll the UART
+ * BIO_TX_BUF_SIZE - TX ring buffer size in characters, a power of two
+ * BIO_TX_POLICY - what BIOWrite() does when the buffer is full:
+ *   BIO_TX_DROP - the character is dropped and counted, output never costs slice time
+ *   BIO_TX_BLOCK - waits for room. Must not be used from an ISR.
+ ******************************************************************************************/
+#define BIO_TX_DROP         0
+#define BIO_TX_BLOCK        1
+#define BIO_TX_INT_EN       1
+#define BIO_TX_BUF_SIZE     512U
+#define BIO_TX_POLICY       BIO_TX_DROP
+
+/******************************************************************************************
+ * eDMA block transmit, BIOWriteBlock(). Needs BIO_TX_INT_EN.
+ * BIO_TX_DMA_CH - eDMA channel, clear of the WaveGen channels
+ ******************************************************************************************/
+#define BIO_TX_DMA_EN           1
+#define BIO_TX_DMA_CH           15U
+#define BIO_TX_DMA_IRQn         DMA15_DMA31_IRQn
+#define BIO_TX_DMA_IRQHandler   DMA15_DMA31_IRQHandler
+
+/******************************************************************************************
+ * Receive configuration
+ * BIO_RX_INT_EN - 1 to queue input from the RX interrupt, 0 to poll the UART
+ * BIO_RX_BUF_SIZE - RX ring buffer size in characters, a power of two
+ * BIO_LINE_LEN - BIOLineTask() line size, includes the NULL
+ * BIO_LINE_OVF - set in the EVT_LINE arg when characters were dropped from the line
+ * UART2 is not clocked in LLS and is not an LLWU source, so characters received while
+ * PwrMgr.c has the part in LLS are lost and do not wake it. BIOLineTask() is
+ * SCHED_F_WAKE since there is nothing for it to poll while asleep.
+ ******************************************************************************************/
+#define BIO_RX_INT_EN       1
+#define BIO_RX_BUF_SIZE     128U
+#define BIO_LINE_LEN        64U
+#define BIO_LINE_OVF        0x100U
+
+typedef struct{
+    INT32U sent;            /* characters written to the UART */
+    INT32U dropped;         /* characters lost to a full buffer */
+    INT32U high_water;      /* most characters ever queued */
+}BIO_TX_STATS_T;
 
 /*************************************************************************
 * Enumerated type for mode parameter in BIOOutDecWord()
@@ -50,14 +114,17 @@ typedef enum {
 ********************************************************************/
 /********************************************************************
 * BIOOpen() - Initialization routine for BasicIO()
-* Acceptable rates:
-*  BIO_BIT_RATE_9600
-*  BIO_BIT_RATE_19200
-*  BIO_BIT_RATE_38400
-*  BIO_BIT_RATE_57600
-*  BIO_BIT_RATE_115200
+* rate is the bit rate in bits/s, e.g. BIO_BIT_RATE_115200 or
+* BIO_BIT_RATE_921600. The divisor is computed from K65TWR_BUS_CLK_HZ.
+*    return: error of the achieved rate in ppm
+********************************************************************/
+INT32S BIOOpen(INT32U rate);
+
+/********************************************************************
+* BIOGetRate() - Returns the achieved bit rate and, if err is not
+*                NULL, its error in ppm
 ********************************************************************/
-void BIOOpen(INT8U rate);
+INT32U BIOGetRate(INT32S *err);
 
 /********************************************************************
 * BIORead() - Checks for a character received
@@ -88,13 +155,54 @@ INT8C BIOGetChar(void);  /* Blocks until a character is received */
 ********************************************************************/
 INT8U BIOGetStrg(INT8U strglen,INT8C *const strg); /*input a string */
 
+/********************************************************************
+* BIOLineTask() - Cooperative, non-blocking BIOGetStrg(). Assembles
+*                 the received characters into a line with the same
+*                 echo and backspace handling and posts EVT_LINE with
+*                 the length (| BIO_LINE_OVF) when CR is received.
+* BIOLineGet() - Copies the ready line and starts the next one.
+*                Returns 0 if copied, 1 if no line, 2 if truncated.
+* BIOGetRxDropped() - Received characters lost to a full buffer.
+********************************************************************/
+void BIOLineTask(void);
+INT8U BIOLineGet(INT8U strglen, INT8C *const strg);
+INT32U BIOGetRxDropped(void);
+
 /********************************************************************
 * BIOWrite() - Sends an ASCII character
-*              Blocks as much as one character time
+*              Queued for the TX interrupt with BIO_TX_INT_EN, otherwise
+*              blocks as much as one character time
 *    parameter: c is the ASCII character to be sent
 ********************************************************************/
 void BIOWrite(INT8C c);  /* Send an ascii character */
 
+/********************************************************************
+* BIOTxIdle() - Returns 1 when all output, including a block, has
+*               been shifted out
+* BIOTxFlush() - Blocks until all output has been shifted out
+* BIOGetTxStats() - Copies the transmit statistics
+********************************************************************/
+INT8U BIOTxIdle(void);
+void BIOTxFlush(void);
+void BIOGetTxStats(BIO_TX_STATS_T *stats);
+
+/********************************************************************
+* BIOWriteBlock() - Starts an eDMA transfer of a binary block. Text
+*                   from BIOWrite() waits until the block is done.
+*                   The block must not change while it is sent.
+*    return: 0 if started, 1 if the UART is busy (try again later)
+********************************************************************/
+INT8U BIOWriteBlock(const INT8U *buf, INT16U len);
+
+/********************************************************************
+* BIOBlockHold() - Holds the block channel for a message of several
+*                  blocks, 1 to hold and 0 to release
+* BIOBlockHeld() - Returns 1 while the channel is held. Single block
+*                  senders skip their block while it is held.
+********************************************************************/
+void BIOBlockHold(INT8U hold);
+INT8U BIOBlockHeld(void);
+
 /********************************************************************
 * BIOPutStrg() - Sends a C string
 *    parameter: strg is a pointer to the string
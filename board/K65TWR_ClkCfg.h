@@ -9,6 +9,7 @@
  * (PLL) that is part of the microcontroller device.
  *
  * 09/06/2018 Todd Morton
+ * 10/19/2026 Added K65TWR_BUS_CLK_HZ for computed peripheral timing, Khoi Le
  *
  ***************************************************************************************/
 #ifndef K65TWR_CLKCFG_H_
@@ -61,6 +62,10 @@
 */
 #define CLOCK_SETUP 1
 
+/* Bus clock set by K65TWR_BootClock() (CLOCK_SETUP 1, HSRUN). UART2 and PIT
+ * timing is computed from it, so change it with the clock setup. */
+#define K65TWR_BUS_CLK_HZ              60000000U
+
 /* Define clock source values */
 
 #define CPU_XTAL_CLK_HZ                16000000U           /* Value of the external crystal or oscillator clock frequency of the system oscillator (OSC) in Hz */
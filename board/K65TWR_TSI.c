@@ -2,16 +2,22 @@
  * Todd Morton, 11/18/2014
  * Todd Morton, 11/19/2018 MCUXpresso version
  * Todd Morton, 11/17/2020 MCUX11.2 version
+ * Khoi Le, 10/19/2026 Post touch press/release edges to the event bus
+ * Khoi Le, 10/19/2026 Added TSIWakeArm()/TSIWakeDisarm() for LLS wakeup
+ * Khoi Le, 10/19/2026 Added count/offset accessors for the diagnostic shell
+ * Khoi Le, 10/19/2026 Added TSIWakeNext() to scan several pads in LLS
  */
 #include "MCUType.h"
 #include "K65TWR_GPIO.h"
 #include "K65TWR_TSI.h"
+#include "EventBus.h"
 
 typedef enum {PROC1START2, PROC2START1} TSI_TASK_STATE_T;
 typedef struct{
     INT16U baseline;
     INT16U offset;
     INT16U threshold;
+    INT16U count;           /* last scan result */
 }TOUCH_LEVEL_T;
 
 
@@ -27,6 +33,7 @@ static TOUCH_LEVEL_T tsiSensorLevels[MAX_NUM_ELECTRODES];
 static void tsiStartScan(INT8U channel);
 static void tsiProcScan(INT8U channel);
 static INT16U tsiSensorFlags = 0;
+static INT16U tsiTouchState = 0;    /* last touch state of each channel */
 
 
 /********************************************************************************
@@ -115,17 +122,28 @@ static void tsiStartScan(INT8U channel){
 /********************************************************************************
  *   TSIProcScan: Waits for the scan to complete, then sets the appropriate
  *                flags is a touch was detected.
+ *                A press or release of the channel is posted as EVT_TOUCH.
  *                Note the scan must be started before this is called.
  *                channel - the channel to be processed
  ********************************************************************************/
 static void tsiProcScan(INT8U channel){
+    INT16U chmask = (INT16U)(1<<channel);
+    INT16U touch = 0;
 
     while((TSI0->GENCS & TSI_GENCS_EOSF_MASK) == 0){}
     TSI0->GENCS |= TSI_GENCS_EOSF(1);    //Clear flag
 
     /* Process channel */
-    if((INT16U)(TSI0->DATA & TSI_DATA_TSICNT_MASK) > tsiSensorLevels[channel].threshold){
-        tsiSensorFlags |= (INT16U)(1<<channel);
+    tsiSensorLevels[channel].count = (INT16U)(TSI0->DATA & TSI_DATA_TSICNT_MASK);
+    if(tsiSensorLevels[channel].count > tsiSensorLevels[channel].threshold){
+        tsiSensorFlags |= chmask;
+        touch = chmask;
+    }else{
+    }
+    if((tsiTouchState & chmask) != touch){
+        tsiTouchState ^= chmask;
+        (void)EvtPost(EVT_TOUCH, EVT_PRIO_NORM,
+                      (INT32U)channel | ((touch != 0) ? 0x100U : 0U));
     }else{
     }
 
@@ -141,3 +159,88 @@ INT16U TSIGetSensorFlags(void){
     tsiSensorFlags = 0;
     return sflags;
 }
+
+/********************************************************************************
+ *   TSIGetCount: Returns the result of the last scan of a channel.
+ *   TSIGetBaseline: Returns the calibrated non-touch count of a channel.
+ *   TSIGetOffset: Returns the touch offset from the baseline of a channel.
+ *                 channel - the channel, range 0-15
+ ********************************************************************************/
+INT16U TSIGetCount(INT8U channel){
+    return tsiSensorLevels[channel & 0x0FU].count;
+}
+
+INT16U TSIGetBaseline(INT8U channel){
+    return tsiSensorLevels[channel & 0x0FU].baseline;
+}
+
+INT16U TSIGetOffset(INT8U channel){
+    return tsiSensorLevels[channel & 0x0FU].offset;
+}
+
+/********************************************************************************
+ *   TSISetOffset: Sets the touch offset from the baseline of a channel and
+ *                 updates its threshold. Used to tune a pad in the field.
+ *                 channel - the channel, range 0-15
+ *                 offset - counts over the baseline that are a touch
+ ********************************************************************************/
+void TSISetOffset(INT8U channel, INT16U offset){
+    channel &= 0x0FU;
+    tsiSensorLevels[channel].offset = offset;
+    tsiSensorLevels[channel].threshold = tsiSensorLevels[channel].baseline + offset;
+}
+
+/********************************************************************************
+ *   TSIWakeArm: Sets up one channel to run in low power modes. Scans are
+ *               hardware triggered by the LPTMR and a count over the channel
+ *               threshold sets the out-of-range flag, which the LLWU uses as
+ *               a wakeup source. TSITask() must not be called until
+ *               TSIWakeDisarm().
+ *               channel - the channel to watch, must be calibrated
+ ********************************************************************************/
+void TSIWakeArm(INT8U channel){
+    while((TSI0->GENCS & TSI_GENCS_SCNIP_MASK) != 0){} //let the last scan finish
+    TSI0_DISABLE();
+    TSI0->TSHD = TSI_TSHD_THRESH(tsiSensorLevels[channel].threshold)|
+                 TSI_TSHD_THRESL(0);
+    TSI0->DATA = TSI_DATA_TSICH(channel);
+    TSI0->GENCS = (TSI0->GENCS & ~TSI_GENCS_ESOR_MASK)|
+                  TSI_GENCS_STPE_MASK|TSI_GENCS_TSIIEN_MASK|TSI_GENCS_STM_MASK|
+                  TSI_GENCS_OUTRGF_MASK|TSI_GENCS_EOSF_MASK; //flags are w1c
+    TSI0_ENABLE();
+}
+
+/********************************************************************************
+ *   TSIWakeNext: Moves the low power scan to another channel between two LPTMR
+ *                triggers. Waits for the scan in progress first. If that scan
+ *                was out of range its flag is left set and 1 is returned, so
+ *                the caller treats it as a wakeup, else the channel is changed
+ *                and 0 is returned.
+ *                channel - the channel to watch next, must be calibrated
+ ********************************************************************************/
+INT8U TSIWakeNext(INT8U channel){
+    INT8U rval = 0;
+    while((TSI0->GENCS & TSI_GENCS_SCNIP_MASK) != 0){}
+    if((TSI0->GENCS & TSI_GENCS_OUTRGF_MASK) != 0){
+        rval = 1;
+    }else{
+        TSI0_DISABLE();
+        TSI0->TSHD = TSI_TSHD_THRESH(tsiSensorLevels[channel].threshold)|
+                     TSI_TSHD_THRESL(0);
+        TSI0->DATA = TSI_DATA_TSICH(channel);
+        TSI0->GENCS |= TSI_GENCS_EOSF_MASK; //flags are w1c
+        TSI0_ENABLE();
+    }
+    return rval;
+}
+
+/********************************************************************************
+ *   TSIWakeDisarm: Returns TSI0 to software triggered scans for TSITask().
+ ********************************************************************************/
+void TSIWakeDisarm(void){
+    TSI0_DISABLE();
+    TSI0->GENCS = (TSI0->GENCS & ~(TSI_GENCS_STPE_MASK|TSI_GENCS_TSIIEN_MASK|
+                                   TSI_GENCS_STM_MASK))|
+                  TSI_GENCS_OUTRGF_MASK|TSI_GENCS_EOSF_MASK;
+    TSI0_ENABLE();
+}
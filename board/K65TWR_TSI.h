@@ -8,5 +8,12 @@ void TSIInit(void);
 void TSIChCalibration(INT8U channel);
 INT16U TSIGetSensorFlags(void);
 void TSITask(void);
+void TSIWakeArm(INT8U channel);
+INT8U TSIWakeNext(INT8U channel);
+void TSIWakeDisarm(void);
+INT16U TSIGetCount(INT8U channel);
+INT16U TSIGetBaseline(INT8U channel);
+INT16U TSIGetOffset(INT8U channel);
+void TSISetOffset(INT8U channel, INT16U offset);
 
 #endif
@@ -11,12 +11,15 @@
 *            from B60 to A64 on the tower. Also, PORTA bit 6 must remain an unsued input.
 * 12/08/2015 Changed type for control codes.
 * 10/29/2018 Modified for MCUXpresso, Todd Morton
+* 10/19/2026 Verified keys are also posted to the event bus as EVT_KEY, Khoi Le
+* 10/19/2026 Added KeyWakeArm()/KeyWakeDisarm() for LLWU wakeup, Khoi Le
 *****************************************************************************************
 * Project master header file
 ****************************************************************************************/
 #include "MCUType.h"
 #include "Key.h"
 #include "K65TWR_GPIO.h"
+#include "EventBus.h"
 /****************************************************************************************
 * Private Resources
 ****************************************************************************************/
@@ -97,6 +100,7 @@ void KeyTask(void) {
         if(cur_key == last_key){        /* Keypress verified */
             keyState = KEY_VERF;
             keyBuffer = keyCodeTable[cur_key - 1]; /*update buffer */
+            (void)EvtPost(EVT_KEY, EVT_PRIO_NORM, (INT32U)keyBuffer);
         }else if(cur_key == 0){        /* Unvalidated, start over */
             keyState = KEY_OFF;
         }else{                          /*Unvalidated, diff key edge*/
@@ -165,3 +169,22 @@ static void keyDly(void){
     for(i=0;i<14;i++){
     }
 }
+
+/****************************************************************************************
+* KeyWakeArm() - Drives all rows low so any key pulls its column low. The columns are
+*                LLWU_P7-P10, so the power manager can wake on a falling edge of any of
+*                them. KeyTask() must not be called until KeyWakeDisarm().
+* (Public)
+****************************************************************************************/
+void KeyWakeArm(void){
+    KEY_PORT_OUT &= ~ROWS_MASK;
+    KEY_PORT_DIR |= ROWS_MASK;
+}
+
+/****************************************************************************************
+* KeyWakeDisarm() - Returns the rows to inputs for normal scanning.
+* (Public)
+****************************************************************************************/
+void KeyWakeDisarm(void){
+    KEY_PORT_DIR &= ~ROWS_MASK;
+}
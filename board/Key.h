@@ -7,6 +7,7 @@
 *            from B60 to A64 on the tower. Also, PORTA bit 6 must remain an unsued input.
 * 12/08/2015 Changed type for control codes.
 * 10/29/2018 Modified for MCUXpresso, Todd Morton
+* 10/19/2026 Added KeyWakeArm()/KeyWakeDisarm() for LLWU wakeup, Khoi Le
 ******************************************************************************************
 * Public Resources
 *****************************************************************************************/
@@ -42,4 +43,11 @@ void KeyInit(void);
 *****************************************************************************************/
 void KeyTask(void);
 
+/*****************************************************************************************
+* KeyWakeArm() - Drives all rows low so a key press is a falling edge on a column for
+*                the LLWU. KeyWakeDisarm() - Restores the rows for KeyTask().
+*****************************************************************************************/
+void KeyWakeArm(void);
+void KeyWakeDisarm(void);
+
 #endif
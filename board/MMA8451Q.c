@@ -2,6 +2,8 @@
  * DESCRIPTION: A driver module for the MMA8451Q Accelerometer on the I2C.
  *              As connected on the K65 Tower Board
  * 11/18/2021 Todd Morton Removed basic I2C functions
+ * 10/19/2026 Khoi Le Added MMA8451MotionInit() for the LLWU wakeup pin
+ * 10/19/2026 Khoi Le Added MMA8451SetIntPol() to check the INT1 wiring
 ****************************************************************************************/
 #include "MCUType.h"
 #include "K65TWR_I2C.h"
@@ -63,3 +65,41 @@ void MMA8451PLInit(void){
     treg = treg | 0x01u;            /* Set active bit to put in active mode         */
     MMA8451RegWr(MMA8451_CTRL_REG1,treg);
 }
+/****************************************************************************************
+* MMA8451MotionInit - Initialize 8451 motion detection on INT1. X and Y only, so
+*                     gravity on a level board does not trigger it. The event is
+*                     latched until MMA8451_FF_MT_SRC is read. INT1 is active low.
+* Parameters:
+*   ths is the motion threshold in 0.063g counts
+****************************************************************************************/
+void MMA8451MotionInit(INT8U ths){
+    INT8U treg;
+    treg = MMA8451RegRd(MMA8451_CTRL_REG1);
+    treg = treg & 0xfeu;            /* Clear active bit to put in standby mode         */
+    MMA8451RegWr(MMA8451_CTRL_REG1,treg);
+    MMA8451RegWr(MMA8451_FF_MT_CFG,0xd8u);  /* ELE, OAE motion, X and Y events     */
+    MMA8451RegWr(MMA8451_FF_MT_THS,ths & 0x7fu);
+    MMA8451RegWr(MMA8451_FF_MT_COUNT,0x02u); /* debounce count                     */
+    MMA8451RegWr(MMA8451_CTRL_REG4,MMA8451RegRd(MMA8451_CTRL_REG4) | 0x04u);
+    MMA8451RegWr(MMA8451_CTRL_REG5,MMA8451RegRd(MMA8451_CTRL_REG5) | 0x04u);
+    treg = treg | 0x01u;            /* Set active bit to put in active mode         */
+    MMA8451RegWr(MMA8451_CTRL_REG1,treg);
+}
+/****************************************************************************************
+* MMA8451SetIntPol - Sets the polarity of INT1 and INT2. With no interrupt source
+*                    active the pins sit at the inactive level, so flipping the
+*                    polarity and reading the MCU pin shows where INT1 is wired.
+* Parameters:
+*   high is 1 for active high, 0 for active low, the reset value
+****************************************************************************************/
+void MMA8451SetIntPol(INT8U high){
+    INT8U treg;
+    treg = MMA8451RegRd(MMA8451_CTRL_REG1);
+    MMA8451RegWr(MMA8451_CTRL_REG1,treg & 0xfeu);  /* standby to write CTRL_REG3 */
+    if(high == 1){
+        MMA8451RegWr(MMA8451_CTRL_REG3,MMA8451RegRd(MMA8451_CTRL_REG3) | 0x02u);
+    }else{
+        MMA8451RegWr(MMA8451_CTRL_REG3,MMA8451RegRd(MMA8451_CTRL_REG3) & 0xfdu);
+    }
+    MMA8451RegWr(MMA8451_CTRL_REG1,treg);
+}
@@ -4,6 +4,8 @@
  * AUTHOR: Todd Morton
  * HISTORY: Started 11/23/14
  * Revision: Revised for the K65 board. TDm
+ * 10/19/2026 Khoi Le Added MMA8451MotionInit()
+ * 10/19/2026 Khoi Le Added MMA8451SetIntPol()
  ***********************************************************************/
 #ifndef ACCEL_DEF
 #define ACCEL_DEF
@@ -36,6 +38,20 @@ INT8U MMA8451RegRd(INT8U raddr);
 ****************************************************************************************/
 void MMA8451PLInit(void);
 
+/****************************************************************************************
+* MMA8451MotionInit - Initialize 8451 X/Y motion detection, latched on INT1.
+* Parameters:
+*   ths is the motion threshold in 0.063g counts
+****************************************************************************************/
+void MMA8451MotionInit(INT8U ths);
+
+/****************************************************************************************
+* MMA8451SetIntPol - Sets the polarity of INT1 and INT2, used to check the wiring.
+* Parameters:
+*   high is 1 for active high, 0 for active low, the reset value
+****************************************************************************************/
+void MMA8451SetIntPol(INT8U high);
+
 /*************************************************************************
 * MMA8451 Accelerometer Defines - Read/Write addresses.
 *************************************************************************/
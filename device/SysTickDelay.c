@@ -9,12 +9,25 @@
 * 10/23/2018 Todd Morton
 * v4.1 Modified for MCUX11.2
 * 10/21/2020 Todd Morton
+* v4.2 Wait with WFI instead of spinning and measure the idle time of each slice
+* 10/19/2026 Khoi Le
+* v4.3 Add SysTickResync() for time spent in low leakage stop
+* 10/19/2026 Khoi Le
+* v4.4 Add SysTickSetHook() for the preemptive kernel tick
+* 10/19/2026 Khoi Le
+* v4.5 Trace record in SysTick_Handler()
+* 10/19/2026 Khoi Le
+* v4.6 Run SysTick_Handler() from SRAM_L and measure its latency and run time
+* 10/19/2026 Khoi Le
+* v4.7 stIdleWait() restores the caller's PRIMASK
+* 10/19/2026 Khoi Le
 ******************************************************************************************
 * Project master header file
 *****************************************************************************************/
 #include "MCUType.h"
 #include "SysTickDelay.h"
 #include "K65TWR_GPIO.h"
+#include "Trace.h"
 /*****************************************************************************************
 * Handler must not be static so linker can see it.
 *****************************************************************************************/
@@ -27,11 +40,26 @@ static volatile INT32U stmsCount;   /* 1ms counter variable */
 static INT32U stSliceCount;         /* 1ms counter variable */
 static INT8U stInitFlag;            /* Initialization flag for first time through */
 static INT32U stLastEvent;          /* Last timeslice count for SysTickWaitEvent() */
+static INT32U stIdleUs;             /* Idle time of the last slice in us */
+static INT32U stIdleSumUs;          /* Idle time of the current window in us */
+static INT32U stWindowSumUs;        /* Length of the current window in us */
+static INT32U stWindowCnt;          /* Slices in the current window */
+static INT8U stIdlePct;             /* Idle percentage of the last full window */
+static void (*stHook)(void);        /* Called every 1ms from the SysTick ISR */
+static INT32U stIsrLatMax;          /* Longest SysTick wrap to handler entry, cycles */
+static INT32U stIsrCycMax;          /* Longest SysTick_Handler() run, cycles */
+
+static INT32U stGetUs(void);
+static void stIdleWait(INT32U start, INT32U ms);
 
 /*****************************************************************************************
 * Module Defines
 *****************************************************************************************/
 #define CLK_PER_MS 180000U          /* Clock cycles per 1ms, (must be < 16777216)        */
+#define CLK_PER_US 180U             /* Clock cycles per 1us                              */
+#define ST_WFI_EN 1                 /* 1 to sleep with WFI while waiting, 0 to spin      */
+#define ST_IDLE_WINDOW 100U         /* Slices averaged for SysTickGetIdlePct()           */
+#define ST_BENCH_EN 1               /* 1 to measure SysTick_Handler(), see SysTickGetIsrMax() */
 
 /*****************************************************************************************
 * SysTickDelay Function
@@ -40,9 +68,7 @@ static INT32U stLastEvent;          /* Last timeslice count for SysTickWaitEvent
 *    - Accuracy +0/-1 ms
 *****************************************************************************************/
 void SysTickDelay(const INT32U ms){
-    INT32U start_cnt;
-    start_cnt = stmsCount;
-    while((stmsCount - start_cnt) < ms){} /* wait for ms to pass*/
+    stIdleWait(stmsCount, ms);      /* wait for ms to pass*/
 }
 
 /*****************************************************************************************
@@ -52,9 +78,21 @@ void SysTickDelay(const INT32U ms){
 *    - Accuracy +0/-1 ms
 *****************************************************************************************/
 void SysTickWaitEvent(const INT32U period){
+    INT32U idle_start;
     DB0_TURN_ON();
     if(stInitFlag == 1){    /* not the first time through so run normally */
-        while((stmsCount - stLastEvent) < period){} /* wait period ms since last event count */
+        idle_start = stGetUs();
+        stIdleWait(stLastEvent, period); /* wait period ms since last event count */
+        stIdleUs = stGetUs() - idle_start;
+        stIdleSumUs += stIdleUs;
+        stWindowSumUs += (stmsCount - stLastEvent) * 1000U;
+        stWindowCnt++;
+        if(stWindowCnt >= ST_IDLE_WINDOW){
+            stIdlePct = (INT8U)(stIdleSumUs / (stWindowSumUs / 100U));
+            stIdleSumUs = 0;
+            stWindowSumUs = 0;
+            stWindowCnt = 0;
+        }else{}
     }else{
         stInitFlag = 1;     /* first time through set init flag and set last event count */
     }
@@ -63,6 +101,47 @@ void SysTickWaitEvent(const INT32U period){
     DB0_TURN_OFF();
 }
 
+/*****************************************************************************************
+* stIdleWait() - Private
+*    - Waits until 'ms' milliseconds have passed since the ms count 'start'.
+*    - With ST_WFI_EN the core sleeps until the next interrupt. Interrupts are masked
+*      between the test and WFI so a SysTick that comes in between still wakes it, then
+*      unmasked so the pending ISR runs before the next test. The caller's PRIMASK is
+*      restored on the way out.
+*****************************************************************************************/
+static void stIdleWait(INT32U start, INT32U ms){
+#if ST_WFI_EN
+    INT32U primask = __get_PRIMASK();
+    __disable_irq();
+    while((stmsCount - start) < ms){
+        __WFI();
+        __enable_irq();
+        __disable_irq();
+    }
+    __set_PRIMASK(primask);
+#else
+    while((stmsCount - start) < ms){}
+#endif
+}
+
+/*****************************************************************************************
+* stGetUs() - Private
+*    - Returns the time since SysTickDlyInit() in us from the ms count and the SysTick
+*      current value. Wraps every 71 minutes, only differences are used.
+*****************************************************************************************/
+static INT32U stGetUs(void){
+    INT32U ms;
+    INT32U val;
+    __disable_irq();
+    ms = stmsCount;
+    val = SysTick->VAL;
+    if(((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0) && (val > (CLK_PER_MS/2U))){
+        ms++;               /* reload happened but the ISR has not run yet */
+    }else{}
+    __enable_irq();
+    return (ms * 1000U) + ((CLK_PER_MS - 1U - val) / CLK_PER_US);
+}
+
 /*****************************************************************************************
 * SysTickDlyInit() - Initialization routine for SysTickDelay()
 *****************************************************************************************/
@@ -71,6 +150,13 @@ void SysTickDlyInit(void){
     stmsCount = 0;
     stSliceCount = 0;
     stLastEvent = 0;
+    stIdleUs = 0;
+    stIdleSumUs = 0;
+    stWindowSumUs = 0;
+    stWindowCnt = 0;
+    stIdlePct = 0;
+    stHook = 0;
+    SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;  /* WFI enters Wait so peripherals keep running */
     (void)SysTick_Config(CLK_PER_MS);
 }
 /*****************************************************************************************
@@ -89,10 +175,74 @@ INT32U SysTickGetSliceCount(void){
     return stSliceCount;
 }
 /*****************************************************************************************
+* SysTickGetIdleUs() - Get the idle time of the last slice in us.
+*****************************************************************************************/
+INT32U SysTickGetIdleUs(void){
+    return stIdleUs;
+}
+
+/*****************************************************************************************
+* SysTickGetIdlePct() - Get the idle percentage averaged over the last ST_IDLE_WINDOW
+*                       slices.
+*****************************************************************************************/
+INT8U SysTickGetIdlePct(void){
+    return stIdlePct;
+}
+/*****************************************************************************************
+* SysTickResync() - Adds 'ms' milliseconds spent with the SysTick stopped (LLS) to the ms
+*                   count. The time is counted as idle. The next SysTickWaitEvent()
+*                   returns at once since its period has passed.
+*****************************************************************************************/
+void SysTickResync(const INT32U ms){
+    __disable_irq();
+    stmsCount += ms;
+    __enable_irq();
+    stIdleSumUs += ms * 1000U;
+    stWindowSumUs += ms * 1000U;
+}
+/*****************************************************************************************
+* SysTickSetHook() - Sets a function called from the SysTick ISR after every ms count,
+*                    0 for none.
+*****************************************************************************************/
+void SysTickSetHook(void (*hook)(void)){
+    stHook = hook;
+}
+/*****************************************************************************************
+* SysTickGetIsrMax() - Gets the longest SysTick_Handler() entry latency and run time in
+*                      cycles since the last call, and starts over. 0 if ST_BENCH_EN is 0.
+*****************************************************************************************/
+void SysTickGetIsrMax(INT32U *lat, INT32U *cyc){
+    __disable_irq();
+    *lat = stIsrLatMax;
+    *cyc = stIsrCycMax;
+    stIsrLatMax = 0;
+    stIsrCycMax = 0;
+    __enable_irq();
+}
+/*****************************************************************************************
 * SysTick_Handler() - System Tick Interrupt Handler.
 *    - setup for a 1ms periodic interrupt.
+*    - runs from SRAM_L. The counter reloads at the wrap that raises the interrupt, so
+*      LOAD - VAL at entry is the entry latency.
 *****************************************************************************************/
-void SysTick_Handler(void){
+RAMFUNC void SysTick_Handler(void){
+#if ST_BENCH_EN
+    INT32U lat = SysTick->LOAD - SysTick->VAL;
+    INT32U start = DWT->CYCCNT;
+#endif
     stmsCount++;                    /* Increment 1ms counter    */
+    TRACE(TRC_SYSTICK, stmsCount);
+    if(stHook != 0){
+        stHook();
+    }else{}
+#if ST_BENCH_EN
+    start = DWT->CYCCNT - start;
+    if(lat > stIsrLatMax){
+        stIsrLatMax = lat;
+    }else{}
+    if(start > stIsrCycMax){
+        stIsrCycMax = start;
+    }else{}
+#endif
 }
 /****************************************************************************************/
@@ -10,6 +10,10 @@
 * v3.1 Modify for MCUXpresso and add SysTickmsCount()
 * 10/23/2018 Todd Morton
 * 10/24/2022 Update for MCUX 11.6.0
+* 10/19/2026 Add WFI idle and idle time reporting, Khoi Le
+* 10/19/2026 Add SysTickResync(), Khoi Le
+* 10/19/2026 Add SysTickSetHook(), Khoi Le
+* 10/19/2026 Add SysTickGetIsrMax(), Khoi Le
 *****************************************************************************************
 * Public Function Prototypes
 ****************************************************************************************/
@@ -48,4 +52,33 @@ INT32U SysTickGetmsCount(void);
 *****************************************************************************************/
 INT32U SysTickGetSliceCount(void);
 
+/*****************************************************************************************
+* SysTickGetIdleUs() - Get the time SysTickWaitEvent() slept in the last slice in us.
+*****************************************************************************************/
+INT32U SysTickGetIdleUs(void);
+
+/*****************************************************************************************
+* SysTickGetIdlePct() - Get the idle percentage of the slices, averaged over a window of
+*                       slices so it is stable enough to display.
+*****************************************************************************************/
+INT8U SysTickGetIdlePct(void);
+
+/*****************************************************************************************
+* SysTickResync() - Advances the ms count by time spent in a stop mode, where the SysTick
+*                   does not run. Called by the power manager after every wakeup.
+*****************************************************************************************/
+void SysTickResync(const INT32U ms);
+
+/*****************************************************************************************
+* SysTickSetHook() - Sets a function to call from the SysTick ISR every 1ms, such as a
+*                    kernel tick. Pass 0 to remove it.
+*****************************************************************************************/
+void SysTickSetHook(void (*hook)(void));
+
+/*****************************************************************************************
+* SysTickGetIsrMax() - Gets the longest SysTick ISR entry latency and run time in CPU
+*                      cycles since the last call, then clears them.
+*****************************************************************************************/
+void SysTickGetIsrMax(INT32U *lat, INT32U *cyc);
+
 #endif
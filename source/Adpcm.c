@@ -0,0 +1,94 @@
+/*******************************************************************************
+* Adpcm.c
+*
+* This module contains an IMA-ADPCM decoder for the sound clips. Four bits per
+* sample are expanded back to 16 bits with the standard step and index
+* tables, the same as tools/adpcm_encode.py, so the output is bit exact with
+* the host decoder. The decoder and its tables are in SRAM_L, as the DMA
+* interrupt runs it for every clip block, see RAMFUNC.
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+/*******************************************************************************
+* Includes
+*******************************************************************************/
+#include "MCUType.h"
+#include "Adpcm.h"
+
+/*******************************************************************************
+* Private Resources
+*******************************************************************************/
+#define ADPCM_INDEX_MAX     88
+
+static const INT16U adpcmSteps[ADPCM_INDEX_MAX + 1] RAMDATA = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41,
+    45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209,
+    230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876,
+    963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749,
+    3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630,
+    9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385,
+    24623, 27086, 29794, 32767};
+
+static const INT8S adpcmIndexAdj[8] RAMDATA = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+/******************************************************************************
+* Function Code
+******************************************************************************/
+
+/*******************************************************************************
+* AdpcmDecode(ADPCM_STATE_T *state, const INT8U *src, INT32U first,
+*             INT16U num, INT16S *dst) - PUBLIC
+*   parameter: state - decoder state, carried from call to call
+*              src - nibble stream, low nibble first
+*              first - number of the first nibble to decode
+*              num - samples to decode
+*              dst - decoded 16 bit samples
+*   description: standard IMA-ADPCM decoder, about 25 cycles per sample.
+*   Runs from SRAM_L.
+*******************************************************************************/
+RAMFUNC void AdpcmDecode(ADPCM_STATE_T *state, const INT8U *src, INT32U first, INT16U num,
+                 INT16S *dst){
+    INT32S pred = state->pred;
+    INT32S index = state->index;
+    INT32S step;
+    INT32S diff;
+    INT8U code;
+    INT16U idx;
+    for(idx = 0; idx < num; idx++){
+        code = src[first >> 1];
+        code = ((first & 1U) != 0) ? (INT8U)(code >> 4) : (INT8U)(code & 0x0FU);
+        first++;
+        step = adpcmSteps[index];
+        diff = step >> 3;
+        if((code & 4U) != 0){
+            diff += step;
+        } else{}
+        if((code & 2U) != 0){
+            diff += step >> 1;
+        } else{}
+        if((code & 1U) != 0){
+            diff += step >> 2;
+        } else{}
+        if((code & 8U) != 0){
+            pred -= diff;
+            if(pred < -32768){
+                pred = -32768;
+            } else{}
+        } else{
+            pred += diff;
+            if(pred > 32767){
+                pred = 32767;
+            } else{}
+        }
+        index += adpcmIndexAdj[code & 7U];
+        if(index < 0){
+            index = 0;
+        } else if(index > ADPCM_INDEX_MAX){
+            index = ADPCM_INDEX_MAX;
+        } else{}
+        dst[idx] = (INT16S)pred;
+    }
+    state->pred = (INT16S)pred;
+    state->index = (INT8U)index;
+}
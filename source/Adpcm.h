@@ -0,0 +1,35 @@
+/*******************************************************************************
+* Adpcm.h
+*
+* This module contains all function prototypes and the decoder state for
+* Adpcm.c
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+#ifndef ADPCMH
+#define ADPCMH
+
+/*******************************************************************************
+* Definition of ADPCM macros/constants
+*******************************************************************************/
+typedef struct{
+    INT16S pred;            /* last decoded sample */
+    INT8U index;            /* step table index, 0-88 */
+}ADPCM_STATE_T;
+
+/*******************************************************************************
+* AdpcmDecode(ADPCM_STATE_T *state, const INT8U *src, INT32U first,
+*             INT16U num, INT16S *dst) - PUBLIC
+*   parameter: state - decoder state, carried from call to call
+*              src - nibble stream, low nibble first
+*              first - number of the first nibble to decode
+*              num - samples to decode
+*              dst - decoded 16 bit samples
+*   description: standard IMA-ADPCM decoder. Runs from SRAM_L, it is called
+*   from the DMA interrupt.
+*******************************************************************************/
+void AdpcmDecode(ADPCM_STATE_T *state, const INT8U *src, INT32U first, INT16U num,
+                 INT16S *dst);
+
+#endif
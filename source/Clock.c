@@ -17,13 +17,24 @@
 #include "SysTickDelay.h"
 #include "LCD.h"
 #include "Key.h"
-#include "WaveGen.h"
+#include "WaveBank.h"
 #include "WaveGenDMA.h"
 #include "Clock.h"
+#include "EventBus.h"
+#include "Trace.h"
 
 /*******************************************************************************
 * Private Resources
 *******************************************************************************/
+static void clockSecHandler(const EVT_T *evt);
+static INT32U clockSeconds;
+static INT8U clockUpdate;
+
+/*******************************************************************************
+* RTC_Seconds_IRQHandler() - RTC seconds interrupt service routine, function
+* prototype
+*******************************************************************************/
+void RTC_Seconds_IRQHandler(void);
 
 /******************************************************************************
 * Function Code
@@ -33,7 +44,7 @@
 * ClockInit() - PUBLIC
 *   parameter: none
 *   description: Initialization anything needed to generate the Clock. This
-*   function must be call before the any Clock function
+*   function must be call before the any Clock function and after EvtInit()
 *******************************************************************************/
 void ClockInit(void){
     SIM->SCGC6 |= SIM_SCGC6_RTC(1);
@@ -43,31 +54,56 @@ void ClockInit(void){
     RTC->SR |= RTC_SR_TCE(0);
     RTC->TSR |= 0;
     RTC->SR |= RTC_SR_TCE(1);
+    clockSeconds = 0;
+    clockUpdate = 1;
+    (void)EvtSubscribe(EVT_MASK(EVT_RTC_SEC), clockSecHandler);
+    RTC->IER |= RTC_IER_TSIE(1);    //Seconds interrupt
+    NVIC_EnableIRQ(RTC_Seconds_IRQn);
+}
 
+/*******************************************************************************
+* RTC_Seconds_IRQHandler() - RTC seconds interrupt service routine
+*   parameter: none
+*   description: posts the new seconds count as EVT_RTC_SEC
+*******************************************************************************/
+void RTC_Seconds_IRQHandler(void){
+    TRACE(TRC_RTC_SEC, RTC->TSR);
+    (void)EvtPost(EVT_RTC_SEC, EVT_PRIO_LOW, (INT32U)RTC->TSR);
+}
+
+/*******************************************************************************
+* clockSecHandler() - PRIVATE
+*   parameter: evt - EVT_RTC_SEC event
+*   description: saves the seconds count so ClockTask() redraws the time
+*******************************************************************************/
+static void clockSecHandler(const EVT_T *evt){
+    clockSeconds = evt->arg;
+    clockUpdate = 1;
 }
 /*******************************************************************************
 * ClockTask() - PUBLIC
 *   parameter: none
 *   description: diplay the time on the LCD with ISO 8601 extended time display
-*   format
+*   format. The LCD is only written when EVT_RTC_SEC was received.
 *******************************************************************************/
 void ClockTask(void){
-    INT32U clock_count;
     INT8U hour;
     INT8U minute;
     INT32U second;
-    clock_count = (INT32U)RTC->TSR;
-    second = clock_count;
-    hour = second / 3600;
-    if(hour >= 24){
-        hour = hour - 24;
-    }
-    minute = (second % 3600) / 60;
-    second = second % 60;
-    LcdCursorMove(1, 9);
-    LcdDispDecWord(hour, 2, LCD_DEC_MODE_LZ);
-    LcdDispChar(':');
-    LcdDispDecWord(minute, 2, LCD_DEC_MODE_LZ);
-    LcdDispChar(':');
-    LcdDispDecWord(second, 2, LCD_DEC_MODE_LZ);
+    if(clockUpdate == 1){
+        clockUpdate = 0;
+        second = clockSeconds;
+        hour = second / 3600;
+        if(hour >= 24){
+            hour = hour - 24;
+        }
+        minute = (second % 3600) / 60;
+        second = second % 60;
+        LcdCursorMove(1, 9);
+        LcdDispDecWord(hour, 2, LCD_DEC_MODE_LZ);
+        LcdDispChar(':');
+        LcdDispDecWord(minute, 2, LCD_DEC_MODE_LZ);
+        LcdDispChar(':');
+        LcdDispDecWord(second, 2, LCD_DEC_MODE_LZ);
+    } else{}
 }
@@ -13,7 +13,7 @@
 * ClockInit() - PUBLIC
 *   parameter: none
 *   description: Initialization anything needed to generate the Clock. This
-*   function must be call before the any Clock function
+*   function must be call before the any Clock function and after EvtInit()
 *******************************************************************************/
 void ClockInit(void);
 
@@ -21,7 +21,7 @@ void ClockInit(void);
 * ClockTask() - PUBLIC
 *   parameter: none
 *   description: diplay the time on the LCD with ISO 8601 extended time display
-*   format
+*   format. The LCD is only written when EVT_RTC_SEC was received.
 *******************************************************************************/
 void ClockTask(void);
 
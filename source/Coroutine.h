@@ -0,0 +1,72 @@
+/*******************************************************************************
+* Coroutine.h
+*
+* Stackless coroutines (protothreads) for cooperative tasks. A task is written
+* as straight line code and CO_YIELD()/CO_WAIT_UNTIL()/CO_SLEEP_MS() return
+* from it; the next call resumes at the same place. The resume point is the
+* source line saved in a CO_T and a switch jumps back to it (Duff's device).
+*
+* Rules:
+*   - Local variables are not kept across a yield, use statics.
+*   - A coroutine body can not contain its own switch statement.
+*   - Only one CO_ macro per source line.
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+#ifndef COROUTINEH
+#define COROUTINEH
+
+typedef struct{
+    INT16U line;        /* resume point, 0 to start from CO_BEGIN() */
+    INT32U stamp;       /* ms count for CO_SLEEP_MS() */
+}CO_T;
+
+/*******************************************************************************
+* CO_INIT(co) - sets the coroutine to start from the top on the next call
+*******************************************************************************/
+#define CO_INIT(co)     ((co)->line = 0U)
+
+/*******************************************************************************
+* CO_BEGIN(co)/CO_END(co) - bracket the body of the task function. After
+* CO_END() the next call starts again from CO_BEGIN().
+*******************************************************************************/
+#define CO_BEGIN(co)    switch((co)->line){ case 0U:
+#define CO_END(co)      } (co)->line = 0U
+
+/*******************************************************************************
+* CO_YIELD(co) - returns, the next call continues after the yield
+*******************************************************************************/
+#define CO_YIELD(co)                                                        \
+    do{                                                                     \
+        (co)->line = (INT16U)__LINE__; return; case __LINE__:;              \
+    }while(0)
+
+/*******************************************************************************
+* CO_WAIT_UNTIL(co, cond) - returns on every call until cond is true
+*******************************************************************************/
+#define CO_WAIT_UNTIL(co, cond)                                             \
+    do{                                                                     \
+        (co)->line = (INT16U)__LINE__; case __LINE__:                       \
+        if(!(cond)){ return; } else{}                                       \
+    }while(0)
+
+/*******************************************************************************
+* CO_SLEEP_MS(co, ms) - returns on every call until ms milliseconds passed.
+* The resolution is the period the task is called with.
+*******************************************************************************/
+#define CO_SLEEP_MS(co, ms)                                                 \
+    do{                                                                     \
+        (co)->stamp = SysTickGetmsCount();                                  \
+        CO_WAIT_UNTIL(co, (SysTickGetmsCount() - (co)->stamp) >= (INT32U)(ms)); \
+    }while(0)
+
+/*******************************************************************************
+* CO_RUNNING(co) - true when the next call does not start from CO_BEGIN(),
+* i.e. the coroutine is parked at a yield or a wait. A coroutine waiting at its
+* first CO_WAIT_UNTIL() for work also counts, so this is not a busy flag; keep
+* one in the task if the application needs to know the work is under way.
+*******************************************************************************/
+#define CO_RUNNING(co)  ((co)->line != 0U)
+
+#endif
@@ -0,0 +1,195 @@
+/*******************************************************************************
+* EventBus.c
+*
+* This module contains a statically allocated publish/subscribe event bus.
+* Producers post typed events into one queue per priority. A slot is reserved
+* with LDREX/STREX on the queue head and marked ready after it is written, so
+* posting needs no interrupt masking and any number of tasks and ISRs can post.
+* EvtDispatch() is the only consumer.
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+/*******************************************************************************
+* Includes
+*******************************************************************************/
+#include "MCUType.h"
+#include "SysTickDelay.h"
+#include "EventBus.h"
+#include "Trace.h"
+
+/*******************************************************************************
+* Private Resources
+*******************************************************************************/
+typedef struct{
+    volatile INT32U head;               /* next slot to reserve, producers */
+    volatile INT32U tail;               /* next slot to read, EvtDispatch() */
+    volatile INT8U ready[EVT_QUEUE_LEN];
+    EVT_T buf[EVT_QUEUE_LEN];
+}EVT_QUEUE_T;
+
+typedef struct{
+    INT32U mask;
+    EVT_HANDLER_T handler;
+}EVT_SUB_T;
+
+static EVT_QUEUE_T evtQueues[EVT_PRIO_NUM];
+static EVT_SUB_T evtSubs[EVT_MAX_SUBS];
+static INT8U evtNumSubs;
+static EVT_T evtTrace[EVT_TRACE_LEN];
+static INT32U evtTraceCnt;
+static volatile INT32U evtDropCnt;
+
+/******************************************************************************
+* Function Code
+******************************************************************************/
+
+/*******************************************************************************
+* EvtInit() - PUBLIC
+*   parameter: none
+*   description: clears the queues, subscribers and trace. Must be called
+*   before any other event bus function.
+*******************************************************************************/
+void EvtInit(void){
+    INT8U prio;
+    INT8U slot;
+    for(prio = 0; prio < EVT_PRIO_NUM; prio++){
+        evtQueues[prio].head = 0;
+        evtQueues[prio].tail = 0;
+        for(slot = 0; slot < EVT_QUEUE_LEN; slot++){
+            evtQueues[prio].ready[slot] = 0;
+        }
+    }
+    evtNumSubs = 0;
+    evtTraceCnt = 0;
+    evtDropCnt = 0;
+}
+
+/*******************************************************************************
+* EvtPost(EVT_TYPE_T type, EVT_PRIO_T prio, INT32U arg) - PUBLIC
+*   parameter: type - event type
+*              prio - queue the event is posted to
+*              arg - event argument
+*   description: posts an event. Lock-free and safe to call from tasks and
+*   ISRs. Returns 0 if posted, 1 if the queue was full and it was dropped.
+*******************************************************************************/
+INT8U EvtPost(EVT_TYPE_T type, EVT_PRIO_T prio, INT32U arg){
+    EVT_QUEUE_T *queue;
+    EVT_T *evt;
+    INT32U head;
+    INT32U drops;
+    INT8U full = 0;
+    if((type >= EVT_NUM) || (prio >= EVT_PRIO_NUM)){
+        full = 1;
+    } else{
+        queue = &evtQueues[prio];
+        do{ /* reserve a slot, retried if another post got in first */
+            head = __LDREXW((volatile uint32_t *)&queue->head);
+            if((head - queue->tail) >= EVT_QUEUE_LEN){
+                __CLREX();
+                full = 1;
+                break;
+            } else{}
+        }while(__STREXW(head + 1U, (volatile uint32_t *)&queue->head) != 0);
+        if(full == 0){
+            evt = &queue->buf[head & (EVT_QUEUE_LEN - 1U)];
+            evt->type = (INT8U)type;
+            evt->prio = (INT8U)prio;
+            evt->seq = (INT16U)head;
+            evt->arg = arg;
+            evt->stamp = SysTickGetmsCount();
+            __DMB();    /* event must be written before it is marked ready */
+            queue->ready[head & (EVT_QUEUE_LEN - 1U)] = 1;
+        } else{
+            do{ /* count it, retried like the reservation as ISRs post too */
+                drops = __LDREXW((volatile uint32_t *)&evtDropCnt);
+            }while(__STREXW(drops + 1U, (volatile uint32_t *)&evtDropCnt) != 0);
+        }
+    }
+    return full;
+}
+
+/*******************************************************************************
+* EvtSubscribe(INT32U mask, EVT_HANDLER_T handler) - PUBLIC
+*   parameter: mask - EVT_MASK() of every event type wanted
+*              handler - function called from EvtDispatch() for each event
+*   description: adds a subscriber. Returns 0 if added, 1 if the subscriber
+*   table is full.
+*******************************************************************************/
+INT8U EvtSubscribe(INT32U mask, EVT_HANDLER_T handler){
+    INT8U rval;
+    if(evtNumSubs < EVT_MAX_SUBS){
+        evtSubs[evtNumSubs].mask = mask;
+        evtSubs[evtNumSubs].handler = handler;
+        evtNumSubs++;
+        rval = 0;
+    } else{
+        rval = 1;
+    }
+    return rval;
+}
+
+/*******************************************************************************
+* EvtDispatch() - PUBLIC
+*   parameter: none
+*   description: cooperative task that delivers all queued events, highest
+*   priority first, to their subscribers and records them in the trace. A
+*   reserved slot that is not ready yet belongs to a post that was interrupted,
+*   so that queue is left until the next call to keep the events in order.
+*******************************************************************************/
+void EvtDispatch(void){
+    EVT_QUEUE_T *queue;
+    EVT_T evt;
+    INT32U slot;
+    INT8U prio;
+    INT8U sub;
+    for(prio = 0; prio < EVT_PRIO_NUM; prio++){
+        queue = &evtQueues[prio];
+        while(queue->tail != queue->head){
+            slot = queue->tail & (EVT_QUEUE_LEN - 1U);
+            if(queue->ready[slot] == 0){
+                break;
+            } else{}
+            __DMB();
+            evt = queue->buf[slot];
+            queue->ready[slot] = 0;
+            __DMB();    /* slot must be copied before it is released */
+            queue->tail++;
+            evtTrace[evtTraceCnt & (EVT_TRACE_LEN - 1U)] = evt;
+            evtTraceCnt++;
+            TRACE(TRC_EVT, evt.type);
+            for(sub = 0; sub < evtNumSubs; sub++){
+                if((evtSubs[sub].mask & EVT_MASK(evt.type)) != 0){
+                    evtSubs[sub].handler(&evt);
+                } else{}
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+* EvtTraceGet(INT8U age, EVT_T *evt) - PUBLIC
+*   parameter: age - 0 for the last dispatched event, 1 for the one before...
+*              evt - where the event is copied
+*   description: reads the dispatch trace. Returns 0 if evt is valid, 1 if
+*   there is no event that old.
+*******************************************************************************/
+INT8U EvtTraceGet(INT8U age, EVT_T *evt){
+    INT8U rval;
+    if((age < EVT_TRACE_LEN) && (age < evtTraceCnt)){
+        *evt = evtTrace[(evtTraceCnt - 1U - age) & (EVT_TRACE_LEN - 1U)];
+        rval = 0;
+    } else{
+        rval = 1;
+    }
+    return rval;
+}
+
+/*******************************************************************************
+* EvtGetDropCount() - PUBLIC
+*   parameter: none
+*   description: returns the number of events dropped because a queue was full
+*******************************************************************************/
+INT32U EvtGetDropCount(void){
+    return evtDropCnt;
+}
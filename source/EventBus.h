@@ -0,0 +1,103 @@
+/*******************************************************************************
+* EventBus.h
+*
+* This module contains all function prototypes and event definitions for
+* EventBus.c
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+#ifndef EVENTBUSH
+#define EVENTBUSH
+
+/*******************************************************************************
+* Definition of event bus macros/constants
+*******************************************************************************/
+#define EVT_QUEUE_LEN       16U     /* events per priority, power of two */
+#define EVT_MAX_SUBS        8U      /* number of subscribers */
+#define EVT_TRACE_LEN       32U     /* dispatched events kept, power of two */
+#define EVT_MASK(type)      ((INT32U)1U << (type))
+
+/*******************************************************************************
+* Event types. The arg of each event is listed with the type.
+*******************************************************************************/
+typedef enum {
+    EVT_KEY,        /* arg: ASCII code of the key, from KeyTask() */
+    EVT_TOUCH,      /* arg: TSI channel, bit 8 set on press, from TSITask() */
+    EVT_TILT,       /* arg: 1 when tilted, 0 when level, from AccelTask() */
+    EVT_RTC_SEC,    /* arg: RTC seconds count, from the RTC seconds ISR */
+    EVT_ZONE,       /* arg: new active zone mask, from ZoneTask() */
+    EVT_STATE,      /* arg: new alarm state, from the control task */
+    EVT_LINE,       /* arg: line length | BIO_LINE_OVF, from BIOLineTask() */
+    EVT_NUM
+} EVT_TYPE_T;
+
+typedef enum {
+    EVT_PRIO_HIGH,
+    EVT_PRIO_NORM,
+    EVT_PRIO_LOW,
+    EVT_PRIO_NUM
+} EVT_PRIO_T;
+
+typedef struct{
+    INT8U type;
+    INT8U prio;
+    INT16U seq;         /* per priority post sequence number */
+    INT32U arg;
+    INT32U stamp;       /* ms count when the event was posted */
+}EVT_T;
+
+typedef void (*EVT_HANDLER_T)(const EVT_T *evt);
+
+/*******************************************************************************
+* EvtInit() - PUBLIC
+*   parameter: none
+*   description: clears the queues, subscribers and trace. Must be called
+*   before any other event bus function.
+*******************************************************************************/
+void EvtInit(void);
+
+/*******************************************************************************
+* EvtPost(EVT_TYPE_T type, EVT_PRIO_T prio, INT32U arg) - PUBLIC
+*   parameter: type - event type
+*              prio - queue the event is posted to
+*              arg - event argument
+*   description: posts an event. Lock-free and safe to call from tasks and
+*   ISRs. Returns 0 if posted, 1 if the queue was full and it was dropped.
+*******************************************************************************/
+INT8U EvtPost(EVT_TYPE_T type, EVT_PRIO_T prio, INT32U arg);
+
+/*******************************************************************************
+* EvtSubscribe(INT32U mask, EVT_HANDLER_T handler) - PUBLIC
+*   parameter: mask - EVT_MASK() of every event type wanted
+*              handler - function called from EvtDispatch() for each event
+*   description: adds a subscriber. Returns 0 if added, 1 if the subscriber
+*   table is full.
+*******************************************************************************/
+INT8U EvtSubscribe(INT32U mask, EVT_HANDLER_T handler);
+
+/*******************************************************************************
+* EvtDispatch() - PUBLIC
+*   parameter: none
+*   description: cooperative task that delivers all queued events, highest
+*   priority first, to their subscribers and records them in the trace.
+*******************************************************************************/
+void EvtDispatch(void);
+
+/*******************************************************************************
+* EvtTraceGet(INT8U age, EVT_T *evt) - PUBLIC
+*   parameter: age - 0 for the last dispatched event, 1 for the one before...
+*              evt - where the event is copied
+*   description: reads the dispatch trace. Returns 0 if evt is valid, 1 if
+*   there is no event that old.
+*******************************************************************************/
+INT8U EvtTraceGet(INT8U age, EVT_T *evt);
+
+/*******************************************************************************
+* EvtGetDropCount() - PUBLIC
+*   parameter: none
+*   description: returns the number of events dropped because a queue was full
+*******************************************************************************/
+INT32U EvtGetDropCount(void);
+
+#endif
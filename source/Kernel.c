@@ -0,0 +1,256 @@
+/*******************************************************************************
+* Kernel.c
+*
+* This module contains a minimal fixed priority preemptive kernel. Every
+* thread has a static stack and a release period. The SysTick hook releases
+* threads and PendSV switches to the highest priority ready thread. FPU
+* registers use lazy stacking, so s16-s31 are only saved for threads that
+* have used the FPU (EXC_RETURN bit 4 clear).
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+/*******************************************************************************
+* Includes
+*******************************************************************************/
+#include "MCUType.h"
+#include "SysTickDelay.h"
+#include "Kernel.h"
+
+/*******************************************************************************
+* Private Resources
+*******************************************************************************/
+typedef struct{
+    INT32U *sp;         /* saved stack pointer, must be first for PendSV */
+    INT32U release;     /* ms count of the next release */
+    INT32U period;
+    INT8U prio;
+    volatile INT8U ready;
+}KNL_TCB_T;
+
+#define KNL_XPSR_THUMB      0x01000000U
+#define KNL_EXC_RET_PSP     0xFFFFFFFDU     /* thread mode, PSP, no FPU frame */
+#define KNL_MAIN_WORDS      64U             /* main() context saved at start */
+
+/* Handler and TCB pointers are not static so the PendSV asm can see them */
+void PendSV_Handler(void);
+KNL_TCB_T *knlCurTcb;
+KNL_TCB_T *knlNextTcb;
+
+static KNL_TCB_T knlTcbs[KNL_MAX_THREADS + 1U];    /* last one is idle */
+static INT32U knlStacks[KNL_MAX_THREADS + 1U][KNL_STACK_WORDS] __attribute__((aligned(8)));
+static INT32U knlMainStack[KNL_MAIN_WORDS] __attribute__((aligned(8)));
+static KNL_TCB_T knlMainTcb;
+static INT8U knlNumThreads;
+
+static void knlInitStack(KNL_TCB_T *tcb, INT32U *stack, void (*entry)(INT32U),
+                         INT32U arg);
+static void knlThreadExit(void);
+static void knlIdle(INT32U arg);
+static void knlSchedule(void);
+static void knlTick(void);
+
+/******************************************************************************
+* Function Code
+******************************************************************************/
+
+/*******************************************************************************
+* KnlThreadCreate(void (*entry)(INT32U), INT32U arg, INT8U prio,
+*                 INT32U period, INT32U phase) - PUBLIC
+*   parameter: entry - thread function, must never return
+*              arg - passed to entry
+*              prio - 0 is highest, equal priorities do not preempt each other
+*              period - release period in ms
+*              phase - first release in ms after KnlStart()
+*   description: adds a thread with a static stack. Must be called before
+*   KnlStart(). Returns 0 if created, 1 if there is no thread left.
+*******************************************************************************/
+INT8U KnlThreadCreate(void (*entry)(INT32U), INT32U arg, INT8U prio,
+                      INT32U period, INT32U phase){
+    KNL_TCB_T *tcb;
+    INT8U rval;
+    if(knlNumThreads < KNL_MAX_THREADS){
+        tcb = &knlTcbs[knlNumThreads];
+        knlInitStack(tcb, knlStacks[knlNumThreads], entry, arg);
+        tcb->prio = prio;
+        tcb->period = period;
+        tcb->release = phase;       /* made absolute by KnlStart() */
+        tcb->ready = 0;
+        knlNumThreads++;
+        rval = 0;
+    } else{
+        rval = 1;
+    }
+    return rval;
+}
+
+/*******************************************************************************
+* KnlStart() - PUBLIC
+*   parameter: none
+*   description: hooks the kernel tick to the SysTick and switches to the
+*   highest priority thread. The caller's stack is abandoned. Never returns.
+*******************************************************************************/
+void KnlStart(void){
+    INT8U thread;
+    INT32U now;
+    KNL_TCB_T *idle = &knlTcbs[KNL_MAX_THREADS];
+    __disable_irq();
+    knlInitStack(idle, knlStacks[KNL_MAX_THREADS], knlIdle, 0);
+    idle->prio = KNL_PRIO_IDLE;
+    idle->ready = 1;
+    now = SysTickGetmsCount();
+    for(thread = 0; thread < knlNumThreads; thread++){
+        knlTcbs[thread].release += now;
+    }
+    FPU->FPCCR |= FPU_FPCCR_ASPEN_Msk|FPU_FPCCR_LSPEN_Msk;
+    NVIC_SetPriority(PendSV_IRQn, (1U << __NVIC_PRIO_BITS) - 1U);
+    /* the first switch saves main() on a scratch PSP stack that is never used again */
+    __set_PSP((INT32U)&knlMainStack[KNL_MAIN_WORDS]);
+    knlCurTcb = &knlMainTcb;
+    SysTickSetHook(knlTick);
+    knlSchedule();
+    __enable_irq();
+    while(TRUE){}
+}
+
+/*******************************************************************************
+* KnlWaitPeriod() - PUBLIC
+*   parameter: none
+*   description: blocks the calling thread until its next release. Returns 1
+*   if the release had already passed (overrun), 0 if the thread waited.
+*******************************************************************************/
+INT8U KnlWaitPeriod(void){
+    INT8U late;
+    __disable_irq();
+    knlCurTcb->release += knlCurTcb->period;
+    if((INT32S)(SysTickGetmsCount() - knlCurTcb->release) >= 0){
+        late = 1;
+    } else{
+        late = 0;
+        knlCurTcb->ready = 0;
+        knlSchedule();
+    }
+    __enable_irq();     /* PendSV switches away here */
+    return late;
+}
+
+/*******************************************************************************
+* knlInitStack() - PRIVATE
+*   parameter: tcb - thread control block
+*              stack - KNL_STACK_WORDS words
+*              entry - thread function
+*              arg - passed to entry in r0
+*   description: builds the frame PendSV_Handler() restores the first time
+*   the thread runs: r4-r11 and EXC_RETURN under a basic exception frame.
+*******************************************************************************/
+static void knlInitStack(KNL_TCB_T *tcb, INT32U *stack, void (*entry)(INT32U),
+                         INT32U arg){
+    INT32U *sp = &stack[KNL_STACK_WORDS];
+    INT8U reg;
+    *(--sp) = KNL_XPSR_THUMB;                   /* xPSR */
+    *(--sp) = (INT32U)entry & ~1U;              /* PC */
+    *(--sp) = (INT32U)knlThreadExit;            /* LR */
+    *(--sp) = 0;                                /* r12 */
+    *(--sp) = 0;                                /* r3 */
+    *(--sp) = 0;                                /* r2 */
+    *(--sp) = 0;                                /* r1 */
+    *(--sp) = arg;                              /* r0 */
+    *(--sp) = KNL_EXC_RET_PSP;                  /* EXC_RETURN */
+    for(reg = 0; reg < 8U; reg++){
+        *(--sp) = 0;                            /* r11-r4 */
+    }
+    tcb->sp = sp;
+}
+
+/*******************************************************************************
+* knlThreadExit() - PRIVATE
+*   parameter: none
+*   description: a thread function returned, which is not allowed
+*******************************************************************************/
+static void knlThreadExit(void){
+    while(TRUE){}
+}
+
+/*******************************************************************************
+* knlIdle() - PRIVATE
+*   parameter: arg - not used
+*   description: lowest priority thread, sleeps until the next interrupt
+*******************************************************************************/
+static void knlIdle(INT32U arg){
+    while(TRUE){
+        __WFI();
+    }
+}
+
+/*******************************************************************************
+* knlSchedule() - PRIVATE
+*   parameter: none
+*   description: picks the highest priority ready thread, the first one in
+*   creation order for equal priorities, and pends PendSV if it is not the
+*   running thread. Called with interrupts masked or from the SysTick.
+*******************************************************************************/
+static void knlSchedule(void){
+    KNL_TCB_T *best = &knlTcbs[KNL_MAX_THREADS];
+    INT8U thread;
+    for(thread = 0; thread < knlNumThreads; thread++){
+        if((knlTcbs[thread].ready != 0) && (knlTcbs[thread].prio < best->prio)){
+            best = &knlTcbs[thread];
+        } else{}
+    }
+    /* a running thread is only preempted by a higher priority */
+    if((knlCurTcb->ready != 0) && (knlCurTcb->prio <= best->prio)){
+        best = knlCurTcb;
+    } else{}
+    knlNextTcb = best;
+    if(best != knlCurTcb){
+        SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    } else{}
+}
+
+/*******************************************************************************
+* knlTick() - PRIVATE
+*   parameter: none
+*   description: SysTick hook, releases the threads that are due
+*******************************************************************************/
+static void knlTick(void){
+    INT32U now = SysTickGetmsCount();
+    INT8U thread;
+    for(thread = 0; thread < knlNumThreads; thread++){
+        if((knlTcbs[thread].ready == 0) &&
+           ((INT32S)(now - knlTcbs[thread].release) >= 0)){
+            knlTcbs[thread].ready = 1;
+        } else{}
+    }
+    knlSchedule();
+}
+
+/*******************************************************************************
+* PendSV_Handler() - PUBLIC
+*   parameter: none
+*   description: saves r4-r11, EXC_RETURN and, if the thread used the FPU,
+*   s16-s31 on the process stack, then restores knlNextTcb the same way.
+*******************************************************************************/
+__attribute__((naked)) void PendSV_Handler(void){
+    __asm volatile(
+        "cpsid   i                  \n"
+        "mrs     r0, psp            \n"
+        "tst     lr, #0x10          \n"
+        "it      eq                 \n"
+        "vstmdbeq r0!, {s16-s31}    \n"
+        "stmdb   r0!, {r4-r11, lr}  \n"
+        "ldr     r1, =knlCurTcb     \n"
+        "ldr     r2, [r1]           \n"
+        "str     r0, [r2]           \n"
+        "ldr     r2, =knlNextTcb    \n"
+        "ldr     r2, [r2]           \n"
+        "str     r2, [r1]           \n"
+        "ldr     r0, [r2]           \n"
+        "ldmia   r0!, {r4-r11, lr}  \n"
+        "tst     lr, #0x10          \n"
+        "it      eq                 \n"
+        "vldmiaeq r0!, {s16-s31}    \n"
+        "msr     psp, r0            \n"
+        "cpsie   i                  \n"
+        "bx      lr                 \n"
+    );
+}
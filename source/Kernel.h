@@ -0,0 +1,50 @@
+/*******************************************************************************
+* Kernel.h
+*
+* This module contains all function prototypes and configuration for
+* Kernel.c
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+#ifndef KERNELH
+#define KERNELH
+
+/*******************************************************************************
+* Definition of kernel macros/constants
+*******************************************************************************/
+#define KNL_MAX_THREADS     10U     /* not counting the idle thread */
+#define KNL_STACK_WORDS     512U    /* per thread, room for FPU frames */
+#define KNL_PRIO_IDLE       0xFFU
+
+/*******************************************************************************
+* KnlThreadCreate(void (*entry)(INT32U), INT32U arg, INT8U prio,
+*                 INT32U period, INT32U phase) - PUBLIC
+*   parameter: entry - thread function, must never return
+*              arg - passed to entry
+*              prio - 0 is highest, equal priorities do not preempt each other
+*              period - release period in ms
+*              phase - first release in ms after KnlStart()
+*   description: adds a thread with a static stack. Must be called before
+*   KnlStart(). Returns 0 if created, 1 if there is no thread left.
+*******************************************************************************/
+INT8U KnlThreadCreate(void (*entry)(INT32U), INT32U arg, INT8U prio,
+                      INT32U period, INT32U phase);
+
+/*******************************************************************************
+* KnlStart() - PUBLIC
+*   parameter: none
+*   description: hooks the kernel tick to the SysTick and switches to the
+*   highest priority thread. The caller's stack is abandoned. Never returns.
+*******************************************************************************/
+void KnlStart(void);
+
+/*******************************************************************************
+* KnlWaitPeriod() - PUBLIC
+*   parameter: none
+*   description: blocks the calling thread until its next release. Returns 1
+*   if the release had already passed (overrun), 0 if the thread waited.
+*******************************************************************************/
+INT8U KnlWaitPeriod(void);
+
+#endif
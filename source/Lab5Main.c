@@ -22,16 +22,36 @@
 #include "K65TWR_I2C.h"
 #include "MMA8451Q.h"
 #include "K65TWR_TSI.h"
+#include "WaveBank.h"
+#include "Adpcm.h"
+#include "SoundClips.h"
 #include "WaveGenDMA.h"
 #include "Clock.h"
+#include "LedPat.h"
+#include "Zone.h"
+#include "EventBus.h"
+#include "TaskSched.h"
+#include "PwrMgr.h"
+#include "Coroutine.h"
+#include "Shell.h"
+#include "Telem.h"
+#include "Trace.h"
 
 /*******************************************************************************
 * Define constants and type
 *******************************************************************************/
 #define START_ADDS (INT8U*)0x00000000U
 #define END_ADDS (INT8U*)0x001FFFFFU
-#define SLICE_PERIOD 10
+#define CSUM_BLOCK 32768U   /* bytes summed per call of lab5CSumTask() */
+#define ACCEL_XY_LIM 16     /* tilt when x or y is at or over, 1/64g counts */
+#define ACCEL_Z_LIM 48      /* tilt when z is at or under, 1/64g counts */
+#define LAB5_PER_FAST 5U    /* task periods in ms, each divides LAB5_HYPER_MS */
+#define LAB5_PER_IO 10U
+#define LAB5_PER_CLOCK 100U
+#define LAB5_HYPER_MS 100U  /* hyperperiod of the task table */
+#define LAB5_HALT_MS 250U   /* LED blink when the scheduler can not start */
 typedef enum {DISARMED, ARMED, ALARM} STATES_T;
+typedef enum {CFG_TSI1, CFG_TSI2, CFG_AXY, CFG_AZ, CFG_SLICE, CFG_NUM} CFG_T;
 
 /*******************************************************************************
 * lab5ControlTask() - PRIVATE
@@ -40,50 +60,217 @@ typedef enum {DISARMED, ARMED, ALARM} STATES_T;
 *******************************************************************************/
 static void lab5ControlTask(void);
 
+/*******************************************************************************
+* lab5EvtHandler() - PRIVATE
+*   parameter: evt - EVT_KEY or EVT_ZONE event
+*   description: event bus subscriber of the control task. Keys are saved for
+*   lab5ControlTask() and new tamper zones are shown on the LCD.
+*******************************************************************************/
+static void lab5EvtHandler(const EVT_T *evt);
+
+/*******************************************************************************
+* lab5CSumTask() - PRIVATE
+*   parameter: none
+*   description: checksum of the flash for the C key, done a block per call
+*******************************************************************************/
+static void lab5CSumTask(void);
+
 /*******************************************************************************
 * LEDTask() - PRIVATE
 *   parameter: none
-*   description: control the LEDs flashing
+*   description: selects the LED patterns for the current state. The flashing
+*   itself is done by the LED pattern engine.
 *******************************************************************************/
 static void LEDTask(void);
 
 /*******************************************************************************
 * AccelTask() - PRIVATE
 *   parameter: none
-*   description: tampering notification using on-board accelerometer. detect
+*   description: tampering detection using on-board accelerometer. detect
 *   some form of movement that indicates that someone is tampering with the
-*   alarm system.
+*   alarm system, post it to the accelerometer zone source and post EVT_TILT
+*   when it changes.
 *******************************************************************************/
 static void AccelTask(void);
 
+/*******************************************************************************
+* lab5SensCmd(), lab5CSumCmd(), lab5PwrCmd(), lab5CfgCmd() - PRIVATE
+*   parameter: step - command step
+*              argc, argv - command arguments
+*   description: diagnostic shell commands, see lab5ShellCmds[]
+*******************************************************************************/
+static INT8U lab5SensCmd(INT8U step, INT8U argc, INT8C *argv[]);
+static INT8U lab5CSumCmd(INT8U step, INT8U argc, INT8C *argv[]);
+static INT8U lab5PwrCmd(INT8U step, INT8U argc, INT8C *argv[]);
+static INT8U lab5CfgCmd(INT8U step, INT8U argc, INT8C *argv[]);
+static INT8U lab5TelemCmd(INT8U step, INT8U argc, INT8C *argv[]);
+static INT8U lab5SirenCmd(INT8U step, INT8U argc, INT8C *argv[]);
+static INT8U lab5WaveCmd(INT8U step, INT8U argc, INT8C *argv[]);
+static INT8U lab5ClipCmd(INT8U step, INT8U argc, INT8C *argv[]);
+static INT8U lab5VolCmd(INT8U step, INT8U argc, INT8C *argv[]);
+static INT8U lab5AudioCmd(INT8U step, INT8U argc, INT8C *argv[]);
+static INT8U lab5BenchCmd(INT8U step, INT8U argc, INT8C *argv[]);
+static INT8U lab5BenchStep(INT8U step);
+static INT8U lab5SoundFree(void);
+static void lab5SoundRestore(void);
+static void lab5ProfPrint(WAVE_BE_T be);
+static void lab5VectPrint(const INT8C *const name, INT32U exc);
+
+/*******************************************************************************
+* lab5TelemTsi1() ... lab5TelemAccZ() - PRIVATE
+*   parameter: none
+*   description: telemetry channel readers, see lab5TelemChs[]
+*******************************************************************************/
+static INT16S lab5TelemTsi1(void);
+static INT16S lab5TelemTsi2(void);
+static INT16S lab5TelemAccX(void);
+static INT16S lab5TelemAccY(void);
+static INT16S lab5TelemAccZ(void);
+
+/*******************************************************************************
+* lab5CfgGet(), lab5CfgSet() - PRIVATE
+*   parameter: cfg - setting
+*              val - new value
+*   description: reads or changes a setting of the cfg command. lab5CfgSet()
+*   returns 0 if set, 1 if the value is out of range.
+*******************************************************************************/
+static INT32U lab5CfgGet(CFG_T cfg);
+static INT8U lab5CfgSet(CFG_T cfg, INT32U val);
+
 /*******************************************************************************
 * Code
 *******************************************************************************/
 static STATES_T CurState;
 static STATES_T PrevState;
-static INT8U Led8Indi = 0;
-static INT8U Led9Indi = 0;
-static INT8U Counter1 = 0;
-static INT8U Counter2 = 0;
+static INT32U AlarmZones = 0;
+static INT32U PrevTamperZones = 0;
+static INT8U EntryDlyOn = 0;
+static INT32U EntryDlyStart = 0;
+static INT8C CtrlKey = 0;
+static INT8U AccelTilt = 0;
+static INT8U CSumReq = 0;
+static INT8U CSumBusy = 0;
+static CO_T CSumCo;
+static INT8U *CSumAddr;
+static INT16U CSumSum;
+static INT8U CSumValid = 0;
+static INT8S AccelRaw[3];
+static INT8S AccelXYLim = ACCEL_XY_LIM;
+static INT8S AccelZLim = ACCEL_Z_LIM;
+/* Waveform of the sounds of each state, DISARMED is silent */
+static WAVE_TBL_T StateWave[] = {WAVE_TBL_SINE, WAVE_TBL_SINE, WAVE_TBL_SIREN};
+static const INT8C *const StateNames[] = {"disarmed", "armed", "alarm"};
+static const INT8C *const CfgNames[CFG_NUM] = {"tsi1", "tsi2", "axy", "az", "slice"};
+static const INT8C *const AudioNames[WAVE_BE_NUM] = {"isr", "dma", "dacbuf"};
+static WAVE_PROF_T AudioProf[WAVE_BE_NUM];
+static INT8U BenchSound;            /* sound the bench self-test is on */
+static INT8U BenchNew;              /* 1 to start the self-test on it */
+static INT8U ClipNum;               /* clip of the clip command */
+static INT32U ClipPos;              /* samples of it checked */
+static INT16U ClipCrc;
+static ADPCM_STATE_T ClipState;
+
+/*******************************************************************************
+* Shell commands. Values are in hex, as read by BIOHexStrgtoWord().
+*******************************************************************************/
+static const SHELL_CMD_T lab5ShellCmds[] = {
+    {"sens",    lab5SensCmd,    "TSI counts and accelerometer raw values"},
+    {"csum",    lab5CSumCmd,    "checksum status, 'csum run' starts one"},
+    {"pwr",     lab5PwrCmd,     "LLS wake zones, sleeps, wakeups and wakeup latency"},
+    {"cfg",     lab5CfgCmd,     "list settings, 'cfg <name> <hex>' sets one"},
+    {"telem",   lab5TelemCmd,   "stream status, 'telem <hex mask>' streams, 0 stops"},
+    {"siren",   lab5SirenCmd,   "siren tone, 'siren <n>' 0 steady 1 wail 2 yelp 3 hi-lo"},
+    {"wave",    lab5WaveCmd,    "waveform per state, 'wave <state> <n>' sets one"},
+    {"clip",    lab5ClipCmd,    "sound clips, 'clip <n>' plays one when disarmed, 'clip check' decodes all"},
+    {"vol",     lab5VolCmd,     "siren and clip volume, 'vol <hex>' sets 0-40"},
+    {"audio",   lab5AudioCmd,   "output backend, 'audio <n>' 0 isr 1 dma 2 dacbuf, 'audio test'"},
+    {"bench",   lab5BenchCmd,   "ISR placement, latency and run time of SysTick and audio"}
+};
+#define LAB5_NUM_CMDS   (INT8U)(sizeof(lab5ShellCmds)/sizeof(lab5ShellCmds[0]))
+
+/*******************************************************************************
+* Telemetry channels, mask bit 0 first. tools/telem_decode.py has the same list.
+*******************************************************************************/
+#define LAB5_TELEM_MS   10U     /* TelemTask() period in lab5TaskTable[] */
+static const TELEM_CH_T lab5TelemChs[] = {
+    {lab5TelemTsi1,     "tsi1"},
+    {lab5TelemTsi2,     "tsi2"},
+    {lab5TelemAccX,     "ax"},
+    {lab5TelemAccY,     "ay"},
+    {lab5TelemAccZ,     "az"}
+};
+#define LAB5_NUM_TELEM  (INT8U)(sizeof(lab5TelemChs)/sizeof(lab5TelemChs[0]))
+
+/*******************************************************************************
+* Task table. Priorities are rate-monotonic and the wcet estimates are used by
+* SchedInit() to spread the tasks across the 5ms slices. TSITask() waits for
+* the scan started in its last call and AccelTask() does three I2C reads, so
+* they are kept out of each other's slice. lab5ControlTask() only allows LLS
+* while every armed zone is a wakeup source (PwrGetWakeZones()), so the tasks
+* poll nothing that can change unseen in LLS, or follow the RTC, which wakes
+* them every second, and all are SCHED_F_WAKE. Both pads take turns in the
+* LLS scan and the accelerometer INT1 wakes it, so with the default zone
+* table the part sleeps whenever it is armed and idle: 'pwr' shows it. The UART
+* stops in LLS, so the line and shell tasks have nothing to do while asleep
+* and are SCHED_F_WAKE as well. The input
+* tasks share priority 0 (TSI flags) and the tasks that write the LCD share
+* priority 1, so with SCHED_PREEMPT_EN the inputs preempt the UI but the LCD
+* is never written by two tasks at once.
+*******************************************************************************/
+static const SCHED_TASK_T lab5TaskTable[] = {
+    /* task             period          phase               prio  wcet   flags          name */
+    {AccelTask,         LAB5_PER_IO,    SCHED_PHASE_AUTO,   0,    1400,  SCHED_F_WAKE,  "Accel"},
+    {TSITask,           LAB5_PER_IO,    SCHED_PHASE_AUTO,   0,    1500,  SCHED_F_WAKE,  "TSI"},
+    {KeyTask,           LAB5_PER_IO,    SCHED_PHASE_AUTO,   0,    20,    SCHED_F_WAKE,  "Key"},
+    {ZoneTask,          LAB5_PER_IO,    SCHED_PHASE_AUTO,   0,    20,    SCHED_F_WAKE,  "Zone"},
+    {EvtDispatch,       LAB5_PER_FAST,  SCHED_PHASE_AUTO,   1,    100,   SCHED_F_WAKE,  "Evt"},
+    {lab5ControlTask,   LAB5_PER_IO,    SCHED_PHASE_AUTO,   1,    1500,  SCHED_F_WAKE,  "Ctrl"},
+    {LEDTask,           LAB5_PER_IO,    SCHED_PHASE_AUTO,   1,    150,   SCHED_F_WAKE,  "LED"},
+    {ClockTask,         LAB5_PER_CLOCK, SCHED_PHASE_AUTO,   1,    500,   SCHED_F_WAKE,  "Clock"},
+    {lab5CSumTask,      LAB5_PER_FAST,  SCHED_PHASE_AUTO,   1,    1000,  SCHED_F_WAKE,  "CSum"},
+    {BIOLineTask,       LAB5_PER_IO,    SCHED_PHASE_AUTO,   1,    50,    SCHED_F_WAKE,  "Line"},
+    {ShellTask,         LAB5_PER_IO,    SCHED_PHASE_AUTO,   1,    300,   SCHED_F_WAKE,  "Shell"},
+    {TelemTask,         LAB5_PER_IO,    SCHED_PHASE_AUTO,   1,    150,   SCHED_F_WAKE,  "Telem"}
+};
+#define LAB5_NUM_TASKS  (INT8U)(sizeof(lab5TaskTable)/sizeof(lab5TaskTable[0]))
+
+/* Build time check that SchedInit() accepts the table at SCHED_SLICE_MS, the
+ * array size is negative if the hyperperiod is over SCHED_HYPER_MAX slices or
+ * a period does not divide it. A new period needs a LAB5_PER_ macro and a line
+ * here. */
+typedef INT8U lab5HyperCheck[(((LAB5_HYPER_MS % LAB5_PER_FAST) == 0U) &&
+                              ((LAB5_HYPER_MS % LAB5_PER_IO) == 0U) &&
+                              ((LAB5_HYPER_MS % LAB5_PER_CLOCK) == 0U) &&
+                              ((LAB5_HYPER_MS % SCHED_SLICE_MS) == 0U) &&
+                              ((LAB5_HYPER_MS / SCHED_SLICE_MS) <= SCHED_HYPER_MAX)) ? 1 : -1];
 
 void main(void){
 
     INT16U sum;
 
     K65TWR_BootClock();
+    EvtInit();
     BIOOpen(BIO_BIT_RATE_115200);
     SysTickDlyInit();
+    TraceInit();
     LcdDispInit();
     KeyInit();
     GpioDBugBitsInit();
     GpioLED8Init();
     GpioLED9Init();
+    LedPatInit();
     TSIInit();
     TSIChCalibration((INT8U)11);
     TSIChCalibration((INT8U)12);
     (void)MMA8451Init();
     WaveGenDMAInit();
     ClockInit();
+    ZoneInit();
+    PwrInit();
+    CO_INIT(&CSumCo);
+    (void)EvtSubscribe(EVT_MASK(EVT_KEY)|EVT_MASK(EVT_ZONE), lab5EvtHandler);
+    ShellInit(lab5ShellCmds, LAB5_NUM_CMDS);
+    TelemInit(lab5TelemChs, LAB5_NUM_TELEM, LAB5_TELEM_MS);
 
     sum = MemCSumGet(START_ADDS,END_ADDS);
     LcdDispClear();
@@ -92,191 +279,196 @@ void main(void){
     LcdCursorMode(0, 0);
     CurState = DISARMED;
     PrevState = ARMED;
-    while(TRUE){
-        SysTickWaitEvent(SLICE_PERIOD);
-        KeyTask();
-        TSITask();
-        lab5ControlTask();
-        LEDTask();
-        AccelTask();
-        ClockTask();
-    }
+    if(SchedInit(lab5TaskTable, LAB5_NUM_TASKS) != 0){
+        /* SchedInit() reported why. No task would run, so never look armed */
+        LcdCursorMove(1, 1);
+        LcdDispString("SCHED TABLE");
+        WaveGenDMASetWave(StateWave[ALARM]);
+        WaveGenDMAEnable(1);
+        while(TRUE){
+            LED8_TOGGLE();
+            LED9_TOGGLE();
+            SysTickDelay(LAB5_HALT_MS);
+        }
+    } else{}
+    SchedRun();
 }
 
 /*******************************************************************************
 * lab5ControlTask() - PRIVATE
 *   parameter: none
 *   description: this function handles the user interface and controls the alarm
+*   from the zone masks, so zones are added in Zone.c and not here.
 *******************************************************************************/
 static void lab5ControlTask(void){
     INT8C key_char;
     INT8U mode;
+    INT32U active;
     DB2_TURN_ON();
+    active = ZoneGetActive();
+    key_char = CtrlKey;
+    CtrlKey = 0;
     switch(CurState){
     case DISARMED:
         mode = 0;
         if(PrevState == ARMED || PrevState == ALARM){
-            LED8_TURN_OFF();
-            LED9_TURN_OFF();
-            Led8Indi = 0;
-            Led9Indi = 0;
-            Counter1 = 0;
-            Counter2 = 0;
+            AlarmZones = 0;
+            EntryDlyOn = 0;
             LcdDispLineClear(1);
             LcdCursorMove(1, 1);
             LcdDispString("DISARMED");
             PrevState = DISARMED;
+            (void)EvtPost(EVT_STATE, EVT_PRIO_NORM, (INT32U)DISARMED);
             WaveGenDMAEnable(mode);
         } else{}
-        key_char = KeyGet();
         if(key_char == DC1){
             CurState = ARMED;
         } else{}
         if(key_char == DC3){
-            LcdDispLineClear(2);
-            LcdCursorMove(2, 1);
-            LcdDispHexWord((INT32U)MemCSumGet(START_ADDS,END_ADDS), 4);
+            CSumReq = 1;
         } else{}
         break;
     case ARMED:
         if(PrevState == DISARMED || PrevState == ALARM){
-            Counter1 = 0;
             LcdDispLineClear(1);
             LcdCursorMove(1, 1);
             LcdDispString("ARMED");
             PrevState = ARMED;
+            (void)EvtPost(EVT_STATE, EVT_PRIO_NORM, (INT32U)ARMED);
+            WaveGenDMASetWave(StateWave[ARMED]);
+            WaveGenDMAPlay(WAVE_PAT_CHIME);
+        } else{}
+        if((active & ZoneGetTypeMask(ZONE_INSTANT)) != 0){
+            AlarmZones |= active & ZoneGetTypeMask(ZONE_INSTANT);
+            CurState = ALARM;
+        } else{}
+        if((active & ZoneGetTypeMask(ZONE_DELAYED)) != 0){
+            AlarmZones |= active & ZoneGetTypeMask(ZONE_DELAYED);
+            if(EntryDlyOn == 0){
+                EntryDlyOn = 1;
+                EntryDlyStart = SysTickGetmsCount();
+                WaveGenDMASetWave(StateWave[ARMED]);
+                WaveGenDMAPlay(WAVE_PAT_PULSE);
+            } else{}
+        } else{}
+        if((EntryDlyOn == 1) && ((SysTickGetmsCount() - EntryDlyStart) >= ZONE_ENTRY_DLY_MS)){
+            CurState = ALARM;
         } else{}
-        key_char = KeyGet();
         if(key_char == DC4){
             CurState = DISARMED;
         } else{}
         if(key_char == DC3){
-            LcdDispLineClear(2);
-            LcdCursorMove(2, 1);
-            LcdDispHexWord((INT32U)MemCSumGet(START_ADDS,END_ADDS), 4);
+            CSumReq = 1;
         } else{}
         break;
     case ALARM:
         mode = 1;
         if(PrevState == ARMED || PrevState == DISARMED){
-            LED8_TURN_OFF();
-            LED9_TURN_OFF();
-            Counter1 = 0;
-            Counter2 = 0;
             LcdDispLineClear(1);
             LcdCursorMove(1, 1);
             LcdDispString("ALARM");
             PrevState = ALARM;
+            EntryDlyOn = 0;
+            (void)EvtPost(EVT_STATE, EVT_PRIO_NORM, (INT32U)ALARM);
+            WaveGenDMASetWave(StateWave[ALARM]);
             WaveGenDMAEnable(mode);
         } else{}
-        key_char = KeyGet();
+        AlarmZones |= active & (ZoneGetTypeMask(ZONE_INSTANT)|ZoneGetTypeMask(ZONE_DELAYED));
         if(key_char == DC4){
             CurState = DISARMED;
         } else{}
         if(key_char == DC3){
-            LcdDispLineClear(2);
-            LcdCursorMove(2, 1);
-            LcdDispHexWord((INT32U)MemCSumGet(START_ADDS,END_ADDS), 4);
+            CSumReq = 1;
         } else{}
         break;
     default:
         CurState = DISARMED;
         break;
     }
+    /* LLS stops the PIT, DMA and UART, so only sleep armed with nothing pending,
+     * no telemetry stream and every zone able to wake the part */
+    if((CurState == ARMED) && (PrevState == ARMED) && (EntryDlyOn == 0) && (active == 0) &&
+       (WaveGenDMAActive() == 0) && (TelemGetMask() == 0) &&
+       (((ZoneGetTypeMask(ZONE_INSTANT)|ZoneGetTypeMask(ZONE_DELAYED)|
+          ZoneGetTypeMask(ZONE_TAMPER)) & ~PwrGetWakeZones()) == 0)){
+        PwrSetSleepOk(1);
+    } else{
+        PwrSetSleepOk(0);
+    }
     DB2_TURN_OFF();
 }
 
+/*******************************************************************************
+* lab5CSumTask() - PRIVATE
+*   parameter: none
+*   description: checksum of the flash for the C key. A full MemCSumGet() takes
+*   tens of ms, so it is written as a coroutine that sums CSUM_BLOCK bytes and
+*   yields, then shows the result on line 2.
+*******************************************************************************/
+static void lab5CSumTask(void){
+    CO_BEGIN(&CSumCo);
+    CO_WAIT_UNTIL(&CSumCo, CSumReq != 0);
+    CSumReq = 0;
+    CSumBusy = 1;
+    CSumValid = 0;
+    CSumSum = 0;
+    CSumAddr = START_ADDS;
+    while(CSumAddr <= END_ADDS){
+        CSumSum = MemCSumAdd(CSumSum, CSumAddr, CSUM_BLOCK);
+        CSumAddr += CSUM_BLOCK;
+        CO_YIELD(&CSumCo);
+    }
+    CSumBusy = 0;
+    CSumValid = 1;
+    LcdDispLineClear(2);
+    LcdCursorMove(2, 1);
+    LcdDispHexWord((INT32U)CSumSum, 4);
+    CO_END(&CSumCo);
+}
+
+/*******************************************************************************
+* lab5EvtHandler() - PRIVATE
+*   parameter: evt - EVT_KEY or EVT_ZONE event
+*   description: event bus subscriber of the control task. Keys are saved for
+*   lab5ControlTask() and new tamper zones are shown on the LCD.
+*******************************************************************************/
+static void lab5EvtHandler(const EVT_T *evt){
+    INT32U tamper;
+    if(evt->type == EVT_KEY){
+        CtrlKey = (INT8C)evt->arg;
+    } else if(evt->type == EVT_ZONE){
+        tamper = evt->arg & ZoneGetTypeMask(ZONE_TAMPER);
+        if((tamper & ~PrevTamperZones) != 0){
+            LcdDispLineClear(2);
+            LcdCursorMove(2, 1);
+            LcdDispString("TAMPERING ALARM");
+        }else{}
+        PrevTamperZones = tamper;
+    } else{}
+}
+
 /*******************************************************************************
 * LEDTask() - PRIVATE
 *   parameter: none
-*   description: control the LEDs flashing
+*   description: selects the LED patterns for the current state. The flashing
+*   itself is done by the LED pattern engine so the LEDs are only touched when
+*   a pattern changes.
 *******************************************************************************/
 static void LEDTask(void){
-    INT16U cur_sense_flags;
+    INT32U active;
     DB4_TURN_ON();
-    cur_sense_flags = TSIGetSensorFlags();
+    active = ZoneGetActive();
     switch(CurState){
     case DISARMED:
-        Counter1++;
-        Counter2++;
-        if((cur_sense_flags & (1<<BRD_PAD1_CH)) != 0){
-            if(Counter1 <= 27){
-                LED8_TURN_ON();
-            } else if(Counter1 <= 49){
-                LED8_TURN_OFF();
-            } else if(Counter1 >= 50){
-                Counter1 = 0;
-            }
-        }else{
-            LED8_TURN_OFF();
-        }
-        if((cur_sense_flags & (1<<BRD_PAD2_CH)) != 0){
-            if(Counter2 <= 25){
-                LED9_TURN_ON();
-            } else{
-                LED9_TURN_OFF();
-                if(Counter2 >= 50){
-                    Counter2 = 0;
-                } else{}
-            }
-        } else{
-            LED9_TURN_OFF();
-        }
+        LedPatSet(((active & ZONE_MASK(ZONE_ID_PAD1)) != 0) ? LP_PAT_SLOW_BLINK : LP_PAT_OFF,
+                  ((active & ZONE_MASK(ZONE_ID_PAD2)) != 0) ? LP_PAT_SLOW_BLINK : LP_PAT_OFF);
         break;
     case ARMED:
-        if((cur_sense_flags & (1<<BRD_PAD1_CH)) != 0){
-            Led8Indi = 1;
-            CurState = ALARM;
-        }else{}
-        if((cur_sense_flags & (1<<BRD_PAD2_CH)) != 0){
-            Led9Indi = 1;
-            CurState = ALARM;
-        }else{}
-        Counter1++;
-        if(Counter1 <= 25){
-            LED8_TURN_ON();
-            LED9_TURN_OFF();
-        } else{
-            LED9_TURN_ON();
-            LED8_TURN_OFF();
-            if(Counter1 >= 50){
-                Counter1 = 0;
-            } else{}
-        }
+        LedPatSet(LP_PAT_SLOW_BLINK, LP_PAT_ALTERNATE);
         break;
     case ALARM:
-        if((cur_sense_flags & (1<<BRD_PAD1_CH)) != 0){
-            Led8Indi = 1;
-        }else{}
-        if((cur_sense_flags & (1<<BRD_PAD2_CH)) != 0){
-            Led9Indi = 1;
-        }else{}
-        if(Led8Indi == 1){
-            Counter1++;
-            if(Counter1 <= 5){
-                LED8_TURN_ON();
-            } else{
-                LED8_TURN_OFF();
-                if(Counter1 >= 10){
-                    Counter1 = 0;
-                } else{}
-            }
-        } else{
-            Counter1 = 0;
-        }
-        if(Led9Indi == 1){
-            Counter2++;
-            if(Counter2 <= 5){
-                LED9_TURN_ON();
-            } else{
-                LED9_TURN_OFF();
-                if(Counter2 >= 10){
-                    Counter2 = 0;
-                } else{}
-            }
-        } else{
-            Counter2 = 0;
-        }
+        LedPatSet(((AlarmZones & ZONE_MASK(ZONE_ID_PAD1)) != 0) ? LP_PAT_FAST_BLINK : LP_PAT_OFF,
+                  ((AlarmZones & ZONE_MASK(ZONE_ID_PAD2)) != 0) ? LP_PAT_FAST_BLINK : LP_PAT_OFF);
         break;
     default:
         CurState = DISARMED;
@@ -288,22 +480,636 @@ static void LEDTask(void){
 /*******************************************************************************
 * AccelTask() - PRIVATE
 *   parameter: none
-*   description: tampering notification using on-board accelerometer. detect
+*   description: tampering detection using on-board accelerometer. detect
 *   some form of movement that indicates that someone is tampering with the
-*   alarm system.
+*   alarm system, post it to the accelerometer zone source and post EVT_TILT
+*   when it changes.
 *******************************************************************************/
 static void AccelTask(void){
     INT8S x;
     INT8S y;
     INT8S z;
+    INT8U tilt;
     DB5_TURN_ON();
     x = (INT8S)MMA8451RegRd(MMA8451_OUT_X_MSB);
     y = (INT8S)MMA8451RegRd(MMA8451_OUT_Y_MSB);
     z = (INT8S)MMA8451RegRd(MMA8451_OUT_Z_MSB);
-    if(x >= 16 || y >= 16 || z <= 48){
-        LcdDispLineClear(2);
-        LcdCursorMove(2, 1);
-        LcdDispString("TAMPERING ALARM");
+    AccelRaw[0] = x;
+    AccelRaw[1] = y;
+    AccelRaw[2] = z;
+    if(x >= AccelXYLim || y >= AccelXYLim || z <= AccelZLim){
+        tilt = 1;
+    }else{
+        tilt = 0;
+    }
+    ZoneSrcPost(ZONE_SRC_ACCEL, (tilt == 1) ? ZONE_ACCEL_TILT : 0U);
+    if(tilt != AccelTilt){
+        AccelTilt = tilt;
+        (void)EvtPost(EVT_TILT, EVT_PRIO_HIGH, (INT32U)tilt);
     }else{}
     DB5_TURN_OFF();
 }
+
+/*******************************************************************************
+* lab5SensCmd() - PRIVATE
+*   parameter: step - command step, argc/argv - not used
+*   description: one line per step: each TSI pad, then the accelerometer
+*******************************************************************************/
+static INT8U lab5SensCmd(INT8U step, INT8U argc, INT8C *argv[]){
+    INT8U rval = SHELL_MORE;
+    INT8U ch;
+    if(step < 2U){
+        ch = (step == 0) ? BRD_PAD1_CH : BRD_PAD2_CH;
+        BIOPutStrg((step == 0) ? "tsi1" : "tsi2");
+        BIOPutStrg(" count ");
+        BIOOutHexHWord(TSIGetCount(ch));
+        BIOPutStrg(" base ");
+        BIOOutHexHWord(TSIGetBaseline(ch));
+        BIOPutStrg(" offset ");
+        BIOOutHexHWord(TSIGetOffset(ch));
+        BIOOutCRLF();
+    } else{
+        BIOPutStrg("accel x ");
+        BIOOutHexByte((INT8U)AccelRaw[0]);
+        BIOPutStrg(" y ");
+        BIOOutHexByte((INT8U)AccelRaw[1]);
+        BIOPutStrg(" z ");
+        BIOOutHexByte((INT8U)AccelRaw[2]);
+        BIOPutStrg(AccelTilt != 0 ? " tilted" : " level");
+        BIOOutCRLF();
+        rval = SHELL_DONE;
+    }
+    return rval;
+}
+
+/*******************************************************************************
+* lab5PwrCmd() - PRIVATE
+*   parameter: step - command step, argc/argv - not used
+*   description: one line per step: the zones that wake the part from LLS,
+*   the sleep counts, the wakeup sources, then the wakeup latency
+*******************************************************************************/
+static INT8U lab5PwrCmd(INT8U step, INT8U argc, INT8C *argv[]){
+    PWR_STATS_T stats;
+    INT8U rval = SHELL_MORE;
+    PwrGetStats(&stats);
+    if(step == 0){
+        BIOPutStrg("wake zones ");
+        BIOOutHexWord(PwrGetWakeZones());
+        BIOPutStrg(" of ");
+        BIOOutHexWord(ZoneGetTypeMask(ZONE_INSTANT)|ZoneGetTypeMask(ZONE_DELAYED)|
+                      ZoneGetTypeMask(ZONE_TAMPER));
+    } else if(step == 1U){
+        BIOPutStrg("sleeps ");
+        BIOOutDecWord(stats.sleeps, 1, BIO_OD_MODE_AL);
+        BIOPutStrg(" aborts ");
+        BIOOutDecWord(stats.aborts, 1, BIO_OD_MODE_AL);
+        BIOPutStrg(" slept ");
+        BIOOutDecWord(stats.slept_ms, 1, BIO_OD_MODE_AL);
+        BIOPutStrg("ms pad moves ");
+        BIOOutDecWord(stats.tsi_moves, 1, BIO_OD_MODE_AL);
+    } else if(step == 2U){
+        BIOPutStrg("wakes key ");
+        BIOOutDecWord(stats.wakes_key, 1, BIO_OD_MODE_AL);
+        BIOPutStrg(" accel ");
+        BIOOutDecWord(stats.wakes_accel, 1, BIO_OD_MODE_AL);
+        BIOPutStrg(" tsi ");
+        BIOOutDecWord(stats.wakes_tsi, 1, BIO_OD_MODE_AL);
+        BIOPutStrg(" timer ");
+        BIOOutDecWord(stats.wakes_timer, 1, BIO_OD_MODE_AL);
+    } else{
+        BIOPutStrg("latency last ");
+        BIOOutDecWord(stats.last_lat_us, 1, BIO_OD_MODE_AL);
+        BIOPutStrg("us max ");
+        BIOOutDecWord(stats.max_lat_us, 1, BIO_OD_MODE_AL);
+        BIOPutStrg("us");
+        rval = SHELL_DONE;
+    }
+    BIOOutCRLF();
+    return rval;
+}
+
+/*******************************************************************************
+* lab5CSumCmd() - PRIVATE
+*   parameter: step - not used, argc/argv - 'run' starts a checksum
+*   description: starts a checksum or shows its progress or result
+*******************************************************************************/
+static INT8U lab5CSumCmd(INT8U step, INT8U argc, INT8C *argv[]){
+    if((argc > 1U) && (ShellStrEq(argv[1], "run") != 0)){
+        CSumReq = 1;
+        BIOPutStrg("started");
+    } else if(CSumBusy != 0){
+        BIOPutStrg("running, at ");
+        BIOOutHexWord((INT32U)CSumAddr);
+    } else if(CSumValid != 0){
+        BIOPutStrg("sum ");
+        BIOOutHexHWord(CSumSum);
+    } else{
+        BIOPutStrg("no checksum since reset, boot sum on the LCD");
+    }
+    BIOOutCRLF();
+    return SHELL_DONE;
+}
+
+/*******************************************************************************
+* lab5CfgCmd() - PRIVATE
+*   parameter: step - setting listed, argc/argv - name and hex value to set
+*   description: lists one setting per step, or sets one
+*******************************************************************************/
+static INT8U lab5CfgCmd(INT8U step, INT8U argc, INT8C *argv[]){
+    INT8U rval = SHELL_DONE;
+    INT32U val;
+    CFG_T cfg;
+    if(argc == 1U){
+        if(step < (INT8U)CFG_NUM){
+            BIOPutStrg(CfgNames[step]);
+            BIOWrite(' ');
+            BIOOutHexWord(lab5CfgGet((CFG_T)step));
+            BIOOutCRLF();
+            rval = SHELL_MORE;
+        } else{}
+    } else{
+        cfg = CFG_NUM;
+        for(val = 0; val < (INT32U)CFG_NUM; val++){
+            if(ShellStrEq(argv[1], CfgNames[val]) != 0){
+                cfg = (CFG_T)val;
+            } else{}
+        }
+        if(cfg == CFG_NUM){
+            BIOPutStrg("unknown setting: ");
+            BIOPutStrg(argv[1]);
+            BIOOutCRLF();
+        } else if(ShellArgHex((argc > 2U) ? argv[2] : (INT8C *)0, &val) != 0){
+            /* ShellArgHex() reported it */
+        } else if(lab5CfgSet(cfg, val) != 0){
+            BIOPutStrg("out of range");
+            BIOOutCRLF();
+        } else{
+            BIOPutStrg(CfgNames[cfg]);
+            BIOWrite(' ');
+            BIOOutHexWord(lab5CfgGet(cfg));
+            BIOOutCRLF();
+        }
+    }
+    return rval;
+}
+
+/*******************************************************************************
+* lab5CfgGet() - PRIVATE
+*   parameter: cfg - setting
+*   description: returns the current value of a setting
+*******************************************************************************/
+static INT32U lab5CfgGet(CFG_T cfg){
+    INT32U val;
+    switch(cfg){
+    case CFG_TSI1:
+        val = TSIGetOffset(BRD_PAD1_CH);
+        break;
+    case CFG_TSI2:
+        val = TSIGetOffset(BRD_PAD2_CH);
+        break;
+    case CFG_AXY:
+        val = (INT32U)AccelXYLim;
+        break;
+    case CFG_AZ:
+        val = (INT32U)AccelZLim;
+        break;
+    case CFG_SLICE:
+        val = SchedGetSliceMs();
+        break;
+    default:
+        val = 0;
+        break;
+    }
+    return val;
+}
+
+/*******************************************************************************
+* lab5CfgSet() - PRIVATE
+*   parameter: cfg - setting
+*              val - new value
+*   description: changes a setting. TSI offsets are counts over the baseline,
+*   accelerometer limits are 1/64g counts and the slice must divide every task
+*   period. Returns 0 if set, 1 if out of range.
+*******************************************************************************/
+static INT8U lab5CfgSet(CFG_T cfg, INT32U val){
+    INT8U rval = 0;
+    switch(cfg){
+    case CFG_TSI1:
+    case CFG_TSI2:
+        if((val == 0) || (val > 0xFFFFU)){
+            rval = 1;
+        } else{
+            TSISetOffset((cfg == CFG_TSI1) ? BRD_PAD1_CH : BRD_PAD2_CH, (INT16U)val);
+        }
+        break;
+    case CFG_AXY:
+        if((val == 0) || (val > 0x7FU)){
+            rval = 1;
+        } else{
+            AccelXYLim = (INT8S)val;
+        }
+        break;
+    case CFG_AZ:
+        if(val > 0x7FU){
+            rval = 1;
+        } else{
+            AccelZLim = (INT8S)val;
+        }
+        break;
+    case CFG_SLICE:
+        if(val > 0xFFFFU){
+            rval = 1;
+        } else{
+            rval = SchedSetSliceMs((INT16U)val);
+        }
+        break;
+    default:
+        rval = 1;
+        break;
+    }
+    return rval;
+}
+
+/*******************************************************************************
+* lab5TelemCmd() - PRIVATE
+*   parameter: step - not used, argc/argv - optional hex channel mask
+*   description: sets the telemetry channel mask or shows the stream status
+*******************************************************************************/
+static INT8U lab5TelemCmd(INT8U step, INT8U argc, INT8C *argv[]){
+    INT32U mask;
+    TELEM_STATS_T stats;
+    if(argc > 1U){
+        if(ShellArgHex(argv[1], &mask) == 0){
+            TelemSetMask((INT8U)mask);
+        } else{}
+    } else{}
+    TelemGetStats(&stats);
+    BIOPutStrg("mask ");
+    BIOOutHexByte(TelemGetMask());
+    BIOPutStrg(" frames ");
+    BIOOutDecWord(stats.frames, 10, BIO_OD_MODE_AL);
+    BIOPutStrg(" dropped ");
+    BIOOutDecWord(stats.dropped, 10, BIO_OD_MODE_AL);
+    BIOOutCRLF();
+    return SHELL_DONE;
+}
+
+/*******************************************************************************
+* lab5SirenCmd() - PRIVATE
+*   parameter: step - not used, argc/argv - optional siren number
+*   description: selects the siren tone or shows the selected one
+*******************************************************************************/
+static INT8U lab5SirenCmd(INT8U step, INT8U argc, INT8C *argv[]){
+    INT32U siren;
+    if(argc > 1U){
+        if(ShellArgHex(argv[1], &siren) != 0){
+            /* ShellArgHex() reported it */
+        } else if(siren >= (INT32U)WAVE_SIREN_NUM){
+            BIOPutStrg("no such siren");
+            BIOOutCRLF();
+        } else{
+            WaveGenDMASetSiren((WAVE_SIREN_T)siren);
+        }
+    } else{}
+    BIOPutStrg("siren ");
+    BIOOutDecWord((INT32U)WaveGenDMAGetSiren(), 1, BIO_OD_MODE_AL);
+    BIOOutCRLF();
+    return SHELL_DONE;
+}
+
+/*******************************************************************************
+* lab5WaveCmd() - PRIVATE
+*   parameter: step - one state per step
+*              argc/argv - optional state number and waveform number
+*   description: sets the waveform of a state, then lists every state with
+*   its waveform. The change is used the next time the sound starts.
+*******************************************************************************/
+static INT8U lab5WaveCmd(INT8U step, INT8U argc, INT8C *argv[]){
+    INT32U state;
+    INT32U wave;
+    INT8U rval = SHELL_MORE;
+    if((step == 0) && (argc > 2U)){
+        if((ShellArgHex(argv[1], &state) != 0) || (ShellArgHex(argv[2], &wave) != 0)){
+            /* ShellArgHex() reported it */
+        } else if((state == (INT32U)DISARMED) || (state > (INT32U)ALARM) ||
+                  (wave >= (INT32U)WAVE_TBL_NUM)){
+            BIOPutStrg("no such state or waveform");
+            BIOOutCRLF();
+        } else{
+            StateWave[state] = (WAVE_TBL_T)wave;
+        }
+    } else{}
+    if(step < (INT8U)ALARM){
+        BIOOutDecWord((INT32U)step + 1U, 1, BIO_OD_MODE_AL);
+        BIOWrite(' ');
+        BIOPutStrg(StateNames[step + 1U]);
+        BIOPutStrg(" - ");
+        BIOOutDecWord((INT32U)StateWave[step + 1U], 1, BIO_OD_MODE_AL);
+        BIOWrite(' ');
+        BIOPutStrg(WaveBankGet(StateWave[step + 1U])->name);
+        BIOOutCRLF();
+    } else{
+        rval = SHELL_DONE;
+    }
+    return rval;
+}
+
+/*******************************************************************************
+* lab5VolCmd() - PRIVATE
+*   parameter: step - not used, argc/argv - optional hex volume
+*   description: sets the siren and clip volume or shows it
+*******************************************************************************/
+static INT8U lab5VolCmd(INT8U step, INT8U argc, INT8C *argv[]){
+    INT32U vol;
+    if(argc > 1U){
+        if(ShellArgHex(argv[1], &vol) != 0){
+            /* ShellArgHex() reported it */
+        } else if(vol > WAVE_VOL_MAX){
+            BIOPutStrg("volume out of range");
+            BIOOutCRLF();
+        } else{
+            WaveGenDMASetVolume((INT8U)vol);
+        }
+    } else{}
+    BIOPutStrg("vol ");
+    BIOOutHexByte(WaveGenDMAGetVolume());
+    BIOOutCRLF();
+    return SHELL_DONE;
+}
+
+/*******************************************************************************
+* lab5AudioCmd() - PRIVATE
+*   parameter: step - command step
+*              argc/argv - optional backend number, or test
+*   description: selects the sound output backend or shows it. Test runs
+*   WaveGenDMATestStep() and prints the CPU cycles per sample of each
+*   backend. Both stop the output, so they are only taken when disarmed.
+*******************************************************************************/
+static INT8U lab5AudioCmd(INT8U step, INT8U argc, INT8C *argv[]){
+    INT32U be;
+    INT8U rval = SHELL_DONE;
+    if((argc > 1U) && (step == 0) && (lab5SoundFree() == 0)){
+        /* lab5SoundFree() reported it */
+    } else if((argc > 1U) && (ShellStrEq(argv[1], "test") != 0)){
+        if(WaveGenDMATestStep(step, WAVE_TEST_SIREN, AudioProf) != 0){
+            rval = SHELL_MORE;
+        } else{
+            for(be = 0; be < (INT32U)WAVE_BE_NUM; be++){
+                BIOPutStrg(AudioNames[be]);
+                BIOWrite(' ');
+                lab5ProfPrint((WAVE_BE_T)be);
+                BIOOutCRLF();
+            }
+            lab5SoundRestore();
+        }
+    } else{
+        if(argc > 1U){
+            if(ShellArgHex(argv[1], &be) != 0){
+                /* ShellArgHex() reported it */
+            } else if(be >= (INT32U)WAVE_BE_NUM){
+                BIOPutStrg("no such backend");
+                BIOOutCRLF();
+            } else{
+                WaveGenDMASetBackend((WAVE_BE_T)be);
+            }
+        } else{}
+        BIOPutStrg("audio ");
+        BIOPutStrg(AudioNames[WaveGenDMAGetBackend()]);
+        BIOOutCRLF();
+    }
+    return rval;
+}
+
+/*******************************************************************************
+* lab5BenchCmd() - PRIVATE
+*   parameter: step - command step
+*              argc/argv - not used
+*   description: shows where the SysTick, PIT0 and DMA handlers run from, as
+*   the vector table has them, 1FFF.... with APP_RAMFUNC_EN 1 and 0000....
+*   with 0, then the longest SysTick entry latency and run time since the last
+*   bench, and runs the backend self-test on the siren, then on clip 0, for
+*   the longest audio handler run and PIT0 entry latency. The clip is
+*   decoded in the DMA interrupt, so it covers the clip path of wgdNext().
+*   Build with APP_RAMFUNC_EN 1 and 0 to compare the SRAM_L and flash runs.
+*   All in CPU cycles. The self-test stops the output, so bench is only taken
+*   when disarmed.
+*******************************************************************************/
+static INT8U lab5BenchCmd(INT8U step, INT8U argc, INT8C *argv[]){
+    INT8U rval = SHELL_DONE;
+    (void)argc;
+    (void)argv;
+    if((step == 0U) && (lab5SoundFree() == 0)){
+        /* lab5SoundFree() reported it */
+    } else{
+        rval = lab5BenchStep(step);
+    }
+    return rval;
+}
+
+/*******************************************************************************
+* lab5BenchStep() - PRIVATE
+*   parameter: step - command step
+*   description: one step of lab5BenchCmd(), returns SHELL_MORE or SHELL_DONE
+*******************************************************************************/
+static INT8U lab5BenchStep(INT8U step){
+    INT32U be;
+    INT32U lat;
+    INT32U cyc;
+    INT8U rval = SHELL_MORE;
+    if(step == 0U){
+        BenchSound = WAVE_TEST_SIREN;
+        BenchNew = 1;
+        lab5VectPrint("systick ", (INT32U)SysTick_IRQn + 16U);
+        lab5VectPrint("pit0    ", (INT32U)PIT0_IRQn + 16U);
+        lab5VectPrint("dma     ", (INT32U)WAVE_DMA_IRQn + 16U);
+        SysTickGetIsrMax(&lat, &cyc);
+        BIOPutStrg("systick lat ");
+        BIOOutDecWord(lat, 1, BIO_OD_MODE_AL);
+        BIOPutStrg(" run ");
+        BIOOutDecWord(cyc, 1, BIO_OD_MODE_AL);
+        BIOOutCRLF();
+    } else{}
+    if(WaveGenDMATestStep((BenchNew != 0U) ? 0U : 1U, BenchSound, AudioProf) != 0){
+        BenchNew = 0;
+    } else{
+        if(BenchSound == WAVE_TEST_SIREN){
+            BIOPutStrg("siren");
+        } else{
+            BIOPutStrg("clip ");
+            BIOPutStrg(SoundClipGet(BenchSound)->name);
+        }
+        BIOOutCRLF();
+        for(be = 0; be < (INT32U)WAVE_BE_NUM; be++){
+            BIOPutStrg(AudioNames[be]);
+            BIOPutStrg(" lat ");
+            BIOOutDecWord(AudioProf[be].lat_max, 1, BIO_OD_MODE_AL);
+            BIOPutStrg(" run ");
+            BIOOutDecWord(AudioProf[be].cyc_max, 1, BIO_OD_MODE_AL);
+            BIOWrite(' ');
+            lab5ProfPrint((WAVE_BE_T)be);
+            BIOOutCRLF();
+        }
+        if((BenchSound == WAVE_TEST_SIREN) && (SoundClipGet(0) != (const SOUND_CLIP_T *)0)){
+            BenchSound = 0;
+            BenchNew = 1;
+        } else{
+            lab5SoundRestore();
+            rval = SHELL_DONE;
+        }
+    }
+    return rval;
+}
+
+/*******************************************************************************
+* lab5ProfPrint() - PRIVATE
+*   parameter: be - backend of AudioProf[]
+*   description: prints the CPU cycles per sample of a backend, one decimal
+*******************************************************************************/
+static void lab5ProfPrint(WAVE_BE_T be){
+    INT32U tenths;
+    tenths = (AudioProf[be].samples != 0) ?
+             ((AudioProf[be].cycles * 10U) / AudioProf[be].samples) : 0;
+    BIOOutDecWord(tenths / 10U, 1, BIO_OD_MODE_AL);
+    BIOWrite('.');
+    BIOOutDecWord(tenths % 10U, 1, BIO_OD_MODE_AL);
+    BIOPutStrg(" cycles/sample");
+}
+
+/*******************************************************************************
+* lab5VectPrint() - PRIVATE
+*   parameter: name - handler name, padded
+*              exc - exception number
+*   description: prints the handler address of the active vector table
+*******************************************************************************/
+static void lab5VectPrint(const INT8C *const name, INT32U exc){
+    BIOPutStrg(name);
+    BIOOutHexWord(((const INT32U *)SCB->VTOR)[exc]);
+    BIOOutCRLF();
+}
+
+/*******************************************************************************
+* lab5ClipCmd() - PRIVATE
+*   parameter: step - command step
+*              argc/argv - optional clip number to play, or check
+*   description: plays a clip when disarmed, then lists one clip per step.
+*   With check each clip is decoded with AdpcmDecode() one block per step and
+*   the CRC of the samples compared with the one tools/adpcm_encode.py stored,
+*   so the decoder is checked bit for bit against the host one.
+*******************************************************************************/
+static INT8U lab5ClipCmd(INT8U step, INT8U argc, INT8C *argv[]){
+    INT32U clip;
+    INT16U num;
+    INT16S pcm[WAVE_SAMPLES_PER_BLOCK];
+    const SOUND_CLIP_T *sound;
+    INT8U check = ((argc > 1U) && (ShellStrEq(argv[1], "check") != 0)) ? 1U : 0U;
+    INT8U rval = SHELL_MORE;
+    if(step == 0){
+        ClipNum = 0;
+        ClipPos = 0;
+        if((argc > 1U) && (check == 0)){
+            if(ShellArgHex(argv[1], &clip) != 0){
+                /* ShellArgHex() reported it */
+            } else if(lab5SoundFree() == 0){
+                /* lab5SoundFree() reported it */
+            } else if((clip > 0xFFU) || (WaveGenDMAPlayClip((INT8U)clip) != 0)){
+                BIOPutStrg("no such clip");
+                BIOOutCRLF();
+            } else{}
+        } else{}
+    } else{}
+    sound = SoundClipGet(ClipNum);
+    if(sound == (const SOUND_CLIP_T *)0){
+        rval = SHELL_DONE;
+    } else{
+        if(ClipPos == 0U){
+            BIOOutDecWord((INT32U)ClipNum, 1, BIO_OD_MODE_AL);
+            BIOWrite(' ');
+            BIOPutStrg(sound->name);
+            BIOWrite(' ');
+            BIOOutDecWord(sound->samples, 1, BIO_OD_MODE_AL);
+            BIOPutStrg(" samples ");
+            BIOOutDecWord(sound->rate, 1, BIO_OD_MODE_AL);
+            BIOPutStrg("Hz");
+            ClipState.pred = sound->pred;
+            ClipState.index = sound->index;
+            ClipCrc = MEM_CRC16_INIT;
+        } else{}
+        if(check != 0){
+            num = ((sound->samples - ClipPos) > WAVE_SAMPLES_PER_BLOCK) ?
+                  WAVE_SAMPLES_PER_BLOCK : (INT16U)(sound->samples - ClipPos);
+            AdpcmDecode(&ClipState, sound->data, ClipPos, num, pcm);
+            ClipCrc = MemCrc16(ClipCrc, (const INT8U *)pcm, (INT32U)num * sizeof(pcm[0]));
+            ClipPos += num;
+        } else{
+            ClipPos = sound->samples;
+        }
+        if(ClipPos >= sound->samples){
+            if(check != 0){
+                BIOPutStrg((ClipCrc == sound->crc) ? " ok" : " FAIL");
+            } else{}
+            BIOOutCRLF();
+            ClipNum++;
+            ClipPos = 0;
+        } else{}
+    }
+    return rval;
+}
+
+/*******************************************************************************
+* lab5SoundFree() - PRIVATE
+*   parameter: none
+*   description: returns 1 if a shell command may take the sound output,
+*   which is only when disarmed so the entry delay and alarm sounds are never
+*   cut. Prints why not and returns 0 if not.
+*******************************************************************************/
+static INT8U lab5SoundFree(void){
+    INT8U rval = 1;
+    if(CurState != DISARMED){
+        BIOPutStrg("disarm first");
+        BIOOutCRLF();
+        rval = 0;
+    } else{}
+    return rval;
+}
+
+/*******************************************************************************
+* lab5SoundRestore() - PRIVATE
+*   parameter: none
+*   description: starts the sound of the state again after a shell command
+*   that took the output, in case the state changed while it ran
+*******************************************************************************/
+static void lab5SoundRestore(void){
+    if(CurState == ALARM){
+        WaveGenDMASetWave(StateWave[ALARM]);
+        WaveGenDMAEnable(1);
+    } else if((CurState == ARMED) && (EntryDlyOn != 0)){
+        WaveGenDMASetWave(StateWave[ARMED]);
+        WaveGenDMAPlay(WAVE_PAT_PULSE);
+    } else{}
+}
+
+/*******************************************************************************
+* lab5TelemTsi1() ... lab5TelemAccZ() - PRIVATE
+*   parameter: none
+*   description: telemetry channel readers. TSI counts are unsigned and the
+*   accelerometer values are the signed MSBs read by AccelTask().
+*******************************************************************************/
+static INT16S lab5TelemTsi1(void){
+    return (INT16S)TSIGetCount(BRD_PAD1_CH);
+}
+
+static INT16S lab5TelemTsi2(void){
+    return (INT16S)TSIGetCount(BRD_PAD2_CH);
+}
+
+static INT16S lab5TelemAccX(void){
+    return (INT16S)AccelRaw[0];
+}
+
+static INT16S lab5TelemAccY(void){
+    return (INT16S)AccelRaw[1];
+}
+
+static INT16S lab5TelemAccZ(void){
+    return (INT16S)AccelRaw[2];
+}
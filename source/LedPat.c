@@ -0,0 +1,162 @@
+/*******************************************************************************
+* LedPat.c
+*
+* This module contains an LED pattern engine for LED8 (PTA28) and LED9 (PTA29).
+* A one second table of port states is rendered in RAM and DMA ch1 writes one
+* entry to the upper byte of GPIOA->PDOR every 1ms on the PIT1 trigger. The
+* CPU only touches the LEDs when a pattern changes.
+* Note: the byte write also sets the output latch of PTA24-PTA31, so none of
+* those pins may be used as GPIO outputs.
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+/*******************************************************************************
+* Includes
+*******************************************************************************/
+#include "MCUType.h"
+#include "K65TWR_GPIO.h"
+#include "LedPat.h"
+
+/*******************************************************************************
+* Private Resources
+*******************************************************************************/
+typedef struct{
+    INT16U period;      /* steps per blink cycle, must divide LP_TABLE_LEN */
+    INT16U on;          /* steps the LED is on in each cycle */
+    INT16U phase;       /* step offset of the cycle */
+    INT8U breathe;      /* 1 to ramp the brightness up and down instead */
+}LP_PAT_DESC_T;
+
+#define LP_PORT_BYTE    ((volatile INT8U *)&GPIOA->PDOR + 3)
+#define LP_LED8_MASK    (INT8U)(1U << (LED8_BIT - 24U))
+#define LP_LED9_MASK    (INT8U)(1U << (LED9_BIT - 24U))
+
+static const LP_PAT_DESC_T lpPatTable[LP_PAT_NUM] = {
+    {LP_TABLE_LEN, 0,            0,   0},   /* LP_PAT_OFF */
+    {LP_TABLE_LEN, LP_TABLE_LEN, 0,   0},   /* LP_PAT_STEADY */
+    {500,          250,          0,   0},   /* LP_PAT_SLOW_BLINK */
+    {500,          250,          250, 0},   /* LP_PAT_ALTERNATE */
+    {100,          50,           0,   0},   /* LP_PAT_FAST_BLINK */
+    {LP_TABLE_LEN, 0,            0,   1}    /* LP_PAT_BREATHE */
+};
+
+static INT8U lpTable[LP_TABLE_LEN];
+static LP_PAT_T lpLed8Pat;
+static LP_PAT_T lpLed9Pat;
+
+static INT8U lpIsOn(LP_PAT_T pat, INT16U step);
+static void lpRender(void);
+
+/******************************************************************************
+* Function Code
+******************************************************************************/
+
+/*******************************************************************************
+* lpIsOn() - PRIVATE
+*   parameter: pat - pattern to evaluate
+*              step - table step, 0 to LP_TABLE_LEN-1
+*   description: returns 1 if the LED is on at step for pattern pat
+*******************************************************************************/
+static INT8U lpIsOn(LP_PAT_T pat, INT16U step){
+    const LP_PAT_DESC_T *desc = &lpPatTable[pat];
+    INT16U frame;
+    INT16U level;
+    INT8U on;
+    if(desc->breathe == 1){
+        /* triangle of PWM levels 0-10 over the cycle */
+        frame = step / LP_PWM_FRAME;
+        if(frame >= (LP_TABLE_LEN / LP_PWM_FRAME / 2)){
+            frame = (LP_TABLE_LEN / LP_PWM_FRAME) - 1 - frame;
+        } else{}
+        level = (INT16U)((frame * (LP_PWM_FRAME + 1)) / (LP_TABLE_LEN / LP_PWM_FRAME / 2));
+        on = ((step % LP_PWM_FRAME) < level) ? 1U : 0U;
+    } else{
+        on = (((step + desc->period - desc->phase) % desc->period) < desc->on) ? 1U : 0U;
+    }
+    return on;
+}
+
+/*******************************************************************************
+* lpRender() - PRIVATE
+*   parameter: none
+*   description: stops DMA ch1, rebuilds lpTable[] from the current patterns
+*   and restarts the table from the first step. LEDs are active-low.
+*******************************************************************************/
+static void lpRender(void){
+    INT16U step;
+    INT8U port;
+    DMA0->CERQ = DMA_CERQ_CERQ(LP_DMA_CH);
+    while((DMA0->TCD[LP_DMA_CH].CSR & DMA_CSR_ACTIVE_MASK) != 0){}
+    for(step = 0; step < LP_TABLE_LEN; step++){
+        port = LP_LED8_MASK | LP_LED9_MASK;
+        if(lpIsOn(lpLed8Pat, step) == 1){
+            port &= (INT8U)~LP_LED8_MASK;
+        } else{}
+        if(lpIsOn(lpLed9Pat, step) == 1){
+            port &= (INT8U)~LP_LED9_MASK;
+        } else{}
+        lpTable[step] = port;
+    }
+    DMA0->TCD[LP_DMA_CH].SADDR = DMA_SADDR_SADDR(lpTable);
+    DMA0->TCD[LP_DMA_CH].CITER_ELINKNO = DMA_CITER_ELINKNO_ELINK(0)|
+                                         DMA_CITER_ELINKNO_CITER(LP_TABLE_LEN);
+    DMA0->SERQ = DMA_SERQ_SERQ(LP_DMA_CH);
+}
+
+/*******************************************************************************
+* LedPatInit() - PUBLIC
+*   parameter: none
+*   description: Initialization of PIT1 and DMA ch1 so a pattern table is
+*   streamed to LED8 (PTA28) and LED9 (PTA29) with no CPU involvement. The
+*   LEDs must be initialized with GpioLED8Init() and GpioLED9Init() first.
+*******************************************************************************/
+void LedPatInit(void){
+    SIM->SCGC6 |= SIM_SCGC6_DMAMUX_MASK;
+    SIM->SCGC7 |= SIM_SCGC7_DMA_MASK;
+    SIM->SCGC6 |= SIM_SCGC6_PIT(1); //Turn on PIT clock
+    PIT->MCR = PIT_MCR_MDIS(0);     //Enable PIT clock
+
+    DMAMUX->CHCFG[LP_DMA_CH] = 0;
+    DMA0->TCD[LP_DMA_CH].SADDR = DMA_SADDR_SADDR(lpTable);
+    DMA0->TCD[LP_DMA_CH].ATTR = DMA_ATTR_SMOD(0) | DMA_ATTR_SSIZE(0)
+                              | DMA_ATTR_DMOD(0) | DMA_ATTR_DSIZE(0);
+    DMA0->TCD[LP_DMA_CH].SOFF = DMA_SOFF_SOFF(1);
+    DMA0->TCD[LP_DMA_CH].SLAST = DMA_SLAST_SLAST(-(LP_TABLE_LEN));
+    DMA0->TCD[LP_DMA_CH].DADDR = DMA_DADDR_DADDR(LP_PORT_BYTE);
+    DMA0->TCD[LP_DMA_CH].DOFF = DMA_DOFF_DOFF(0);
+    DMA0->TCD[LP_DMA_CH].DLAST_SGA = DMA_DLAST_SGA_DLASTSGA(0);
+    DMA0->TCD[LP_DMA_CH].NBYTES_MLNO = DMA_NBYTES_MLNO_NBYTES(1);
+    DMA0->TCD[LP_DMA_CH].CITER_ELINKNO = DMA_CITER_ELINKNO_ELINK(0)|
+                                         DMA_CITER_ELINKNO_CITER(LP_TABLE_LEN);
+    DMA0->TCD[LP_DMA_CH].BITER_ELINKNO = DMA_BITER_ELINKNO_ELINK(0)|
+                                         DMA_BITER_ELINKNO_BITER(LP_TABLE_LEN);
+    DMA0->TCD[LP_DMA_CH].CSR = DMA_CSR_ESG(0) | DMA_CSR_MAJORELINK(0) |
+                               DMA_CSR_BWC(3) | DMA_CSR_INTHALF(0) |
+                               DMA_CSR_INTMAJOR(0) | DMA_CSR_DREQ(0) |
+                               DMA_CSR_START(0);
+    lpLed8Pat = LP_PAT_OFF;
+    lpLed9Pat = LP_PAT_OFF;
+    lpRender();
+    DMAMUX->CHCFG[LP_DMA_CH] = DMAMUX_CHCFG_ENBL(1)|DMAMUX_CHCFG_TRIG(1)|DMAMUX_CHCFG_SOURCE(61);
+
+    PIT->CHANNEL[1].LDVAL = 59999;  //set Tstep to 1ms (Bus clock = 60MHz)
+    PIT->CHANNEL[1].TCTRL = PIT_TCTRL_TEN(1);   //DMA trigger only, no interrupt
+}
+
+/*******************************************************************************
+* LedPatSet(LP_PAT_T led8, LP_PAT_T led9) - PUBLIC
+*   parameter: led8 - pattern for LED8
+*              led9 - pattern for LED9
+*   description: Selects the patterns of both LEDs. The pattern table is only
+*   rebuilt when a pattern changes, so this can be called every slice.
+*******************************************************************************/
+void LedPatSet(LP_PAT_T led8, LP_PAT_T led9){
+    if((led8 < LP_PAT_NUM) && (led9 < LP_PAT_NUM)){
+        if((led8 != lpLed8Pat) || (led9 != lpLed9Pat)){
+            lpLed8Pat = led8;
+            lpLed9Pat = led9;
+            lpRender();
+        } else{}
+    } else{}
+}
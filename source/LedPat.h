@@ -0,0 +1,52 @@
+/*******************************************************************************
+* LedPat.h
+*
+* This module contains all function prototypes and pattern IDs for LedPat.c
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+#ifndef LEDPATH
+#define LEDPATH
+
+/*******************************************************************************
+* Definition of LED pattern engine macros/constants
+*******************************************************************************/
+#define LP_DMA_CH               1       /* DMA ch1 is triggered by PIT1 */
+#define LP_STEP_MS              1       /* time of one table step */
+#define LP_TABLE_LEN            1000    /* steps in one pattern cycle (1s) */
+#define LP_PWM_FRAME            10      /* steps per PWM frame for breathing */
+
+/*******************************************************************************
+* LED patterns. Each pattern is described by an entry in lpPatTable[] in
+* LedPat.c, so new patterns are added there as data.
+*******************************************************************************/
+typedef enum {
+    LP_PAT_OFF,
+    LP_PAT_STEADY,
+    LP_PAT_SLOW_BLINK,
+    LP_PAT_ALTERNATE,       /* slow blink, 180 degrees out of phase */
+    LP_PAT_FAST_BLINK,
+    LP_PAT_BREATHE,
+    LP_PAT_NUM
+} LP_PAT_T;
+
+/*******************************************************************************
+* LedPatInit() - PUBLIC
+*   parameter: none
+*   description: Initialization of PIT1 and DMA ch1 so a pattern table is
+*   streamed to LED8 (PTA28) and LED9 (PTA29) with no CPU involvement. The
+*   LEDs must be initialized with GpioLED8Init() and GpioLED9Init() first.
+*******************************************************************************/
+void LedPatInit(void);
+
+/*******************************************************************************
+* LedPatSet(LP_PAT_T led8, LP_PAT_T led9) - PUBLIC
+*   parameter: led8 - pattern for LED8
+*              led9 - pattern for LED9
+*   description: Selects the patterns of both LEDs. The pattern table is only
+*   rebuilt when a pattern changes, so this can be called every slice.
+*******************************************************************************/
+void LedPatSet(LP_PAT_T led8, LP_PAT_T led9);
+
+#endif
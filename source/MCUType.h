@@ -5,6 +5,7 @@
 * TDM 10/04/2017 Initial version to deprecate includes.h
 * TDM 09/10/2018 Deprecated INT8C. Not needed for C99, MISRA, or MCUXpresso
 *                Added C99 type option.
+* KL  10/19/2026 Added RAMFUNC and RAMDATA for SRAM_L placement
 **********************************************************************************
 * Make sure it is included only one time 
 **********************************************************************************/
@@ -16,6 +17,26 @@
  *********************************************************************************/
 #include "MK65F18.h"
 #define ARM_MATH_CM4
+/*********************************************************************************
+ * SRAM_L placement. SRAM_L is the 64KB of RAM on the code bus, RAMFUNC code runs
+ * from it with no flash wait states and RAMDATA tables are read with no flash
+ * cache misses. Opt in per function or table. The managed linker script puts
+ * .ramfunc.$SRAM_LOWER and .data.$SRAM_LOWER in .data_RAM2, which has an entry in
+ * the Global Section Table, so ResetISR() copies it from flash with data_init().
+ * Not for code run before that, like SystemInit(). Calls between flash and
+ * SRAM_L are out of BL range and go through linker veneers. APP_RAMFUNC_EN 0
+ * leaves everything in flash, to compare.
+ ********************************************************************************/
+#define APP_RAMFUNC_EN      1
+
+#if APP_RAMFUNC_EN
+#define RAMFUNC     __attribute__((noinline, section(".ramfunc.$SRAM_LOWER")))
+#define RAMDATA     __attribute__((section(".data.$SRAM_LOWER")))
+#else
+#define RAMFUNC
+#define RAMDATA
+#endif
+
 /*********************************************************************************
  * Standard types to include
  ********************************************************************************/
@@ -19,3 +19,39 @@ INT16U MemCSumGet(INT8U *startaddr, INT8U *endaddr) {
     sum += (INT16U)*addr_ptr;
     return sum;
 }
+
+/*******************************************************************************
+* MemCSumAdd() adds len bytes from startaddr to a running sum, so a checksum
+* can be done a block at a time
+*******************************************************************************/
+INT16U MemCSumAdd(INT16U sum, INT8U *startaddr, INT32U len) {
+    INT8U *addr_ptr = startaddr;
+    while (len > 0) {
+        sum += (INT16U)*addr_ptr;
+        addr_ptr++;
+        len--;
+    }
+    return sum;
+}
+
+/*******************************************************************************
+* MemCrc16() adds len bytes from startaddr to a running CRC-16/CCITT. Bitwise,
+* so it is slow for large blocks but needs no table.
+*******************************************************************************/
+INT16U MemCrc16(INT16U crc, const INT8U *startaddr, INT32U len) {
+    const INT8U *addr_ptr = startaddr;
+    INT8U bit;
+    while (len > 0) {
+        crc ^= (INT16U)((INT16U)*addr_ptr << 8);
+        for (bit = 0; bit < 8U; bit++) {
+            if ((crc & 0x8000U) != 0) {
+                crc = (INT16U)((crc << 1) ^ 0x1021U);
+            } else {
+                crc = (INT16U)(crc << 1);
+            }
+        }
+        addr_ptr++;
+        len--;
+    }
+    return crc;
+}
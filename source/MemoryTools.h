@@ -15,4 +15,16 @@
 *******************************************************************************/
 INT16U MemCSumGet(INT8U *startaddr, INT8U *endaddr);
 
+/*******************************************************************************
+* MemCSumAdd() adds len bytes from startaddr to sum and returns the new sum
+*******************************************************************************/
+INT16U MemCSumAdd(INT16U sum, INT8U *startaddr, INT32U len);
+
+/*******************************************************************************
+* MemCrc16() adds len bytes from startaddr to a running CRC-16/CCITT (poly
+* 0x1021, MSB first) and returns the new CRC. Start with MEM_CRC16_INIT.
+*******************************************************************************/
+#define MEM_CRC16_INIT 0xFFFFU
+INT16U MemCrc16(INT16U crc, const INT8U *startaddr, INT32U len);
+
 #endif
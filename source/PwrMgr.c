@@ -0,0 +1,381 @@
+/*******************************************************************************
+* PwrMgr.c
+*
+* This module contains the tickless low power mode. When the application
+* allows it, the scheduler idle time is spent in LLS instead of WFI. The RTC
+* alarm ends the sleep at the deadline and the LLWU wakes the part early on
+* a key, the accelerometer INT1 pin or a touch. The TSI scans one channel in
+* LLS, so when the zone table has several pads the LPTMR also wakes the part
+* every scan period, only to move the scan to the next pad and stop again
+* without leaving the 16MHz clock. LLS can not be entered from
+* HSRUN, so the clock is dropped to the 16MHz external reference and the
+* part put in RUN first, then HSRUN and the PLL are restored on wakeup.
+* The RTC prescaler times the sleep and the wakeup latency since it is the
+* only timer that runs through LLS.
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+/*******************************************************************************
+* Includes
+*******************************************************************************/
+#include "MCUType.h"
+#include "SysTickDelay.h"
+#include "BasicIO.h"
+#include "Key.h"
+#include "K65TWR_TSI.h"
+#include "MMA8451Q.h"
+#include "Zone.h"
+#include "PwrMgr.h"
+#include "Trace.h"
+
+/*******************************************************************************
+* Private Resources
+*******************************************************************************/
+#define PWR_RTC_HZ          32768U
+#define PWR_LLWU_FALLING    2U
+#define PWR_KEY_PF1         0x80U   /* LLWU_P7 = PTC3 */
+#define PWR_KEY_PF2         0x07U   /* LLWU_P8-P10 = PTC4-PTC6 */
+#define PWR_MF_LPTMR        0x01U
+#define PWR_MF_TSI          0x10U
+#define PWR_MF_RTCA         0x20U
+
+void LLWU_IRQHandler(void);
+
+static INT8U pwrSleepOk;
+static INT32U pwrLastWakeMs;
+static volatile INT32U pwrWakeStamp;    /* RTC time at the LLWU ISR */
+static volatile INT8U pwrWakeSrc;
+static volatile INT8U pwrTsiMove;       /* LPTMR wakeup, move the TSI scan */
+static INT16U pwrTsiChs;                /* TSI channels scanned in LLS */
+static INT8U pwrTsiCh;                  /* channel being scanned */
+static INT32U pwrWakeZones;
+static PWR_STATS_T pwrStats;
+
+static INT32U pwrRtcTime(void);
+static INT8U pwrAccelCheck(void);
+static INT8U pwrTsiNext(INT8U ch);
+static void pwrLlwuPin(INT8U pin, INT8U mode);
+static void pwrArm(INT32U secs);
+static void pwrDisarm(void);
+static void pwrEnterLls(void);
+
+/******************************************************************************
+* Function Code
+******************************************************************************/
+
+/*******************************************************************************
+* PwrInit() - PUBLIC
+*   parameter: none
+*   description: sets up the LPTMR, the LLWU interrupt and the accelerometer
+*   motion interrupt, checks the accelerometer INT1 pin and takes the pads to
+*   scan in LLS from the zone table. Must be called after KeyInit(), TSIInit()
+*   and the pad calibration, MMA8451Init(), ClockInit() and ZoneInit().
+*******************************************************************************/
+void PwrInit(void){
+    SIM->SCGC5 |= SIM_SCGC5_LPTMR_MASK;
+    LPTMR0->CSR = 0;
+    LPTMR0->PSR = LPTMR_PSR_PCS(1)|LPTMR_PSR_PBYP_MASK;    /* 1kHz LPO */
+    LPTMR0->CMR = LPTMR_CMR_COMPARE(PWR_TSI_SCAN_MS - 1U);
+    pwrTsiChs = ZoneGetTsiChannels();
+    pwrTsiCh = pwrTsiNext(15U);             /* lowest channel first */
+    pwrWakeZones = ZoneGetSrcMask(ZONE_SRC_TSI);
+#if PWR_ACCEL_WAKE_EN
+    PWR_ACCEL_PORT->PCR[PWR_ACCEL_PIN] = PORT_PCR_MUX(1);
+    MMA8451MotionInit(PWR_ACCEL_THS);
+    if(pwrAccelCheck() == 1){
+        pwrWakeZones |= ZoneGetSrcMask(ZONE_SRC_ACCEL);
+    } else{}
+#endif
+    pwrSleepOk = 0;
+    pwrLastWakeMs = 0;
+    NVIC_EnableIRQ(LLWU_IRQn);
+}
+
+/*******************************************************************************
+* PwrGetWakeZones() - PUBLIC
+*   parameter: none
+*   description: returns the mask of zones that wake the part from LLS. Every
+*   TSI zone does, as the pads take turns in the LLS scan, and the
+*   accelerometer zones do if PwrInit() found INT1 on PWR_ACCEL_PIN. GPIO
+*   zones never do. The application must not allow LLS while any other zone
+*   is armed.
+*******************************************************************************/
+INT32U PwrGetWakeZones(void){
+    return pwrWakeZones;
+}
+
+/*******************************************************************************
+* PwrSetSleepOk(INT8U ok) - PUBLIC
+*   parameter: ok - 1 if the application can be stopped, 0 if not
+*   description: the application allows LLS only when every output it needs
+*   keeps working without the core, PIT and DMA.
+*******************************************************************************/
+void PwrSetSleepOk(INT8U ok){
+    pwrSleepOk = ok;
+}
+
+/*******************************************************************************
+* PwrIdle(INT32U max_ms) - PUBLIC
+*   parameter: max_ms - time until the next task deadline
+*   description: enters LLS until the last RTC second boundary before the
+*   deadline or a wakeup input, if sleep is allowed. Returns the ms slept,
+*   which are already added to the SysTick ms count, or 0 if it did not sleep.
+*******************************************************************************/
+INT32U PwrIdle(INT32U max_ms){
+    INT32U secs;
+    INT32U start;
+    INT32U lat;
+    INT32U slept_ms = 0;
+    if(max_ms > PWR_SLEEP_MAX_MS){
+        max_ms = PWR_SLEEP_MAX_MS;
+    } else{}
+    secs = max_ms / 1000U;
+    if((pwrSleepOk == 1) && (secs != 0) &&
+       ((SysTickGetmsCount() - pwrLastWakeMs) >= PWR_AWAKE_MS) &&
+       (BIOTxIdle() == 1)){
+        pwrArm(secs);
+        start = pwrRtcTime();
+        pwrWakeSrc = 0;
+        TRACE(TRC_SLEEP, max_ms);
+        pwrEnterLls();
+        lat = pwrRtcTime();
+        pwrDisarm();
+        slept_ms = (INT32U)(((lat - start) * 1000ULL) / PWR_RTC_HZ);
+        SysTickResync(slept_ms);
+        TRACE(TRC_WAKE, slept_ms);
+        pwrLastWakeMs = SysTickGetmsCount();
+        pwrStats.slept_ms += slept_ms;
+        if(pwrWakeSrc != 0){
+            lat = (INT32U)(((lat - pwrWakeStamp) * 1000000ULL) / PWR_RTC_HZ);
+            pwrStats.last_lat_us = lat;
+            if(lat > pwrStats.max_lat_us){
+                pwrStats.max_lat_us = lat;
+            } else{}
+        } else{}
+        pwrStats.last_src = pwrWakeSrc;
+    } else{}
+    return slept_ms;
+}
+
+/*******************************************************************************
+* PwrGetStats(PWR_STATS_T *stats) - PUBLIC
+*   parameter: stats - where the statistics are copied
+*   description: returns the sleep and wakeup latency statistics
+*******************************************************************************/
+void PwrGetStats(PWR_STATS_T *stats){
+    *stats = pwrStats;
+}
+
+/*******************************************************************************
+* pwrRtcTime() - PRIVATE
+*   parameter: none
+*   description: returns the RTC time in 1/32768s. Wraps every 36 hours, only
+*   differences are used.
+*******************************************************************************/
+static INT32U pwrRtcTime(void){
+    INT32U sec;
+    INT32U pre;
+    do{
+        sec = RTC->TSR;
+        pre = RTC->TPR & (PWR_RTC_HZ - 1U);
+    }while(sec != RTC->TSR);
+    return (sec * PWR_RTC_HZ) + pre;
+}
+
+/*******************************************************************************
+* pwrAccelCheck() - PRIVATE
+*   parameter: none
+*   description: returns 1 if the accelerometer INT1 pin is on PWR_ACCEL_PIN.
+*   With no motion latched INT1 sits at its inactive level, high when active
+*   low and low when active high, so the pin must follow the polarity.
+*   Leaves INT1 active low, as the LLWU pin is armed for a falling edge.
+*******************************************************************************/
+static INT8U pwrAccelCheck(void){
+    INT32U pin = 1UL << PWR_ACCEL_PIN;
+    INT32U high;
+    INT32U low;
+    (void)MMA8451RegRd(MMA8451_FF_MT_SRC);  /* release a latched INT1 */
+    MMA8451SetIntPol(1);
+    low = PWR_ACCEL_GPIO->PDIR & pin;
+    MMA8451SetIntPol(0);
+    high = PWR_ACCEL_GPIO->PDIR & pin;
+    return ((low == 0) && (high != 0)) ? 1U : 0U;
+}
+
+/*******************************************************************************
+* pwrTsiNext() - PRIVATE
+*   parameter: ch - TSI channel
+*   description: returns the next channel after ch in pwrTsiChs, wrapping
+*   around, or ch if pwrTsiChs is empty
+*******************************************************************************/
+static INT8U pwrTsiNext(INT8U ch){
+    INT8U next = ch;
+    INT8U idx;
+    for(idx = 1; idx <= 16U; idx++){
+        if((next == ch) && ((pwrTsiChs & (1U << ((ch + idx) & 15U))) != 0)){
+            next = (INT8U)((ch + idx) & 15U);
+        } else{}
+    }
+    return next;
+}
+
+/*******************************************************************************
+* pwrLlwuPin() - PRIVATE
+*   parameter: pin - LLWU pin number, 0-15
+*              mode - 0 off, 1 rising, 2 falling, 3 any edge
+*   description: sets the wakeup mode of an LLWU pin
+*******************************************************************************/
+static void pwrLlwuPin(INT8U pin, INT8U mode){
+    volatile INT8U *pe = &LLWU->PE1 + (pin >> 2);
+    INT8U shift = (INT8U)((pin & 3U) * 2U);
+    *pe = (INT8U)((*pe & ~(3U << shift)) | ((INT32U)mode << shift));
+}
+
+/*******************************************************************************
+* pwrArm() - PRIVATE
+*   parameter: secs - number of RTC second boundaries to sleep
+*   description: sets up every wakeup source. The RTC alarm flag sets when the
+*   TSR increments from the TAR value. The LPTMR triggers the TSI scans, and
+*   with more than one pad to scan its interrupt also wakes the part so
+*   pwrEnterLls() can move the scan to the next pad.
+*******************************************************************************/
+static void pwrArm(INT32U secs){
+    KeyWakeArm();
+    pwrLlwuPin(7, PWR_LLWU_FALLING);
+    pwrLlwuPin(8, PWR_LLWU_FALLING);
+    pwrLlwuPin(9, PWR_LLWU_FALLING);
+    pwrLlwuPin(10, PWR_LLWU_FALLING);
+#if PWR_ACCEL_WAKE_EN
+    (void)MMA8451RegRd(MMA8451_FF_MT_SRC);  /* release a latched INT1 */
+    pwrLlwuPin(PWR_ACCEL_LLWU_P, PWR_LLWU_FALLING);
+#endif
+    pwrTsiMove = 0;
+    LPTMR0->CSR = LPTMR_CSR_TCF_MASK;
+    RTC->TAR = RTC->TSR + secs - 1U;
+    RTC->IER |= RTC_IER_TAIE_MASK;
+    if(pwrTsiChs == 0){
+        LLWU->ME = PWR_MF_RTCA;             /* no pads in the zone table */
+    } else if(pwrTsiNext(pwrTsiCh) == pwrTsiCh){
+        TSIWakeArm(pwrTsiCh);
+        LPTMR0->CSR = LPTMR_CSR_TEN_MASK;   /* TSI scan trigger, no interrupt */
+        LLWU->ME = PWR_MF_TSI|PWR_MF_RTCA;
+    } else{
+        TSIWakeArm(pwrTsiCh);
+        LPTMR0->CSR = LPTMR_CSR_TEN_MASK|LPTMR_CSR_TIE_MASK;
+        LLWU->ME = PWR_MF_LPTMR|PWR_MF_TSI|PWR_MF_RTCA;
+    }
+    LLWU->PF1 = 0xFFU;
+    LLWU->PF2 = 0xFFU;
+}
+
+/*******************************************************************************
+* pwrDisarm() - PRIVATE
+*   parameter: none
+*   description: returns the wakeup sources to normal operation and clears the
+*   flags of the module interrupts that are not used outside of LLS
+*******************************************************************************/
+static void pwrDisarm(void){
+    LLWU->ME = 0;
+    LLWU->PE2 = 0;
+    LLWU->PE3 = 0;
+    RTC->IER &= ~RTC_IER_TAIE_MASK;
+    RTC->TAR = 0;                           /* write clears TAF */
+    LPTMR0->CSR = LPTMR_CSR_TCF_MASK;       /* also clears TIE */
+    TSIWakeDisarm();
+    KeyWakeDisarm();
+    NVIC_ClearPendingIRQ(RTC_IRQn);
+    NVIC_ClearPendingIRQ(TSI0_IRQn);
+}
+
+/*******************************************************************************
+* pwrEnterLls() - PRIVATE
+*   parameter: none
+*   description: HSRUN -> RUN -> LLS and back. MCG goes PEE -> PBE so the core
+*   is at 16MHz before HSRUN is left. The PLL stays enabled in PBE and relocks
+*   after LLS before PEE is selected again. An LPTMR wakeup only moves the TSI
+*   scan to the next pad and goes back to LLS from RUN. The SysTick interrupt
+*   is held off meanwhile, as the RTC times the whole stop.
+*******************************************************************************/
+static void pwrEnterLls(void){
+    MCG->C1 = (INT8U)((MCG->C1 & ~MCG_C1_CLKS_MASK) | MCG_C1_CLKS(2));
+    while((MCG->S & MCG_S_CLKST_MASK) != MCG_S_CLKST(2)){}
+    SMC->PMCTRL = SMC_PMCTRL_RUNM(0)|SMC_PMCTRL_STOPM(3);
+    while(SMC->PMSTAT != 0x01U){}
+    SMC->STOPCTRL = SMC_STOPCTRL_LLSM(3);  /* LLS3, all RAM retained */
+    (void)SMC->PMCTRL;                      /* make sure the write is done */
+    pwrStats.sleeps++;
+    SysTick->CTRL &= ~SysTick_CTRL_TICKINT_Msk;
+    SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+    do{
+        pwrTsiMove = 0;
+        __DSB();
+        __WFI();
+        if((pwrTsiMove == 1) && (pwrWakeSrc == 0) &&
+           ((SMC->PMCTRL & SMC_PMCTRL_STOPA_MASK) == 0)){
+            if(TSIWakeNext(pwrTsiNext(pwrTsiCh)) == 1){
+                pwrWakeSrc |= PWR_WAKE_TSI;     /* touched as the scan ended */
+                pwrStats.wakes_tsi++;
+                TSI0->GENCS |= TSI_GENCS_OUTRGF_MASK;
+            } else{
+                pwrTsiCh = pwrTsiNext(pwrTsiCh);
+                pwrStats.tsi_moves++;
+            }
+        } else{}
+    }while((pwrTsiMove == 1) && (pwrWakeSrc == 0) &&
+           ((SMC->PMCTRL & SMC_PMCTRL_STOPA_MASK) == 0));
+    SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;     /* SysTickWaitEvent() needs Wait */
+    SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk;
+    if((SMC->PMCTRL & SMC_PMCTRL_STOPA_MASK) != 0){
+        pwrStats.aborts++;
+    } else{}
+    SMC->PMCTRL = SMC_PMCTRL_RUNM(3);
+    while(SMC->PMSTAT != 0x80U){}
+    while((MCG->S & MCG_S_LOCK0_MASK) == 0){}
+    MCG->C1 &= (INT8U)~MCG_C1_CLKS_MASK;
+    while((MCG->S & MCG_S_CLKST_MASK) != MCG_S_CLKST(3)){}
+}
+
+/*******************************************************************************
+* LLWU_IRQHandler() - PUBLIC
+*   parameter: none
+*   description: first code run after an LLS wakeup. Stamps the wakeup for
+*   the latency figures, records the source and clears the pin flags. An
+*   LPTMR wakeup is not a wakeup of the application, it only asks
+*   pwrEnterLls() to move the TSI scan.
+*******************************************************************************/
+void LLWU_IRQHandler(void){
+    INT8U pf1 = LLWU->PF1;
+    INT8U pf2 = LLWU->PF2;
+    INT8U mf = LLWU->MF5;
+    pwrWakeStamp = pwrRtcTime();
+    if(((pf1 & PWR_KEY_PF1) != 0) || ((pf2 & PWR_KEY_PF2) != 0)){
+        pwrWakeSrc |= PWR_WAKE_KEY;
+        pwrStats.wakes_key++;
+    } else{}
+#if PWR_ACCEL_WAKE_EN
+    if((((INT32U)pf1 | ((INT32U)pf2 << 8)) & (1UL << PWR_ACCEL_LLWU_P)) != 0){
+        pwrWakeSrc |= PWR_WAKE_ACCEL;
+        pwrStats.wakes_accel++;
+    } else{}
+#endif
+    if((mf & PWR_MF_TSI) != 0){
+        pwrWakeSrc |= PWR_WAKE_TSI;
+        pwrStats.wakes_tsi++;
+        TSI0->GENCS |= TSI_GENCS_OUTRGF_MASK;
+    } else{}
+    if((mf & PWR_MF_LPTMR) != 0){
+        pwrTsiMove = 1;
+        LPTMR0->CSR = LPTMR_CSR_TEN_MASK|LPTMR_CSR_TIE_MASK|LPTMR_CSR_TCF_MASK;
+    } else{}
+    if((mf & PWR_MF_RTCA) != 0){
+        pwrWakeSrc |= PWR_WAKE_TIMER;
+        pwrStats.wakes_timer++;
+        RTC->IER &= ~RTC_IER_TAIE_MASK;     /* module flag follows the source */
+    } else{}
+    LLWU->PF1 = pf1;
+    LLWU->PF2 = pf2;
+    if(pwrWakeSrc != 0){
+        TRACE(TRC_LLWU, pwrWakeSrc);
+    } else{}
+}
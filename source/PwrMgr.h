@@ -0,0 +1,100 @@
+/*******************************************************************************
+* PwrMgr.h
+*
+* This module contains all function prototypes and configuration for
+* PwrMgr.c
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+#ifndef PWRMGRH
+#define PWRMGRH
+
+/*******************************************************************************
+* Definition of power manager macros/constants
+*******************************************************************************/
+#define PWR_SLEEP_MAX_MS    1000U   /* longest sleep, keeps the clock display live */
+#define PWR_AWAKE_MS        200U    /* min time awake after a wakeup, lets the key
+                                       and TSI tasks debounce the wakeup input */
+#define PWR_TSI_SCAN_MS     25U     /* LPTMR period of the TSI scans in LLS. The
+                                       pads take turns, so with two pads each
+                                       one is scanned every 50ms */
+
+/* Accelerometer INT1 wakeup pin. On the K65 Tower board the MMA8451Q INT1 net
+ * is PTA13, which is LLWU_P4. PwrInit() checks it by flipping the INT1
+ * polarity and reading the pin, and leaves the accelerometer zones out of
+ * PwrGetWakeZones() if the pin does not follow. */
+#define PWR_ACCEL_WAKE_EN   1
+#define PWR_ACCEL_PORT      PORTA
+#define PWR_ACCEL_GPIO      GPIOA
+#define PWR_ACCEL_PIN       13U
+#define PWR_ACCEL_LLWU_P    4U      /* PTA13 is LLWU_P4 */
+#define PWR_ACCEL_THS       4U      /* 0.25g in 0.063g counts */
+
+/* Wakeup source bits in PWR_STATS_T.last_src */
+#define PWR_WAKE_KEY        0x01U
+#define PWR_WAKE_ACCEL      0x02U
+#define PWR_WAKE_TSI        0x04U
+#define PWR_WAKE_TIMER      0x08U
+
+typedef struct{
+    INT32U sleeps;          /* LLS entries */
+    INT32U aborts;          /* stops aborted by a pending interrupt */
+    INT32U wakes_key;
+    INT32U wakes_accel;
+    INT32U wakes_tsi;
+    INT32U wakes_timer;
+    INT32U tsi_moves;       /* LPTMR wakeups that only moved the TSI scan to
+                               the next pad, not counted as wakes */
+    INT32U slept_ms;        /* total time in LLS */
+    INT32U last_lat_us;     /* LLWU ISR to HSRUN restored, last wakeup */
+    INT32U max_lat_us;      /* LLWU ISR to HSRUN restored, worst wakeup */
+    INT8U last_src;         /* PWR_WAKE_ bits of the last wakeup */
+}PWR_STATS_T;
+
+/*******************************************************************************
+* PwrInit() - PUBLIC
+*   parameter: none
+*   description: sets up the LPTMR, the LLWU interrupt and the accelerometer
+*   motion interrupt, checks the accelerometer INT1 pin and takes the pads to
+*   scan in LLS from the zone table. Must be called after KeyInit(), TSIInit()
+*   and the pad calibration, MMA8451Init(), ClockInit() and ZoneInit().
+*******************************************************************************/
+void PwrInit(void);
+
+/*******************************************************************************
+* PwrGetWakeZones() - PUBLIC
+*   parameter: none
+*   description: returns the mask of zones that wake the part from LLS. Every
+*   TSI zone does, as the pads take turns in the LLS scan, and the
+*   accelerometer zones do if PwrInit() found INT1 on PWR_ACCEL_PIN. GPIO
+*   zones never do. The application must not allow LLS while any other zone
+*   is armed.
+*******************************************************************************/
+INT32U PwrGetWakeZones(void);
+
+/*******************************************************************************
+* PwrSetSleepOk(INT8U ok) - PUBLIC
+*   parameter: ok - 1 if the application can be stopped, 0 if not
+*   description: the application allows LLS only when every output it needs
+*   keeps working without the core, PIT and DMA.
+*******************************************************************************/
+void PwrSetSleepOk(INT8U ok);
+
+/*******************************************************************************
+* PwrIdle(INT32U max_ms) - PUBLIC
+*   parameter: max_ms - time until the next task deadline
+*   description: enters LLS until the last RTC second boundary before the
+*   deadline or a wakeup input, if sleep is allowed. Returns the ms slept,
+*   which are already added to the SysTick ms count, or 0 if it did not sleep.
+*******************************************************************************/
+INT32U PwrIdle(INT32U max_ms);
+
+/*******************************************************************************
+* PwrGetStats(PWR_STATS_T *stats) - PUBLIC
+*   parameter: stats - where the statistics are copied
+*   description: returns the sleep and wakeup latency statistics
+*******************************************************************************/
+void PwrGetStats(PWR_STATS_T *stats);
+
+#endif
@@ -0,0 +1,196 @@
+/*******************************************************************************
+* RingBuf.c
+*
+* This module contains a lock-free single-producer/single-consumer ring
+* buffer for handing data between an ISR and a task. Only the producer writes
+* head and only the consumer writes tail, so no interrupt masking is needed.
+* The barriers make the element copies complete before the index that
+* publishes or releases them is written, and keep the index read before the
+* copy on the other side.
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+/*******************************************************************************
+* Includes
+*******************************************************************************/
+#include "MCUType.h"
+#include "RingBuf.h"
+
+/*******************************************************************************
+* Private Resources
+*******************************************************************************/
+static void rbCopy(INT8U *dst, const INT8U *src, INT32U len);
+
+/******************************************************************************
+* Function Code
+******************************************************************************/
+
+/*******************************************************************************
+* RingBufInit(RINGBUF_T *rb, INT8U *store, INT32U elem_size, INT32U count)
+*   - PUBLIC
+*   parameter: rb - ring buffer
+*              store - RB_STORE_SIZE(count, elem_size) bytes
+*              elem_size - bytes per element
+*              count - number of elements, must be a power of two
+*   description: empties the ring buffer. Returns 0, or 1 if count is not a
+*   power of two.
+*******************************************************************************/
+INT8U RingBufInit(RINGBUF_T *rb, INT8U *store, INT32U elem_size, INT32U count){
+    INT8U rval;
+    if((count != 0) && ((count & (count - 1U)) == 0)){
+        rb->head = 0;
+        rb->tail = 0;
+        rb->store = store;
+        rb->mask = count - 1U;
+        rb->elem_size = elem_size;
+        rval = 0;
+    } else{
+        rval = 1;
+    }
+    return rval;
+}
+
+/*******************************************************************************
+* RingBufPush(RINGBUF_T *rb, const void *src, INT32U num) - PUBLIC
+*   parameter: rb - ring buffer
+*              src - num elements
+*              num - elements to push
+*   description: producer side. Copies as many elements as fit and publishes
+*   them together. Returns the number pushed.
+*******************************************************************************/
+INT32U RingBufPush(RINGBUF_T *rb, const void *src, INT32U num){
+    INT32U head = rb->head;
+    INT32U space;
+    INT32U first;
+    INT32U idx;
+    space = (rb->mask + 1U) - (head - rb->tail);
+    __DMB();        /* tail read before the free slots are written */
+    if(num > space){
+        num = space;
+    } else{}
+    idx = head & rb->mask;
+    first = (rb->mask + 1U) - idx;      /* elements before the wrap */
+    if(first > num){
+        first = num;
+    } else{}
+    rbCopy(&rb->store[idx * rb->elem_size], (const INT8U *)src, first * rb->elem_size);
+    rbCopy(rb->store, (const INT8U *)src + (first * rb->elem_size),
+           (num - first) * rb->elem_size);
+    __DMB();        /* elements written before they are published */
+    rb->head = head + num;
+    return num;
+}
+
+/*******************************************************************************
+* RingBufPop(RINGBUF_T *rb, void *dst, INT32U num) - PUBLIC
+*   parameter: rb - ring buffer
+*              dst - room for num elements
+*              num - elements wanted
+*   description: consumer side. Copies up to num elements out and releases
+*   them together. Returns the number popped.
+*******************************************************************************/
+INT32U RingBufPop(RINGBUF_T *rb, void *dst, INT32U num){
+    INT32U tail = rb->tail;
+    INT32U avail;
+    INT32U first;
+    INT32U idx;
+    avail = rb->head - tail;
+    __DMB();        /* head read before the elements are read */
+    if(num > avail){
+        num = avail;
+    } else{}
+    idx = tail & rb->mask;
+    first = (rb->mask + 1U) - idx;
+    if(first > num){
+        first = num;
+    } else{}
+    rbCopy((INT8U *)dst, &rb->store[idx * rb->elem_size], first * rb->elem_size);
+    rbCopy((INT8U *)dst + (first * rb->elem_size), rb->store,
+           (num - first) * rb->elem_size);
+    __DMB();        /* elements read before the slots are released */
+    rb->tail = tail + num;
+    return num;
+}
+
+/*******************************************************************************
+* RingBufPutByte(RINGBUF_T *rb, INT8U data) - PUBLIC
+*   parameter: rb - ring buffer with one byte elements
+*              data - byte to push
+*   description: fast single byte producer for ISRs. Returns 0 if pushed, 1 if
+*   the buffer was full.
+*******************************************************************************/
+INT8U RingBufPutByte(RINGBUF_T *rb, INT8U data){
+    INT32U head = rb->head;
+    INT8U full;
+    if((head - rb->tail) > rb->mask){
+        full = 1;
+    } else{
+        __DMB();
+        rb->store[head & rb->mask] = data;
+        __DMB();
+        rb->head = head + 1U;
+        full = 0;
+    }
+    return full;
+}
+
+/*******************************************************************************
+* RingBufGetByte(RINGBUF_T *rb, INT8U *data) - PUBLIC
+*   parameter: rb - ring buffer with one byte elements
+*              data - where the byte is copied
+*   description: fast single byte consumer for ISRs. Returns 0 if a byte was
+*   popped, 1 if the buffer was empty.
+*******************************************************************************/
+INT8U RingBufGetByte(RINGBUF_T *rb, INT8U *data){
+    INT32U tail = rb->tail;
+    INT8U empty;
+    if(rb->head == tail){
+        empty = 1;
+    } else{
+        __DMB();
+        *data = rb->store[tail & rb->mask];
+        __DMB();
+        rb->tail = tail + 1U;
+        empty = 0;
+    }
+    return empty;
+}
+
+/*******************************************************************************
+* RingBufCount(const RINGBUF_T *rb)/RingBufFree(const RINGBUF_T *rb) - PUBLIC
+*   parameter: rb - ring buffer
+*   description: elements waiting/free. Exact for the caller's own side, a
+*   lower bound for the other side.
+*******************************************************************************/
+INT32U RingBufCount(const RINGBUF_T *rb){
+    return rb->head - rb->tail;
+}
+
+INT32U RingBufFree(const RINGBUF_T *rb){
+    return (rb->mask + 1U) - (rb->head - rb->tail);
+}
+
+/*******************************************************************************
+* rbCopy() - PRIVATE
+*   parameter: dst, src - byte pointers
+*              len - bytes to copy
+*   description: byte copy, word at a time when both are word aligned
+*******************************************************************************/
+static void rbCopy(INT8U *dst, const INT8U *src, INT32U len){
+    if(((((uintptr_t)dst) | ((uintptr_t)src) | (uintptr_t)len) & 3U) == 0){
+        while(len > 0){
+            *(INT32U *)dst = *(const INT32U *)src;
+            dst += 4;
+            src += 4;
+            len -= 4U;
+        }
+    } else{
+        while(len > 0){
+            *dst = *src;
+            dst++;
+            src++;
+            len--;
+        }
+    }
+}
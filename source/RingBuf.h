@@ -0,0 +1,88 @@
+/*******************************************************************************
+* RingBuf.h
+*
+* This module contains all function prototypes and the ring buffer type for
+* RingBuf.c
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+#ifndef RINGBUFH
+#define RINGBUFH
+
+/*******************************************************************************
+* Ring buffer of count elements of elem_size bytes, count a power of two. The
+* storage is supplied by the owner so every buffer is statically sized:
+*   static INT8U txStore[RB_STORE_SIZE(256U, 1U)];
+* head and tail are free running element counts, only masked for indexing.
+*******************************************************************************/
+#define RB_STORE_SIZE(count, elem_size)     ((count) * (elem_size))
+
+typedef struct{
+    volatile INT32U head;   /* written by the producer only */
+    volatile INT32U tail;   /* written by the consumer only */
+    INT8U *store;
+    INT32U mask;            /* count - 1 */
+    INT32U elem_size;
+}RINGBUF_T;
+
+/*******************************************************************************
+* RingBufInit(RINGBUF_T *rb, INT8U *store, INT32U elem_size, INT32U count)
+*   - PUBLIC
+*   parameter: rb - ring buffer
+*              store - RB_STORE_SIZE(count, elem_size) bytes
+*              elem_size - bytes per element
+*              count - number of elements, must be a power of two
+*   description: empties the ring buffer. Returns 0, or 1 if count is not a
+*   power of two.
+*******************************************************************************/
+INT8U RingBufInit(RINGBUF_T *rb, INT8U *store, INT32U elem_size, INT32U count);
+
+/*******************************************************************************
+* RingBufPush(RINGBUF_T *rb, const void *src, INT32U num) - PUBLIC
+*   parameter: rb - ring buffer
+*              src - num elements
+*              num - elements to push
+*   description: producer side. Copies as many elements as fit and publishes
+*   them together. Returns the number pushed.
+*******************************************************************************/
+INT32U RingBufPush(RINGBUF_T *rb, const void *src, INT32U num);
+
+/*******************************************************************************
+* RingBufPop(RINGBUF_T *rb, void *dst, INT32U num) - PUBLIC
+*   parameter: rb - ring buffer
+*              dst - room for num elements
+*              num - elements wanted
+*   description: consumer side. Copies up to num elements out and releases
+*   them together. Returns the number popped.
+*******************************************************************************/
+INT32U RingBufPop(RINGBUF_T *rb, void *dst, INT32U num);
+
+/*******************************************************************************
+* RingBufPutByte(RINGBUF_T *rb, INT8U data) - PUBLIC
+*   parameter: rb - ring buffer with one byte elements
+*              data - byte to push
+*   description: fast single byte producer for ISRs. Returns 0 if pushed, 1 if
+*   the buffer was full.
+*******************************************************************************/
+INT8U RingBufPutByte(RINGBUF_T *rb, INT8U data);
+
+/*******************************************************************************
+* RingBufGetByte(RINGBUF_T *rb, INT8U *data) - PUBLIC
+*   parameter: rb - ring buffer with one byte elements
+*              data - where the byte is copied
+*   description: fast single byte consumer for ISRs. Returns 0 if a byte was
+*   popped, 1 if the buffer was empty.
+*******************************************************************************/
+INT8U RingBufGetByte(RINGBUF_T *rb, INT8U *data);
+
+/*******************************************************************************
+* RingBufCount(const RINGBUF_T *rb)/RingBufFree(const RINGBUF_T *rb) - PUBLIC
+*   parameter: rb - ring buffer
+*   description: elements waiting/free. Exact for the caller's own side, a
+*   lower bound for the other side.
+*******************************************************************************/
+INT32U RingBufCount(const RINGBUF_T *rb);
+INT32U RingBufFree(const RINGBUF_T *rb);
+
+#endif
@@ -0,0 +1,386 @@
+/*******************************************************************************
+* Shell.c
+*
+* This module contains a command shell on BasicIO for field diagnostics. Lines
+* come from BIOLineTask() through EVT_LINE, are split into arguments and looked
+* up in the built in and application command tables. Commands run a step per
+* call of ShellTask() so none of them holds the scheduler for long.
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+/*******************************************************************************
+* Includes
+*******************************************************************************/
+#include "MCUType.h"
+#include "BasicIO.h"
+#include "SysTickDelay.h"
+#include "EventBus.h"
+#include "TaskSched.h"
+#include "Trace.h"
+#include "Shell.h"
+
+/*******************************************************************************
+* Private Resources
+*******************************************************************************/
+#define SHELL_CYC_PER_US    180U    /* DWT cycles per us at the 180MHz core clock */
+#define SHELL_NAME_WIDTH    6U      /* task name column of the tasks command */
+#define SHELL_EVT_DEFAULT   8U      /* events listed by evt without a count */
+
+static const SHELL_CMD_T *shellTable;
+static INT8U shellNum;
+static INT8C shellLine[BIO_LINE_LEN];
+static INT8C *shellArgv[SHELL_MAX_ARGS];
+static INT8U shellArgc;
+static const SHELL_CMD_T *shellCmd;         /* running command, NULL if none */
+static INT8U shellStep;
+static volatile INT8U shellLineReady;
+static INT32U shellEvtNum;                  /* events the evt command lists */
+
+static void shellEvtHandler(const EVT_T *evt);
+static void shellParse(void);
+static const SHELL_CMD_T *shellFind(const INT8C *name);
+static INT8U shellHelpCmd(INT8U step, INT8U argc, INT8C *argv[]);
+static INT8U shellTasksCmd(INT8U step, INT8U argc, INT8C *argv[]);
+static INT8U shellUartCmd(INT8U step, INT8U argc, INT8C *argv[]);
+static INT8U shellTraceCmd(INT8U step, INT8U argc, INT8C *argv[]);
+static INT8U shellEvtCmd(INT8U step, INT8U argc, INT8C *argv[]);
+
+static const INT8C *const shellEvtNames[EVT_NUM] = {
+    "key", "touch", "tilt", "rtc", "zone", "state", "line"
+};
+
+static const SHELL_CMD_T shellBuiltins[] = {
+    {"help",    shellHelpCmd,   "list the commands"},
+    {"tasks",   shellTasksCmd,  "task timing and slice load"},
+    {"uart",    shellUartCmd,   "bit rate, rate error and buffer statistics"},
+    {"trace",   shellTraceCmd,  "[mask|dump] trace id mask or binary dump"},
+    {"evt",     shellEvtCmd,    "[n] last n dispatched events, newest first"}
+};
+#define SHELL_NUM_BUILTINS  (INT8U)(sizeof(shellBuiltins)/sizeof(shellBuiltins[0]))
+
+/******************************************************************************
+* Function Code
+******************************************************************************/
+
+/*******************************************************************************
+* ShellInit(const SHELL_CMD_T *table, INT8U num) - PUBLIC
+*   parameter: table - application commands, must stay valid
+*              num - number of commands in table
+*   description: subscribes to EVT_LINE and prints the prompt. The help,
+*   tasks, uart and trace commands are built in. EvtInit() and BIOOpen() must
+*   be called first.
+*******************************************************************************/
+void ShellInit(const SHELL_CMD_T *table, INT8U num){
+    shellTable = table;
+    shellNum = num;
+    shellCmd = (const SHELL_CMD_T *)0;
+    shellLineReady = 0;
+    (void)EvtSubscribe(EVT_MASK(EVT_LINE), shellEvtHandler);
+    BIOPutStrg(SHELL_PROMPT);
+}
+
+/*******************************************************************************
+* ShellTask() - PUBLIC
+*   parameter: none
+*   description: cooperative task. Parses a line from BIOLineTask() when no
+*   command is running, otherwise runs one step of the current command.
+*******************************************************************************/
+void ShellTask(void){
+    if(shellCmd != (const SHELL_CMD_T *)0){
+        if(shellCmd->func(shellStep, shellArgc, shellArgv) == SHELL_DONE){
+            shellCmd = (const SHELL_CMD_T *)0;
+            BIOPutStrg(SHELL_PROMPT);
+        } else if(shellStep < 0xFFU){
+            shellStep++;        /* stays at 255 so a long command never sees 0 */
+        } else{}
+    } else if(shellLineReady != 0){
+        shellLineReady = 0;
+        shellParse();
+    } else{}
+}
+
+/*******************************************************************************
+* ShellArgHex(INT8C *arg, INT32U *val) - PUBLIC
+*   parameter: arg - argument string, hex digits
+*              val - where the value is written
+*   description: converts an argument with BIOHexStrgtoWord() and prints an
+*   error for a bad one. Returns 0 if val is valid, 1 if not.
+*******************************************************************************/
+INT8U ShellArgHex(INT8C *arg, INT32U *val){
+    INT8U rval = 1;
+    if(arg == (INT8C *)0){
+        BIOPutStrg("missing value");
+        BIOOutCRLF();
+    } else if(BIOHexStrgtoWord(arg, val) != 0){
+        BIOPutStrg("bad hex value: ");
+        BIOPutStrg(arg);
+        BIOOutCRLF();
+    } else{
+        rval = 0;
+    }
+    return rval;
+}
+
+/*******************************************************************************
+* shellEvtHandler() - PRIVATE
+*   parameter: evt - EVT_LINE event
+*   description: flags the line for ShellTask(). The line itself stays in
+*   BasicIO until it is taken, which also holds back the next line.
+*******************************************************************************/
+static void shellEvtHandler(const EVT_T *evt){
+    if(evt->type == EVT_LINE){
+        shellLineReady = 1;
+    } else{}
+}
+
+/*******************************************************************************
+* shellParse() - PRIVATE
+*   parameter: none
+*   description: takes the line from BasicIO, splits it at spaces in place and
+*   starts the command it names
+*******************************************************************************/
+static void shellParse(void){
+    INT8C *ptr;
+    INT8U rval;
+    rval = BIOLineGet(BIO_LINE_LEN, shellLine);
+    if(rval == 2){
+        BIOPutStrg("line too long");
+        BIOOutCRLF();
+        BIOPutStrg(SHELL_PROMPT);
+    } else if(rval == 0){
+        shellArgc = 0;
+        ptr = shellLine;
+        while(*ptr != '\0'){
+            if(*ptr == ' '){
+                *ptr = '\0';
+            } else if(((ptr == shellLine) || (*(ptr - 1) == '\0')) &&
+                      (shellArgc < SHELL_MAX_ARGS)){
+                shellArgv[shellArgc] = ptr;
+                shellArgc++;
+            } else{}
+            ptr++;
+        }
+        if(shellArgc == 0){
+            BIOPutStrg(SHELL_PROMPT);
+        } else{
+            shellCmd = shellFind(shellArgv[0]);
+            if(shellCmd == (const SHELL_CMD_T *)0){
+                BIOPutStrg("unknown command: ");
+                BIOPutStrg(shellArgv[0]);
+                BIOOutCRLF();
+                BIOPutStrg(SHELL_PROMPT);
+            } else{
+                shellStep = 0;
+            }
+        }
+    } else{}
+}
+
+/*******************************************************************************
+* shellFind() - PRIVATE
+*   parameter: name - command name
+*   description: returns the command entry, built in commands first, or NULL
+*******************************************************************************/
+static const SHELL_CMD_T *shellFind(const INT8C *name){
+    const SHELL_CMD_T *cmd = (const SHELL_CMD_T *)0;
+    INT8U idx;
+    for(idx = 0; idx < SHELL_NUM_BUILTINS; idx++){
+        if((cmd == (const SHELL_CMD_T *)0) && (ShellStrEq(name, shellBuiltins[idx].name) != 0)){
+            cmd = &shellBuiltins[idx];
+        } else{}
+    }
+    for(idx = 0; idx < shellNum; idx++){
+        if((cmd == (const SHELL_CMD_T *)0) && (ShellStrEq(name, shellTable[idx].name) != 0)){
+            cmd = &shellTable[idx];
+        } else{}
+    }
+    return cmd;
+}
+
+/*******************************************************************************
+* ShellStrEq(const INT8C *a, const INT8C *b) - PUBLIC
+*   parameter: a, b - strings
+*   description: returns 1 if the strings are equal, 0 if not
+*******************************************************************************/
+INT8U ShellStrEq(const INT8C *a, const INT8C *b){
+    while((*a != '\0') && (*a == *b)){
+        a++;
+        b++;
+    }
+    return (*a == *b) ? 1U : 0U;
+}
+
+/*******************************************************************************
+* shellHelpCmd() - PRIVATE
+*   parameter: step - command step, argc/argv - not used
+*   description: lists one command per step
+*******************************************************************************/
+static INT8U shellHelpCmd(INT8U step, INT8U argc, INT8C *argv[]){
+    const SHELL_CMD_T *cmd;
+    INT8U rval = SHELL_MORE;
+    if(step < SHELL_NUM_BUILTINS){
+        cmd = &shellBuiltins[step];
+    } else if((step - SHELL_NUM_BUILTINS) < shellNum){
+        cmd = &shellTable[step - SHELL_NUM_BUILTINS];
+    } else{
+        cmd = (const SHELL_CMD_T *)0;
+        rval = SHELL_DONE;
+    }
+    if(cmd != (const SHELL_CMD_T *)0){
+        BIOPutStrg(cmd->name);
+        BIOPutStrg(" - ");
+        BIOPutStrg(cmd->help);
+        BIOOutCRLF();
+    } else{}
+    return rval;
+}
+
+/*******************************************************************************
+* shellTasksCmd() - PRIVATE
+*   parameter: step - command step, argc/argv - not used
+*   description: prints a header, then one task per step, then the slice load
+*   summary
+*******************************************************************************/
+static INT8U shellTasksCmd(INT8U step, INT8U argc, INT8C *argv[]){
+    SCHED_STATS_T stats;
+    INT8U pad;
+    INT8U rval = SHELL_MORE;
+    if(step == 0){
+        BIOPutStrg("task    per  ph      runs  last_us   max_us");
+        BIOOutCRLF();
+    } else if(SchedGetStats(step - 1U, &stats) == 0){
+        BIOPutStrg(stats.name);
+        for(pad = 0; (pad < SHELL_NAME_WIDTH) && (stats.name[pad] != '\0'); pad++){}
+        for(; pad < SHELL_NAME_WIDTH; pad++){
+            BIOWrite(' ');
+        }
+        BIOOutDecWord(stats.period, 5, BIO_OD_MODE_AR);
+        BIOOutDecWord(stats.phase, 4, BIO_OD_MODE_AR);
+        BIOOutDecWord(stats.runs, 10, BIO_OD_MODE_AR);
+        BIOOutDecWord(stats.last / SHELL_CYC_PER_US, 9, BIO_OD_MODE_AR);
+        BIOOutDecWord(stats.max / SHELL_CYC_PER_US, 9, BIO_OD_MODE_AR);
+        BIOOutCRLF();
+    } else{
+        BIOPutStrg("slice");
+        BIOOutDecWord(SchedGetSliceMs(), 4, BIO_OD_MODE_AR);
+        BIOPutStrg("ms  est. load");
+        BIOOutDecWord(SchedGetWorstLoad(), 7, BIO_OD_MODE_AR);
+        BIOPutStrg("us  overruns");
+        BIOOutDecWord(SchedGetOverruns(), 10, BIO_OD_MODE_AR);
+        BIOPutStrg("  idle");
+        BIOOutDecWord(SysTickGetIdlePct(), 4, BIO_OD_MODE_AR);
+        BIOWrite('%');
+        BIOOutCRLF();
+        rval = SHELL_DONE;
+    }
+    return rval;
+}
+
+/*******************************************************************************
+* shellUartCmd() - PRIVATE
+*   parameter: step - command step, argc/argv - not used
+*   description: prints the achieved bit rate and its error, then the buffer
+*   statistics
+*******************************************************************************/
+static INT8U shellUartCmd(INT8U step, INT8U argc, INT8C *argv[]){
+    BIO_TX_STATS_T stats;
+    INT32S err;
+    INT32U rate;
+    INT8U rval = SHELL_MORE;
+    if(step == 0){
+        rate = BIOGetRate(&err);
+        BIOPutStrg("rate ");
+        BIOOutDecWord(rate, 7, BIO_OD_MODE_AR);
+        BIOPutStrg(" error ");
+        BIOWrite((err < 0) ? '-' : '+');
+        BIOOutDecWord((INT32U)((err < 0) ? -err : err), 6, BIO_OD_MODE_AR);
+        BIOPutStrg("ppm");
+        BIOOutCRLF();
+    } else{
+        BIOGetTxStats(&stats);
+        BIOPutStrg("tx sent ");
+        BIOOutDecWord(stats.sent, 10, BIO_OD_MODE_AR);
+        BIOPutStrg(" dropped ");
+        BIOOutDecWord(stats.dropped, 10, BIO_OD_MODE_AR);
+        BIOPutStrg(" high ");
+        BIOOutDecWord(stats.high_water, 5, BIO_OD_MODE_AR);
+        BIOPutStrg(" rx dropped ");
+        BIOOutDecWord(BIOGetRxDropped(), 10, BIO_OD_MODE_AR);
+        BIOOutCRLF();
+        rval = SHELL_DONE;
+    }
+    return rval;
+}
+
+/*******************************************************************************
+* shellTraceCmd() - PRIVATE
+*   parameter: step - command step
+*              argc/argv - "trace", "trace <hex mask>" or "trace dump"
+*   description: prints or sets the trace id mask, or sends the trace buffer
+*   in binary for tools/trace_view.py, one TraceDumpStep() per step
+*******************************************************************************/
+static INT8U shellTraceCmd(INT8U step, INT8U argc, INT8C *argv[]){
+    INT32U mask;
+    INT8U rval = SHELL_DONE;
+    if((argc > 1U) && (ShellStrEq(argv[1], "dump") != 0)){
+        if(TraceDumpStep(step) != 0){
+            rval = SHELL_MORE;
+        } else{}
+    } else{
+        if(argc > 1U){
+            if(ShellArgHex(argv[1], &mask) == 0){
+                TraceSetMask(mask);
+            } else{}
+        } else{}
+        BIOPutStrg("mask ");
+        BIOOutHexWord(TraceGetMask());
+        BIOOutCRLF();
+    }
+    return rval;
+}
+
+/*******************************************************************************
+* shellEvtCmd() - PRIVATE
+*   parameter: step - command step
+*              argc/argv - optional hex count of events, up to EVT_TRACE_LEN
+*   description: prints one event of the EvtTraceGet() trace per step, newest
+*   first, then the number of events dropped on full queues
+*******************************************************************************/
+static INT8U shellEvtCmd(INT8U step, INT8U argc, INT8C *argv[]){
+    EVT_T evt;
+    INT8U pad;
+    INT8U rval = SHELL_MORE;
+    if(step == 0){
+        shellEvtNum = SHELL_EVT_DEFAULT;
+        if(argc > 1U){
+            if(ShellArgHex(argv[1], &shellEvtNum) != 0){
+                shellEvtNum = 0;
+            } else if(shellEvtNum > EVT_TRACE_LEN){
+                shellEvtNum = EVT_TRACE_LEN;
+            } else{}
+        } else{}
+        BIOPutStrg("age type  p   seq arg        stamp_ms");
+        BIOOutCRLF();
+    } else if((step <= shellEvtNum) && (EvtTraceGet(step - 1U, &evt) == 0)){
+        BIOOutDecWord((INT32U)step - 1U, 3, BIO_OD_MODE_AR);
+        BIOWrite(' ');
+        BIOPutStrg(shellEvtNames[evt.type]);
+        for(pad = 0; shellEvtNames[evt.type][pad] != '\0'; pad++){}
+        for(; pad < SHELL_NAME_WIDTH; pad++){
+            BIOWrite(' ');
+        }
+        BIOOutDecWord(evt.prio, 1, BIO_OD_MODE_AR);
+        BIOOutDecWord(evt.seq, 6, BIO_OD_MODE_AR);
+        BIOWrite(' ');
+        BIOOutHexWord(evt.arg);
+        BIOOutDecWord(evt.stamp, 11, BIO_OD_MODE_AR);
+        BIOOutCRLF();
+    } else{
+        BIOPutStrg("dropped ");
+        BIOOutDecWord(EvtGetDropCount(), 10, BIO_OD_MODE_AL);
+        BIOOutCRLF();
+        rval = SHELL_DONE;
+    }
+    return rval;
+}
@@ -0,0 +1,71 @@
+/*******************************************************************************
+* Shell.h
+*
+* This module contains all function prototypes and the command table type for
+* Shell.c
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+#ifndef SHELLH
+#define SHELLH
+
+/*******************************************************************************
+* Definition of shell macros/constants
+*******************************************************************************/
+#define SHELL_MAX_ARGS      4U      /* command name included */
+#define SHELL_PROMPT        "> "
+
+/* Command function return values */
+#define SHELL_DONE          0U
+#define SHELL_MORE          1U      /* call again with the next step */
+
+/*******************************************************************************
+* Command table entry. A command runs incrementally: func is called once per
+* ShellTask() with step 0, 1, 2... until it returns SHELL_DONE, so every step
+* must fit in a slice with the rest of the tasks. A step should write at most
+* one line so the BasicIO TX buffer is not overrun.
+*******************************************************************************/
+typedef INT8U (*SHELL_FUNC_T)(INT8U step, INT8U argc, INT8C *argv[]);
+
+typedef struct{
+    const INT8C *name;
+    SHELL_FUNC_T func;
+    const INT8C *help;
+}SHELL_CMD_T;
+
+/*******************************************************************************
+* ShellInit(const SHELL_CMD_T *table, INT8U num) - PUBLIC
+*   parameter: table - application commands, must stay valid
+*              num - number of commands in table
+*   description: subscribes to EVT_LINE and prints the prompt. The help,
+*   tasks, uart, trace and evt commands are built in. EvtInit() and BIOOpen() must
+*   be called first.
+*******************************************************************************/
+void ShellInit(const SHELL_CMD_T *table, INT8U num);
+
+/*******************************************************************************
+* ShellTask() - PUBLIC
+*   parameter: none
+*   description: cooperative task. Parses a line from BIOLineTask() when no
+*   command is running, otherwise runs one step of the current command.
+*******************************************************************************/
+void ShellTask(void);
+
+/*******************************************************************************
+* ShellArgHex(INT8C *arg, INT32U *val) - PUBLIC
+*   parameter: arg - argument string, hex digits
+*              val - where the value is written
+*   description: converts an argument with BIOHexStrgtoWord() and prints an
+*   error for a bad one. Returns 0 if val is valid, 1 if not.
+*******************************************************************************/
+INT8U ShellArgHex(INT8C *arg, INT32U *val);
+
+/*******************************************************************************
+* ShellStrEq(const INT8C *a, const INT8C *b) - PUBLIC
+*   parameter: a, b - strings
+*   description: returns 1 if the strings are equal, 0 if not
+*******************************************************************************/
+INT8U ShellStrEq(const INT8C *a, const INT8C *b);
+
+#endif
@@ -0,0 +1,322 @@
+/*******************************************************************************
+* SoundClips.c
+*
+* IMA-ADPCM sound clips played by WaveGenDMAPlayClip(). Generated by
+* tools/adpcm_encode.py, do not edit.
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+/*******************************************************************************
+* Includes
+*******************************************************************************/
+#include "MCUType.h"
+#include "SoundClips.h"
+
+/*******************************************************************************
+* Private Resources
+*******************************************************************************/
+static const INT8U scData_chime[3400] = {
+    0x70,0x77,0x57,0xCF,0xCF,0x2A,0x57,0x82,0xA9,0xAA,0xEB,0x2A,
+    0x56,0x82,0xA9,0xA9,0xDA,0x1A,0x46,0x02,0xA9,0x9A,0xCA,0x0A,
+    0x46,0x12,0xB9,0x99,0xBA,0x0B,0x56,0x12,0xA9,0xA9,0xB9,0x0C,
+    0x73,0x13,0x99,0xAA,0xB9,0x9B,0x65,0x13,0xA8,0xAA,0xB9,0x9B,
+    0x73,0x15,0xA0,0xA9,0xB8,0xAA,0x73,0x23,0xA0,0xAA,0xAA,0xAC,
+    0x62,0x34,0x98,0xAA,0xA9,0xAC,0x51,0x25,0x90,0x9A,0xA9,0xBB,
+    0x61,0x34,0x91,0xAB,0xA9,0xAC,0x58,0x35,0x91,0xAA,0xA9,0xCB,
+    0x48,0x45,0x91,0xA9,0x99,0xBA,0x39,0x47,0x81,0xA9,0x99,0xBA,
+    0x29,0x47,0x01,0x9A,0x9A,0xBA,0x29,0x47,0x01,0xA9,0x99,0xBA,
+    0x1A,0x56,0x02,0x9A,0x9A,0xB9,0x0A,0x46,0x03,0xA9,0x9A,0xCA,
+    0x0A,0x64,0x03,0x99,0x9A,0xBA,0x8B,0x65,0x13,0xA9,0x9A,0xB9,
+    0x9B,0x74,0x13,0xA8,0x9A,0xB9,0x8C,0x72,0x13,0x98,0xAA,0xA9,
+    0x9C,0x62,0x14,0x90,0xAA,0xA9,0x9B,0x71,0x24,0x98,0x9A,0xA9,
+    0xAB,0x61,0x25,0x90,0x9A,0xA9,0xAB,0x50,0x26,0x91,0xAA,0x99,
+    0xBB,0x50,0x35,0x81,0xAB,0xA9,0xAC,0x38,0x47,0x81,0xAA,0xA8,
+    0xBA,0x38,0x47,0x81,0x9A,0x99,0xBA,0x29,0x47,0x81,0xA9,0x99,
+    0xAA,0x2A,0x37,0x83,0xB9,0x9A,0xBB,0x1B,0x67,0x82,0x99,0x99,
+    0xB9,0x0A,0x46,0x02,0xA9,0x99,0xBA,0x0B,0x56,0x12,0xA9,0xA9,
+    0xB9,0x8B,0x65,0x12,0xA8,0x9A,0xB9,0x9B,0x74,0x13,0xA8,0x9A,
+    0xB9,0x9B,0x73,0x15,0x98,0x9A,0xA8,0x9B,0x71,0x33,0xA8,0xAA,
+    0xB9,0xBB,0x72,0x25,0x90,0x9A,0x9A,0xAB,0x70,0x33,0xA1,0xAA,
+    0xAA,0xBC,0x60,0x25,0x80,0xAA,0x99,0xBB,0x40,0x27,0x81,0xAA,
+    0x99,0xBB,0x48,0x27,0x81,0x9A,0xA9,0xBA,0x49,0x36,0x82,0xBA,
+    0xA9,0xCA,0x29,0x47,0x81,0xA9,0x99,0xB9,0x2A,0x56,0x01,0xA9,
+    0x99,0xBA,0x19,0x46,0x02,0xA9,0x9A,0xBA,0x1B,0x66,0x02,0xA9,
+    0x99,0xB9,0x8A,0x55,0x13,0xA9,0x9A,0xBA,0x8C,0x64,0x12,0xA8,
+    0x9A,0xB9,0x8B,0x64,0x14,0xA8,0x9A,0xA9,0x9B,0x73,0x14,0x98,
+    0x9A,0xA9,0x9B,0x72,0x14,0x90,0x9A,0xA9,0xAB,0x71,0x14,0x90,
+    0x9A,0xA9,0xBA,0x61,0x25,0x90,0x9A,0xA9,0xAB,0x50,0x26,0x80,
+    0xAA,0x99,0xAB,0x58,0x35,0x91,0xAA,0xA9,0xCB,0x48,0x45,0x81,
+    0xAA,0x99,0xAB,0x39,0x47,0x01,0xAA,0x99,0xBA,0x3A,0x47,0x82,
+    0x9A,0x9A,0xBA,0x2A,0x47,0x82,0xA9,0x99,0xBA,0x1A,0x47,0x02,
+    0xA9,0x9A,0xAA,0x0B,0x56,0x02,0xA8,0x9A,0xB9,0x0B,0x55,0x13,
+    0xA9,0x9A,0xCA,0x8A,0x64,0x13,0xA9,0x9A,0xB9,0x8C,0x73,0x13,
+    0xA8,0x9A,0xB9,0x9C,0x73,0x23,0xA8,0xAA,0xB9,0xAB,0x73,0x25,
+    0x98,0x9A,0xA9,0xAB,0x62,0x34,0x98,0xAA,0xA9,0xAC,0x51,0x25,
+    0x90,0xA9,0xA9,0xBB,0x60,0x25,0x91,0x9A,0x9A,0xBB,0x58,0x36,
+    0x80,0xAA,0x99,0xBB,0x49,0x37,0x81,0xAA,0xA9,0xBA,0x39,0x57,
+    0x81,0xA9,0x99,0xB9,0x29,0x37,0x82,0xB9,0xA9,0xCA,0x19,0x46,
+    0x02,0xA9,0x9A,0xCA,0x09,0x46,0x02,0x9A,0x9A,0xB9,0x1B,0x65,
+    0x02,0xA8,0x9A,0xB9,0x0B,0x55,0x13,0xA9,0x9A,0xCA,0x8A,0x64,
+    0x13,0xA9,0x9A,0xB9,0x9B,0x74,0x13,0xA8,0x9A,0xB9,0x8C,0x62,
+    0x24,0xA8,0x9A,0xA9,0xAB,0x72,0x24,0x98,0x9A,0xA9,0xBB,0x72,
+    0x24,0xA0,0xA9,0xA9,0xAB,0x70,0x24,0x90,0x9A,0xA9,0xBB,0x60,
+    0x25,0x91,0xAA,0x99,0xBB,0x58,0x36,0x80,0xAA,0x99,0xBB,0x59,
+    0x45,0x91,0xA9,0x99,0xBA,0x39,0x47,0x81,0xA9,0x99,0xBA,0x29,
+    0x47,0x01,0x9A,0x8A,0xAB,0x1A,0x47,0x82,0xA9,0x99,0xBA,0x1A,
+    0x37,0x03,0xB9,0xA9,0xCA,0x1B,0x65,0x02,0x99,0x9A,0xB9,0x0B,
+    0x55,0x13,0xA9,0x9A,0xBA,0x8C,0x64,0x13,0xA9,0x9A,0xB9,0x9B,
+    0x74,0x13,0xA8,0x9A,0xB9,0xAB,0x64,0x14,0xA0,0x9A,0xA9,0xAB,
+    0x72,0x24,0x98,0x9A,0xA9,0xAB,0x71,0x24,0xA0,0xA9,0xA9,0xAB,
+    0x70,0x24,0x90,0x9A,0xA9,0xAB,0x68,0x25,0x91,0xAA,0x99,0xBB,
+    0x58,0x26,0x81,0xAA,0x99,0xBB,0x48,0x36,0x82,0xAB,0xA9,0xCB,
+    0x39,0x47,0x81,0xA9,0x99,0xBA,0x29,0x47,0x01,0x9A,0x9A,0xB9,
+    0x1A,0x47,0x01,0xA9,0x99,0xAA,0x0A,0x56,0x02,0xA9,0x99,0xBA,
+    0x0A,0x65,0x02,0xA8,0x9A,0xB9,0x8A,0x55,0x13,0xA9,0x9A,0xBA,
+    0x8C,0x64,0x13,0xA9,0x9A,0xB9,0x9B,0x74,0x13,0xA8,0x9A,0xB9,
+    0x9B,0x72,0x15,0xA0,0x99,0xA9,0x9B,0x62,0x24,0xA0,0x9A,0xAA,
+    0xAB,0x71,0x34,0x98,0x9A,0xAA,0xAB,0x70,0x24,0x91,0xAA,0xA9,
+    0xBB,0x50,0x36,0x91,0xAA,0xA9,0xBB,0x58,0x36,0x91,0xAA,0xA9,
+    0xCA,0x38,0x37,0x81,0xAA,0xA9,0xCA,0x28,0x37,0x82,0xAA,0x9A,
+    0xBB,0x3A,0x57,0x82,0xA9,0x99,0xBA,0x2A,0x56,0x01,0xA9,0x99,
+    0xB9,0x0A,0x56,0x02,0xA9,0x99,0xBA,0x0A,0x65,0x02,0x99,0x9A,
+    0xB9,0x8A,0x55,0x13,0xA9,0x9A,0xBA,0x9B,0x65,0x13,0xA8,0x9A,
+    0xBA,0x9B,0x74,0x23,0xA8,0x9B,0xB9,0x9C,0x72,0x23,0xA0,0x9B,
+    0xB9,0x9C,0x71,0x23,0xA0,0x9A,0xAA,0xAC,0x61,0x24,0x90,0x9A,
+    0x9A,0x9C,0x40,0x26,0x90,0xA9,0x99,0xBB,0x50,0x26,0x91,0x9A,
+    0xA9,0xAB,0x48,0x27,0x81,0xAA,0x99,0xBA,0x49,0x36,0x82,0xAB,
+    0xA9,0xBB,0x4A,0x47,0x81,0xA9,0x99,0xBA,0x29,0x37,0x83,0xAA,
+    0x9A,0xCB,0x19,0x46,0x02,0xA9,0x9A,0xBA,0x1B,0x47,0x03,0xAA,
+    0x99,0xCA,0x0A,0x55,0x02,0xA8,0x9A,0xB9,0x8B,0x65,0x12,0xA8,
+    0x9A,0xAA,0x8B,0x64,0x14,0x99,0x9A,0xA9,0x9B,0x73,0x14,0x98,
+    0x9A,0xA9,0x9B,0x72,0x14,0xA0,0xA9,0xB8,0xAA,0x72,0x33,0x98,
+    0xAB,0xB9,0xBB,0x71,0x26,0x88,0x9A,0xA9,0xAA,0x50,0x25,0x91,
+    0xAA,0xA9,0xAB,0x68,0x25,0x91,0x9A,0xA9,0xBB,0x58,0x36,0x80,
+    0xAA,0x99,0xBB,0x49,0x37,0x81,0xAA,0x99,0xBB,0x4A,0x46,0x81,
+    0xA9,0x99,0xBA,0x2A,0x47,0x82,0xA9,0x99,0xBA,0x1A,0x47,0x82,
+    0x99,0x9A,0xBA,0x1A,0x56,0x02,0xA9,0x99,0xBA,0x0A,0x65,0x12,
+    0xA9,0x9A,0xB9,0x0B,0x74,0x03,0xA8,0x9A,0xB9,0x8B,0x74,0x22,
+    0xA9,0x99,0xAA,0x9B,0x73,0x15,0x98,0x9A,0x99,0x9B,0x62,0x24,
+    0x98,0xAA,0xA9,0xAB,0x72,0x24,0xA0,0x9A,0xA9,0xAB,0x61,0x25,
+    0x90,0x9A,0x9A,0xBB,0x70,0x24,0x90,0xA9,0xA9,0xAB,0x58,0x36,
+    0x80,0xAA,0xA9,0xBB,0x58,0x36,0x80,0xAA,0x99,0xBB,0x38,0x57,
+    0x81,0xA9,0x99,0xAA,0x29,0x37,0x82,0xAA,0xA9,0xCA,0x29,0x46,
+    0x82,0xA9,0xA9,0xBA,0x1A,0x47,0x02,0xA9,0xA9,0xBA,0x0A,0x47,
+    0x03,0x9A,0x9A,0xBA,0x0B,0x56,0x12,0xA9,0x9A,0xB9,0x8B,0x65,
+    0x13,0xA9,0x9A,0xBA,0x8B,0x74,0x13,0xA8,0x9A,0xAA,0x8C,0x72,
+    0x23,0x99,0xAA,0xA9,0x9C,0x62,0x24,0xA8,0xA9,0xA9,0xAB,0x72,
+    0x24,0xA0,0x9A,0xA9,0xAB,0x61,0x25,0x90,0x9A,0xA9,0xBB,0x60,
+    0x25,0x91,0xAA,0x99,0xBB,0x68,0x34,0x81,0xAB,0xA9,0xAC,0x59,
+    0x35,0x91,0xAA,0x99,0xCB,0x38,0x37,0x81,0xAA,0x99,0xCB,0x39,
+    0x46,0x82,0xAA,0x99,0xCA,0x29,0x55,0x01,0xA9,0x99,0xBA,0x1A,
+    0x47,0x01,0x99,0x9A,0xB9,0x0A,0x46,0x03,0xA9,0x9A,0xCA,0x0A,
+    0x64,0x03,0xA9,0x99,0xBA,0x8B,0x65,0x13,0xA9,0x9A,0xB9,0x9B,
+    0x74,0x13,0xA8,0x9A,0xB9,0x9B,0x73,0x15,0x98,0x9A,0x99,0x9B,
+    0x62,0x24,0xA0,0xAA,0xA9,0xAB,0x71,0x15,0x90,0x9A,0xA8,0xAB,
+    0x61,0x24,0xA1,0x9A,0xAA,0xAB,0x60,0x35,0x90,0xAA,0xA9,0xBB,
+    0x50,0x36,0x91,0xAA,0xA9,0xBB,0x58,0x36,0x91,0x9A,0x9A,0xBB,
+    0x49,0x37,0x81,0xAA,0x99,0xCB,0x39,0x46,0x82,0xAA,0x99,0xBA,
+    0x2A,0x47,0x02,0xAA,0x99,0xBA,0x2B,0x47,0x02,0xA9,0x9A,0xBA,
+    0x0A,0x56,0x12,0xA9,0x9A,0xBA,0x0B,0x56,0x12,0xA9,0xA9,0xB9,
+    0x8B,0x65,0x12,0xA8,0x9A,0xB9,0x9B,0x74,0x13,0xA8,0x9A,0xB9,
+    0x9B,0x73,0x15,0x98,0x9A,0xA8,0x9B,0x62,0x24,0x98,0xAA,0xA9,
+    0xAB,0x71,0x15,0x90,0x9A,0xA8,0xAB,0x61,0x24,0x90,0x9A,0xA9,
+    0xAC,0x50,0x25,0x90,0xA9,0x99,0xBB,0x50,0x35,0x91,0xAA,0xA9,
+    0xCB,0x48,0x36,0x91,0xAA,0x99,0xBB,0x49,0x37,0x81,0xAA,0x99,
+    0xBB,0x3A,0x57,0x01,0x9A,0x99,0xBA,0x19,0x37,0x83,0xB9,0xA9,
+    0xCA,0x1A,0x46,0x03,0xAA,0x9A,0xBA,0x1B,0x66,0x02,0xA9,0x99,
+    0xB9,0x8A,0x55,0x13,0xA9,0x9A,0xBA,0x8C,0x64,0x12,0xA8,0x9A,
+    0xB9,0x8B,0x64,0x14,0xA8,0x9A,0xA9,0x9B,0x73,0x14,0x98,0x9A,
+    0xA9,0x9B,0x72,0x14,0x90,0x9A,0xA9,0xAB,0x71,0x14,0x90,0x9A,
+    0xA9,0xBA,0x61,0x25,0x90,0x9A,0xA9,0xAB,0x50,0x26,0x80,0xAA,
+    0x99,0xAB,0x58,0x35,0x91,0xAA,0xA9,0xCB,0x48,0x36,0x91,0xAA,
+    0x99,0xBB,0x49,0x37,0x81,0xAA,0x99,0xBB,0x3A,0x57,0x01,0x9A,
+    0x99,0xBA,0x19,0x37,0x83,0xB9,0xA9,0xCA,0x1A,0x46,0x83,0xA9,
+    0xA9,0xBA,0x1B,0x47,0x03,0xA9,0x9A,0xBA,0x8B,0x56,0x03,0xA8,
+    0xAA,0xB9,0x9B,0x56,0x13,0xA9,0x9A,0xBA,0x06,0x11,0x80,0xA9,
+    0xB9,0xCE,0x8B,0x73,0x26,0x01,0xAA,0xAA,0xCA,0xAD,0x29,0x47,
+    0x23,0x98,0xAB,0xAA,0xCC,0x9B,0x62,0x35,0x82,0xA9,0xAA,0xA9,
+    0xBC,0x1A,0x74,0x33,0x90,0xAA,0x9A,0xBA,0xBC,0x48,0x46,0x12,
+    0x98,0xAA,0x9A,0xCA,0x9B,0x72,0x34,0x01,0xAA,0x9A,0xAA,0xCB,
+    0x1A,0x65,0x23,0x90,0xAA,0x9A,0xBA,0xAC,0x48,0x37,0x12,0xA8,
+    0xAA,0x9A,0xCB,0x8B,0x72,0x25,0x81,0xA9,0x99,0xAA,0xBB,0x2A,
+    0x57,0x22,0x90,0xAA,0xA9,0xBA,0xAC,0x41,0x46,0x02,0xA8,0x9A,
+    0x9A,0xBB,0x8B,0x74,0x24,0x81,0xAA,0x99,0xAA,0xCB,0x29,0x46,
+    0x14,0x88,0xAA,0x99,0xBA,0xAB,0x61,0x35,0x03,0xA9,0xAB,0xA9,
+    0xCC,0x89,0x73,0x24,0x80,0xA9,0x9A,0xA9,0xAC,0x28,0x46,0x23,
+    0xA8,0xAA,0x9A,0xCB,0x9B,0x61,0x35,0x83,0xA9,0xAA,0xAA,0xBC,
+    0x0A,0x65,0x33,0x80,0xBA,0x9A,0xCA,0xBB,0x48,0x46,0x13,0xA8,
+    0xAA,0xA9,0xCA,0x9B,0x72,0x34,0x82,0xA9,0x9B,0xAA,0xBC,0x1A,
+    0x56,0x23,0x80,0xAB,0x9A,0xCA,0xAB,0x48,0x37,0x13,0x99,0xAB,
+    0x9A,0xDB,0x8A,0x62,0x25,0x01,0xAA,0xA9,0xA9,0xCB,0x19,0x65,
+    0x22,0x90,0xAA,0x99,0xBA,0xAC,0x40,0x46,0x02,0xA8,0x9A,0xA9,
+    0xCA,0x8A,0x73,0x33,0x82,0xBA,0xAA,0xBA,0xBC,0x3A,0x57,0x13,
+    0x90,0xAB,0x99,0xCA,0x9B,0x50,0x36,0x02,0xA9,0xAA,0xA9,0xCB,
+    0x8A,0x64,0x24,0x81,0xAA,0x9A,0xB9,0xCB,0x28,0x47,0x12,0x90,
+    0xAA,0x9A,0xCA,0xAA,0x61,0x44,0x01,0xA8,0x9A,0x9A,0xCB,0x09,
+    0x73,0x24,0x80,0xA9,0x9A,0xAA,0xAC,0x38,0x37,0x14,0xA8,0xA9,
+    0xA9,0xBA,0x9C,0x62,0x34,0x02,0xB9,0xAA,0xAA,0xBC,0x0A,0x56,
+    0x33,0x80,0xAB,0xAA,0xCA,0xBB,0x40,0x37,0x13,0xA8,0xBA,0xA9,
+    0xDB,0x8B,0x72,0x24,0x82,0xA9,0xAA,0xA9,0xAC,0x1A,0x46,0x24,
+    0x88,0xAA,0xA9,0xB9,0xAC,0x40,0x36,0x13,0xA9,0xAB,0xA9,0xDB,
+    0x8A,0x72,0x24,0x01,0xAA,0x9A,0xA9,0xBC,0x18,0x46,0x14,0x90,
+    0xAA,0x99,0xBA,0xAB,0x51,0x37,0x02,0xA9,0x9A,0x9A,0xCB,0x8A,
+    0x54,0x25,0x81,0xAA,0x9A,0xA9,0xAC,0x39,0x46,0x23,0x98,0xAB,
+    0x9A,0xCB,0xAB,0x62,0x35,0x03,0xB9,0xAA,0xAA,0xBC,0x0B,0x65,
+    0x33,0x81,0xAB,0xAA,0xBA,0xAD,0x39,0x47,0x13,0xA8,0xAA,0x99,
+    0xBB,0x9C,0x71,0x24,0x02,0xA9,0x9B,0xA9,0xBC,0x09,0x55,0x24,
+    0x90,0xA9,0x9A,0xB9,0xAC,0x48,0x45,0x13,0x99,0x9B,0x9A,0xCB,
+    0x9B,0x73,0x34,0x01,0xAA,0x9A,0xAA,0xBC,0x2A,0x65,0x23,0x90,
+    0xAA,0x9A,0xCA,0xAB,0x40,0x37,0x03,0xA8,0xAA,0xAA,0xCB,0x8B,
+    0x73,0x25,0x01,0xAA,0xA9,0xA9,0xCB,0x29,0x55,0x23,0x90,0xBA,
+    0x9A,0xCA,0xBB,0x51,0x46,0x11,0x99,0xAA,0x99,0xCA,0x8A,0x73,
+    0x24,0x80,0xA9,0x99,0xAA,0xBB,0x29,0x57,0x13,0xA0,0xAA,0x99,
+    0xCA,0x9B,0x51,0x36,0x11,0xA9,0xAA,0xA9,0xCB,0x0B,0x55,0x33,
+    0x81,0xBA,0x9B,0xCA,0xCB,0x38,0x56,0x12,0xA0,0xAA,0x99,0xCA,
+    0x9A,0x61,0x34,0x83,0xA9,0xAB,0xB9,0xBC,0x0A,0x56,0x33,0x91,
+    0xAB,0xAA,0xCA,0xBB,0x48,0x47,0x12,0xA8,0x9A,0x9A,0xBA,0x9C,
+    0x72,0x43,0x01,0x9A,0xAA,0xA9,0xCB,0x19,0x55,0x23,0x91,0xAB,
+    0xAA,0xBA,0xAD,0x40,0x55,0x02,0xA8,0xA9,0x99,0xBB,0x8B,0x73,
+    0x35,0x81,0xA9,0xAA,0xA9,0xAC,0x2A,0x46,0x14,0x90,0x9A,0x9A,
+    0xAA,0xAC,0x41,0x36,0x12,0xA9,0xAA,0xAA,0xCB,0x8B,0x64,0x34,
+    0x81,0xAA,0xAA,0xB9,0xCB,0x29,0x47,0x13,0x90,0xAB,0xA9,0xCA,
+    0x9B,0x51,0x36,0x02,0xA9,0xAA,0xA9,0xDB,0x0A,0x54,0x24,0x81,
+    0xAA,0x9A,0xBA,0xCB,0x28,0x47,0x13,0x98,0xAA,0x9A,0xBB,0x9C,
+    0x61,0x35,0x01,0xA9,0xAA,0xA9,0xCB,0x0A,0x55,0x24,0x80,0xAA,
+    0xA9,0xB9,0xAC,0x38,0x47,0x12,0x98,0xAA,0x99,0xBB,0x9C,0x62,
+    0x25,0x02,0xAA,0x9A,0xA9,0xBC,0x19,0x55,0x14,0x91,0xAA,0x99,
+    0xBA,0xBB,0x50,0x46,0x02,0x98,0xAA,0xA9,0xCA,0x8A,0x72,0x43,
+    0x81,0xA9,0x9A,0xA9,0xAC,0x2A,0x65,0x22,0x90,0xAA,0xA9,0xC9,
+    0xAA,0x40,0x46,0x02,0x99,0x9A,0x9A,0xCA,0x8A,0x73,0x43,0x00,
+    0xAA,0x99,0xAA,0xCB,0x18,0x46,0x23,0xA0,0xAA,0xAA,0xCA,0xAB,
+    0x61,0x35,0x12,0xA9,0xAB,0xA9,0xBC,0x0B,0x74,0x33,0x81,0xBA,
+    0xAA,0xC9,0xBB,0x49,0x46,0x13,0xA0,0xBA,0xA9,0xCA,0x9B,0x61,
+    0x35,0x02,0xA9,0x9B,0xAA,0xDB,0x09,0x54,0x24,0x91,0xB9,0xA9,
+    0xB9,0xBC,0x48,0x55,0x12,0x98,0xAA,0xA9,0xBA,0x9C,0x62,0x25,
+    0x82,0xA9,0x9A,0xA9,0xCB,0x1A,0x55,0x33,0x90,0xBA,0x9A,0xCA,
+    0xBB,0x58,0x36,0x13,0xA8,0xAB,0x9A,0xBC,0x9B,0x73,0x35,0x01,
+    0xAA,0x9A,0xAA,0xCB,0x2A,0x65,0x23,0x88,0xAB,0xA9,0xC9,0xAB,
+    0x50,0x45,0x02,0xA8,0x9A,0xA9,0xBB,0x9B,0x74,0x24,0x01,0xAA,
+    0x9A,0xB9,0xCB,0x29,0x56,0x22,0x98,0xAA,0x99,0xBA,0xAC,0x51,
+    0x45,0x11,0xA9,0x9A,0xA9,0xCA,0x0A,0x73,0x24,0x91,0xA9,0x9A,
+    0xB9,0xBB,0x39,0x67,0x12,0x98,0xA9,0x99,0xBA,0xAB,0x62,0x45,
+    0x01,0x99,0x9A,0x9A,0xBB,0x1B,0x65,0x33,0x91,0xBA,0x9A,0xCA,
+    0xBB,0x38,0x67,0x12,0x98,0xAA,0x99,0xB9,0xAB,0x72,0x34,0x02,
+    0xB9,0xAA,0xB9,0xDB,0x09,0x55,0x23,0x91,0xBA,0x9A,0xCA,0xBB,
+    0x40,0x37,0x13,0xA8,0xAB,0x9A,0xDB,0x9A,0x72,0x24,0x82,0xA9,
+    0xAA,0xA9,0xAC,0x1A,0x46,0x14,0x80,0xAA,0xA9,0xB9,0xBB,0x50,
+    0x46,0x02,0xA8,0x9A,0xA9,0xCA,0x8A,0x73,0x43,0x81,0xAA,0x99,
+    0xAA,0xCB,0x29,0x46,0x23,0x90,0xAB,0xAA,0xCA,0xAB,0x60,0x35,
+    0x03,0xB8,0xAA,0xAA,0xBC,0x0B,0x74,0x33,0x81,0xAA,0x9B,0xBA,
+    0xBD,0x28,0x47,0x22,0x98,0xAA,0x9A,0xCA,0xAA,0x61,0x44,0x82,
+    0xA8,0x9A,0x9A,0xCB,0x0A,0x64,0x33,0x91,0xBA,0x9A,0xBA,0xAD,
+    0x28,0x47,0x12,0xA0,0xAA,0x99,0xCA,0x8B,0x61,0x44,0x01,0xA9,
+    0x9A,0xA9,0xBB,0x1A,0x75,0x23,0x90,0xAA,0xA9,0xB9,0xAC,0x38,
+    0x57,0x02,0x98,0x9A,0x99,0xBA,0x9B,0x72,0x25,0x82,0xA9,0x9A,
+    0x9A,0xAC,0x1A,0x55,0x14,0x90,0xA9,0x99,0xAA,0xAC,0x40,0x45,
+    0x12,0x99,0xAA,0xA9,0xBB,0x8C,0x73,0x24,0x01,0xAA,0x9A,0xB9,
+    0xCB,0x29,0x46,0x14,0x90,0xAA,0x99,0xBA,0xBB,0x61,0x45,0x02,
+    0x99,0xAA,0x99,0xCB,0x8A,0x54,0x34,0x91,0xB9,0xA9,0xB9,0xBC,
+    0x28,0x47,0x13,0xA0,0xAA,0xA9,0xCA,0xAB,0x52,0x36,0x02,0xA9,
+    0xAA,0xA9,0xBC,0x0A,0x74,0x33,0x80,0xAA,0xAA,0xBA,0xBC,0x38,
+    0x57,0x12,0xA0,0x9A,0x9A,0xBA,0x9C,0x52,0x35,0x02,0xA9,0xAB,
+    0xA9,0xBC,0x1B,0x65,0x14,0x91,0xA9,0x9A,0xA9,0xAC,0x38,0x47,
+    0x02,0x98,0x9A,0xA9,0xBA,0x9B,0x72,0x35,0x01,0xAA,0x9A,0xA9,
+    0xBC,0x19,0x65,0x13,0x91,0xAA,0x9A,0xBA,0xAC,0x48,0x46,0x12,
+    0x99,0xAA,0x99,0xCB,0x8A,0x72,0x24,0x01,0xAA,0x9A,0xA9,0xAC,
+    0x2A,0x46,0x33,0x98,0xBA,0x9A,0xCB,0xAB,0x60,0x35,0x13,0xB9,
+    0xAA,0xAA,0xBC,0x8B,0x74,0x24,0x81,0xAA,0xA9,0xA9,0xCB,0x29,
+    0x56,0x12,0x90,0xAA,0x99,0xBA,0x9C,0x50,0x35,0x03,0xA9,0xAB,
+    0xB9,0xDB,0x0A,0x54,0x25,0x80,0x9A,0x9A,0xA9,0xAC,0x28,0x46,
+    0x13,0xA0,0xAA,0x9A,0xCB,0x9B,0x71,0x34,0x02,0xB9,0xAA,0xA9,
+    0xBC,0x0A,0x65,0x33,0x90,0xAA,0x9A,0xCA,0xBB,0x30,0x57,0x03,
+    0x98,0xAA,0x99,0xCA,0x9A,0x62,0x34,0x02,0xAA,0x9B,0xAA,0xCC,
+    0x19,0x64,0x23,0x90,0xAA,0x9A,0xBA,0xAD,0x30,0x47,0x02,0x98,
+    0xAA,0x99,0xCA,0x8A,0x62,0x25,0x81,0xA9,0xA9,0xA9,0xCB,0x19,
+    0x46,0x23,0x90,0xBA,0xA9,0xCA,0xBB,0x51,0x36,0x03,0xA8,0xAB,
+    0xAA,0xCB,0x8B,0x64,0x34,0x81,0xAA,0x9A,0xBA,0xBC,0x28,0x47,
+    0x23,0x98,0xAB,0xA9,0xCA,0xAB,0x61,0x35,0x02,0xB8,0xAA,0xA9,
+    0xBC,0x0B,0x74,0x33,0x81,0xAB,0xAA,0xB9,0xAD,0x39,0x56,0x12,
+    0xA0,0xA9,0x9A,0xBA,0x9C,0x61,0x34,0x02,0xA9,0x9B,0xAA,0xCC,
+    0x09,0x54,0x24,0x91,0xAA,0xA9,0xB9,0xAC,0x38,0x47,0x22,0xA8,
+    0xAA,0xA9,0xCA,0x9B,0x72,0x34,0x01,0xAA,0x9A,0xAA,0xCB,0x1A,
+    0x65,0x23,0x90,0xAA,0x9A,0xBA,0xAC,0x48,0x46,0x12,0xA8,0xAA,
+    0x99,0xBB,0x8C,0x72,0x24,0x01,0xB9,0xA9,0xA9,0xAC,0x1A,0x56,
+    0x22,0x90,0xAA,0xA9,0xC9,0x9B,0x40,0x46,0x02,0xA8,0x9A,0x9A,
+    0xCA,0x8A,0x63,0x25,0x81,0xA9,0x9A,0xB9,0xCB,0x29,0x46,0x14,
+    0x90,0xAA,0x99,0xBA,0xAB,0x61,0x35,0x03,0xA9,0xAB,0xA9,0xCC,
+    0x89,0x73,0x24,0x80,0xA9,0x9A,0xA9,0xAC,0x28,0x46,0x23,0xA8,
+    0xAA,0x9A,0xCB,0x9B,0x61,0x35,0x02,0xA9,0xAA,0xAA,0xDB,0x0A,
+    0x64,0x33,0x91,0xBA,0x9A,0xBA,0xAD,0x38,0x47,0x12,0x98,0xAA,
+    0x9A,0xCA,0x9A,0x71,0x43,0x82,0xA9,0x9A,0xA9,0xBC,0x09,0x55,
+    0x24,0x90,0x9A,0x9A,0xB9,0xAC,0x30,0x47,0x12,0x99,0xAA,0x99,
+    0xCA,0x9A,0x72,0x43,0x01,0xAA,0xA9,0xA9,0xCB,0x19,0x55,0x14,
+    0x90,0xA9,0xA9,0xB9,0xAB,0x68,0x35,0x13,0xA9,0xAB,0x9A,0xBC,
+    0x9B,0x74,0x33,0x82,0xBA,0xAA,0xB9,0xBD,0x29,0x56,0x13,0x90,
+    0xAA,0x9A,0xCA,0x9B,0x50,0x45,0x02,0x99,0xAA,0x99,0xCB,0x8A,
+    0x54,0x34,0x91,0xB9,0x9A,0xB9,0xBC,0x39,0x47,0x13,0x90,0xAB,
+    0xA9,0xCA,0xAB,0x52,0x36,0x02,0xA9,0xAA,0xA9,0xBC,0x0A,0x74,
+    0x33,0x80,0xBA,0xA9,0xBA,0xBC,0x38,0x57,0x12,0xA0,0x9A,0x9A,
+    0xBA,0x9C,0x52,0x26,0x02,0x9A,0xAA,0xA9,0xCB,0x09,0x55,0x33,
+    0x90,0xAA,0x9B,0xCA,0xBB,0x58,0x55,0x02,0x98,0x9A,0xA9,0xBA,
+    0x9B,0x72,0x35,0x01,0xAA,0x9A,0xA9,0xBC,0x19,0x65,0x23,0x90,
+    0xBA,0x99,0xCA,0xAB,0x50,0x45,0x02,0xA8,0x9A,0xA9,0xBB,0x9B,
+    0x74,0x24,0x81,0xA9,0x9A,0xB9,0xCB,0x29,0x46,0x14,0x90,0xAA,
+    0x99,0xBA,0xAB,0x60,0x45,0x11,0x99,0xAA,0x99,0xBB,0x8B,0x74,
+    0x24,0x81,0xAA,0xA9,0xA9,0xAC,0x29,0x37,0x14,0xA0,0x9A,0x9A,
+    0xBA,0x9C,0x51,0x35,0x03,0xB9,0xAA,0xAA,0xDB,0x0A,0x64,0x33,
+    0x91,0xBA,0x9A,0xBA,0xBD,0x38,0x47,0x22,0xA8,0xAA,0x99,0xBB,
+    0x9C,0x52,0x36,0x01,0xA9,0x9A,0xAA,0xCB,0x0A,0x65,0x23,0x90,
+    0xB9,0xA9,0xB9,0xBC,0x30,0x57,0x02,0x98,0x9A,0x99,0xCA,0x8A,
+    0x61,0x34,0x01,0xB9,0x9A,0xAA,0xBC,0x19,0x65,0x23,0x90,0xAA,
+    0x9A,0xCA,0xAB,0x40,0x37,0x03,0xA8,0xAA,0xAA,0xCB,0x8B,0x73,
+    0x25,0x01,0xAA,0xA9,0xA9,0xCB,0x29,0x55,0x23,0x90,0xBA,0x9A,
+    0xCA,0xBB,0x51,0x36,0x13,0xB9,0xAA,0xAA,0xDB,0x8A,0x54,0x34,
+    0x81,0xAA,0xAA,0xB9,0xBC,0x29,0x47,0x23,0xA0,0xBA,0xA9,0xCA,
+    0xAB,0x61,0x35,0x12,0xB9,0xAA,0xA9,0xBC,0x8A,0x55,0x34,0x80,
+    0xAA,0x9A,0xAA,0xBC,0x28,0x47,0x13,0xA0,0xAA,0x9A,0xCA,0x9B,
+    0x61,0x35,0x02,0xAA,0x9A,0xAA,0xBC,0x1A,0x55,0x24,0x91,0xAA,
+    0x9A,0xB9,0xAC,0x38,0x47,0x13,0x99,0xAA,0xA9,0xCA,0x9B,0x72,
+    0x34,0x01,0xAA,0x9A,0xAA,0xCB,0x1A,0x46,0x24,0x90,0xAA,0x99,
+    0xBA,0xAC,0x40,0x55,0x02,0xA8,0xA9,0x99,0xCA,0x8A,0x62,0x34,
+    0x01,0xAA,0xAA,0xB9,0xBC,0x19,0x47,0x23,0x90,0xAB,0x9A,0xCA,
+    0xAB,0x50,0x36,0x03,0xB8,0xAA,0xA9,0xBC,0x8B,0x74,0x33,0x81,
+    0xAA,0x9B,0xBA,0xBC,0x29,0x57,0x22,0x98,0x9A,0x9A,0xBA,0xAC,
+    0x51,0x45,0x01,0xA8,0x9A,0xA9,0xCA,0x89,0x73,0x24,0x80,0xA9,
+    0x9A,0xA9,0xAC,0x28,0x56,0x12,0x98,0x9A,0x9A,0xBA,0x9C,0x61,
+    0x34,0x02,0xA9,0x9B,0xAA,0xBC,0x0A,0x65,0x33,0x80,0xBA,0xAA,
+    0xC9,0xBB,0x48,0x46,0x13,0xA8,0xAA,0xA9,0xCB,0x8B,0x72,0x34,
+    0x82,0xB9,0x9A,0xAA,0xBC,0x1A,0x56,0x23,0x80,0xAB,0x9A,0xCA,
+    0xAB,0x48,0x37,0x13,0x99,0xAB,0x9A,0xDB,0x9A,0x63,0x25,0x01,
+    0x9A,0xAA,0xA9,0xCB,0x19,0x65,0x22,0x90,0xAA,0x99,0xBA,0xAC,
+    0x40,0x46,0x02,0xA8,0x9A,0xA9,0xCA,0x8A,0x73,0x33,0x82,0xBA,
+    0xAA,0xBA,0xCC,0x29,0x46,0x23,0xA0,0xAA,0xAA,0xCA,0xAB,0x61,
+    0x35,0x12,0xB9,0xAA,0xA9,0xBC,0x0B,0x74,0x33,0x81,0xBA,0xAA,
+    0xC9,0xBB,0x39,0x57,0x13,0x98,0xAA,0x99,0xBB,0x9C,0x61,0x44,
+    0x01,0x99,0xAA,0x99,0xCB,0x1A,0x73,0x24,0x80,0xA9,0x9A,0xAA,
+    0xAC,0x38,0x47,0x12,0x98,0xAA,0xA9,0xBA,0x9C,0x62,0x34,0x02,
+    0xB9,0xAA,0xAA,0xBC,0x0A,0x56,0x14,0x80,0x9A,0x9A,0xB9,0xBB,
+    0x58,0x36,0x13,0xA8,0xAB,0xAA,0xCB,0x8C,0x62,0x34,0x82,0xB9,
+    0xAA,0xB9,0xDB,0x19,0x55,0x23,0x90,0xAA,0xAA,0xBA,0xAD,0x40,
+    0x36,0x13,0xA9,0xAB,0xA9,0xDB,0x8A,0x72,0x24,0x01,0xAA,0x9A,
+    0xB9,0xCB,0x29,0x56,0x22,0xA0,0xAA,0x99,0xBA,0xAC,0x41,0x37,
+    0x02,0xA9,0x9A,0x9A
+};
+
+static const SOUND_CLIP_T scClips[] = {
+    {scData_chime, 6800U, 8000U, 0, 0U, 0x042EU, "chime"}
+};
+
+/******************************************************************************
+* Function Code
+******************************************************************************/
+
+/*******************************************************************************
+* SoundClipGet(INT8U clip) - PUBLIC
+*   parameter: clip - clip number
+*   description: returns the clip, or NULL past the last one
+*******************************************************************************/
+const SOUND_CLIP_T *SoundClipGet(INT8U clip){
+    return (clip < (INT8U)(sizeof(scClips)/sizeof(scClips[0]))) ?
+           &scClips[clip] : (const SOUND_CLIP_T *)0;
+}
@@ -0,0 +1,33 @@
+/*******************************************************************************
+* SoundClips.h
+*
+* This module contains the clip type and the function prototype of the sound
+* clip table, SoundClips.c, which is generated by tools/adpcm_encode.py
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+#ifndef SOUNDCLIPSH
+#define SOUNDCLIPSH
+
+/*******************************************************************************
+* Definition of sound clip macros/constants
+*******************************************************************************/
+typedef struct{
+    const INT8U *data;      /* IMA-ADPCM nibbles, low nibble first */
+    INT32U samples;
+    INT16U rate;            /* sample rate in Hz */
+    INT16S pred;            /* decoder start state */
+    INT8U index;
+    INT16U crc;             /* MemCrc16() of the decoded INT16S samples */
+    const INT8C *name;
+}SOUND_CLIP_T;
+
+/*******************************************************************************
+* SoundClipGet(INT8U clip) - PUBLIC
+*   parameter: clip - clip number
+*   description: returns the clip, or NULL past the last one
+*******************************************************************************/
+const SOUND_CLIP_T *SoundClipGet(INT8U clip);
+
+#endif
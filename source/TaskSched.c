@@ -0,0 +1,473 @@
+/*******************************************************************************
+* TaskSched.c
+*
+* This module contains a multi-rate time slice scheduler. Tasks come from a
+* static table with a period, phase and priority each. The periods divide a
+* hyperperiod of slices and SchedInit() places the tasks in it so the
+* estimated load of every slice is as even as possible.
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+/*******************************************************************************
+* Includes
+*******************************************************************************/
+#include "MCUType.h"
+#include "BasicIO.h"
+#include "K65TWR_GPIO.h"
+#include "SysTickDelay.h"
+#include "TaskSched.h"
+#include "Trace.h"
+#if SCHED_PREEMPT_EN
+#include "Kernel.h"
+#endif
+#define SCHED_LLS_EN    (SCHED_TICKLESS_EN && !SCHED_PREEMPT_EN)
+#if SCHED_LLS_EN
+#include "PwrMgr.h"
+#endif
+
+/*******************************************************************************
+* Private Resources
+*******************************************************************************/
+static const SCHED_TASK_T *schedTable;
+static INT8U schedNum;
+static INT8U schedOrder[SCHED_MAX_TASKS];   /* table indexes by priority */
+static INT16U schedPeriod[SCHED_MAX_TASKS]; /* in slices */
+static INT16U schedPhase[SCHED_MAX_TASKS];  /* in slices */
+static INT32U schedRuns[SCHED_MAX_TASKS];
+static INT32U schedLast[SCHED_MAX_TASKS];
+static INT32U schedMax[SCHED_MAX_TASKS];
+static INT32U schedLoad[SCHED_HYPER_MAX];   /* estimated us in each slice */
+static INT16U schedHyper;
+static INT32U schedWorstLoad;
+static INT32U schedOverruns;
+static INT16U schedSliceMs = SCHED_SLICE_MS;
+static volatile INT16U schedSliceNew;      /* from SchedSetSliceMs(), 0 if none */
+
+static INT16U schedGcd(INT16U a, INT16U b);
+static INT16U schedHyperOf(INT16U slice_ms);
+static void schedLayout(void);
+static void schedPlace(void);
+static void schedReport(void);
+static void schedRunTask(INT8U task);
+#if SCHED_PREEMPT_EN
+static void schedThread(INT32U task);
+#endif
+#if SCHED_LLS_EN
+static INT32U schedNextDeadline(INT16U slot);
+#endif
+
+/******************************************************************************
+* Function Code
+******************************************************************************/
+
+/*******************************************************************************
+* schedGcd() - PRIVATE
+*   parameter: a, b - numbers
+*   description: returns the greatest common divisor of a and b
+*******************************************************************************/
+static INT16U schedGcd(INT16U a, INT16U b){
+    INT16U t;
+    while(b != 0){
+        t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/*******************************************************************************
+* schedPlace() - PRIVATE
+*   parameter: none
+*   description: adds the estimated time of every task to the slices it runs
+*   in. Fixed phases are placed first. Then the auto phase tasks are placed
+*   longest first, each at the phase that gives the lowest peak load.
+*******************************************************************************/
+static void schedPlace(void){
+    INT8U placed[SCHED_MAX_TASKS];
+    INT8U task;
+    INT8U next;
+    INT16U slot;
+    INT16U phase;
+    INT16U best_phase;
+    INT32U peak;
+    INT32U best_peak;
+    for(slot = 0; slot < schedHyper; slot++){
+        schedLoad[slot] = 0;
+    }
+    for(task = 0; task < schedNum; task++){
+        placed[task] = 0;
+        if(schedTable[task].phase != SCHED_PHASE_AUTO){
+            schedPhase[task] = (INT16U)(((INT16U)schedTable[task].phase / schedSliceMs) %
+                                        schedPeriod[task]);
+            for(slot = schedPhase[task]; slot < schedHyper; slot += schedPeriod[task]){
+                schedLoad[slot] += schedTable[task].wcet;
+            }
+            placed[task] = 1;
+        } else{}
+    }
+    do{
+        /* longest unplaced task */
+        next = SCHED_MAX_TASKS;
+        for(task = 0; task < schedNum; task++){
+            if((placed[task] == 0) && ((next == SCHED_MAX_TASKS) ||
+               (schedTable[task].wcet > schedTable[next].wcet))){
+                next = task;
+            } else{}
+        }
+        if(next != SCHED_MAX_TASKS){
+            best_phase = 0;
+            best_peak = 0xFFFFFFFFU;
+            for(phase = 0; phase < schedPeriod[next]; phase++){
+                peak = 0;
+                for(slot = phase; slot < schedHyper; slot += schedPeriod[next]){
+                    if(schedLoad[slot] > peak){
+                        peak = schedLoad[slot];
+                    } else{}
+                }
+                if(peak < best_peak){
+                    best_peak = peak;
+                    best_phase = phase;
+                } else{}
+            }
+            schedPhase[next] = best_phase;
+            for(slot = best_phase; slot < schedHyper; slot += schedPeriod[next]){
+                schedLoad[slot] += schedTable[next].wcet;
+            }
+            placed[next] = 1;
+        } else{}
+    }while(next != SCHED_MAX_TASKS);
+    schedWorstLoad = 0;
+    for(slot = 0; slot < schedHyper; slot++){
+        if(schedLoad[slot] > schedWorstLoad){
+            schedWorstLoad = schedLoad[slot];
+        } else{}
+    }
+}
+
+/*******************************************************************************
+* schedReport() - PRIVATE
+*   parameter: none
+*   description: reports every slice whose estimated load is over the budget
+*   and the tasks that run in it
+*******************************************************************************/
+static void schedReport(void){
+    INT32U budget;
+    INT16U slot;
+    INT8U task;
+    budget = ((INT32U)schedSliceMs * 1000U * SCHED_BUDGET_PCT) / 100U;
+    if(schedWorstLoad > budget){
+        BIOPutStrg("SCHED: slice load over budget of ");
+        BIOOutDecWord(budget, 5, BIO_OD_MODE_AL);
+        BIOPutStrg("us");
+        BIOOutCRLF();
+        for(slot = 0; slot < schedHyper; slot++){
+            if(schedLoad[slot] > budget){
+                BIOPutStrg(" slice ");
+                BIOOutDecWord(slot, 3, BIO_OD_MODE_AR);
+                BIOPutStrg(": ");
+                BIOOutDecWord(schedLoad[slot], 6, BIO_OD_MODE_AR);
+                BIOPutStrg("us");
+                for(task = 0; task < schedNum; task++){
+                    if((slot % schedPeriod[task]) == schedPhase[task]){
+                        BIOWrite(' ');
+                        BIOPutStrg(schedTable[task].name);
+                    } else{}
+                }
+                BIOOutCRLF();
+            } else{}
+        }
+    } else{}
+}
+
+/*******************************************************************************
+* schedHyperOf() - PRIVATE
+*   parameter: slice_ms - slice length
+*   description: returns the hyperperiod of the task table in slices of
+*   slice_ms, the least common multiple of the task periods, or 0 if it is
+*   over SCHED_HYPER_MAX. A shorter slot counter would run a task whose period
+*   does not divide it at the wrong rate.
+*******************************************************************************/
+static INT16U schedHyperOf(INT16U slice_ms){
+    INT8U task;
+    INT16U period;
+    INT32U hyper = 1;
+    for(task = 0; (task < schedNum) && (hyper <= SCHED_HYPER_MAX); task++){
+        period = schedTable[task].period / slice_ms;
+        if(period == 0){
+            period = 1;
+        } else{}
+        hyper = (hyper * period) / schedGcd((INT16U)hyper, period);
+    }
+    return (hyper <= SCHED_HYPER_MAX) ? (INT16U)hyper : 0U;
+}
+
+/*******************************************************************************
+* schedLayout() - PRIVATE
+*   parameter: none
+*   description: converts the task periods to slices of schedSliceMs, finds
+*   the hyperperiod, places the tasks and reports an over budget load. The
+*   hyperperiod has been checked by SchedInit() or SchedSetSliceMs().
+*******************************************************************************/
+static void schedLayout(void){
+    INT8U task;
+    for(task = 0; task < schedNum; task++){
+        schedPeriod[task] = (INT16U)(schedTable[task].period / schedSliceMs);
+        if(schedPeriod[task] == 0){
+            schedPeriod[task] = 1;
+        } else{}
+    }
+    schedHyper = schedHyperOf(schedSliceMs);
+    schedPlace();
+    schedReport();
+}
+
+/*******************************************************************************
+* SchedInit(const SCHED_TASK_T *table, INT8U num) - PUBLIC
+*   parameter: table - task table, must stay valid while the scheduler runs
+*              num - number of tasks in table
+*   description: orders the tasks by priority, picks the phase of every
+*   SCHED_PHASE_AUTO task to spread the estimated load across slices and
+*   computes the worst case slice load. If that load is over the budget it is
+*   reported on BasicIO. BIOOpen() must be called first. A table whose
+*   hyperperiod is over SCHED_HYPER_MAX slices is reported and rejected, no
+*   task would run and 1 is returned, so the caller must halt instead of
+*   calling SchedRun(). Returns 0 if the table is accepted.
+*******************************************************************************/
+INT8U SchedInit(const SCHED_TASK_T *table, INT8U num){
+    INT8U task;
+    INT8U pos;
+    INT8U tmp;
+    INT8U rval = 0;
+    schedTable = table;
+    schedNum = (num > SCHED_MAX_TASKS) ? SCHED_MAX_TASKS : num;
+    if(schedHyperOf(schedSliceMs) == 0){
+        BIOPutStrg("SCHED: hyperperiod over ");
+        BIOOutDecWord(SCHED_HYPER_MAX, 3, BIO_OD_MODE_AL);
+        BIOPutStrg(" slices, table rejected");
+        BIOOutCRLF();
+        schedNum = 0;
+        rval = 1;
+    } else{}
+    for(task = 0; task < schedNum; task++){
+        schedRuns[task] = 0;
+        schedLast[task] = 0;
+        schedMax[task] = 0;
+        /* insertion sort by priority, table order for equal priorities */
+        pos = task;
+        schedOrder[pos] = task;
+        while((pos > 0) && (table[schedOrder[pos - 1]].prio > table[task].prio)){
+            tmp = schedOrder[pos - 1];
+            schedOrder[pos - 1] = schedOrder[pos];
+            schedOrder[pos] = tmp;
+            pos--;
+        }
+    }
+    schedOverruns = 0;
+    schedSliceNew = 0;
+    schedLayout();
+
+    /* DWT cycle counter for the task timing */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    return rval;
+}
+
+/*******************************************************************************
+* SchedRun() - PUBLIC
+*   parameter: none
+*   description: the time slice loop. Waits for every slice with
+*   SysTickWaitEvent() and runs the tasks that are due. A slice change from
+*   SchedSetSliceMs() is applied between slices. With SCHED_TICKLESS_EN
+*   the time until the next task without SCHED_F_WAKE is offered to PwrIdle()
+*   first and the slices it slept are skipped. With SCHED_PREEMPT_EN every task
+*   is started as a kernel thread instead. Never returns.
+*******************************************************************************/
+void SchedRun(void){
+#if SCHED_PREEMPT_EN
+    INT8U task;
+    for(task = 0; task < schedNum; task++){
+        (void)KnlThreadCreate(schedThread, task, schedTable[task].prio,
+                              schedTable[task].period,
+                              (INT32U)schedPhase[task] * schedSliceMs);
+    }
+    KnlStart();
+#else
+    INT16U slot = 0;
+    INT8U pos;
+    INT8U task;
+    INT32U slice_start;
+    while(TRUE){
+        if(schedSliceNew != 0){
+            schedSliceMs = schedSliceNew;
+            schedSliceNew = 0;
+            schedLayout();
+            slot = 0;
+        } else{}
+        SysTickWaitEvent(schedSliceMs);
+        slice_start = SysTickGetmsCount();
+        for(pos = 0; pos < schedNum; pos++){
+            task = schedOrder[pos];
+            if((slot % schedPeriod[task]) == schedPhase[task]){
+                schedRunTask(task);
+            } else{}
+        }
+        if((SysTickGetmsCount() - slice_start) >= schedSliceMs){
+            schedOverruns++;
+        } else{}
+        slot++;
+        if(slot >= schedHyper){
+            slot = 0;
+        } else{}
+#if SCHED_LLS_EN
+        slot = (INT16U)((slot + (PwrIdle(schedNextDeadline(slot)) / schedSliceMs)) %
+                        schedHyper);
+#endif
+    }
+#endif
+}
+
+/*******************************************************************************
+* schedRunTask() - PRIVATE
+*   parameter: task - table index
+*   description: runs a task and records its DWT cycle count. In the
+*   preemptive build the count includes the time it was preempted.
+*******************************************************************************/
+static void schedRunTask(INT8U task){
+    INT32U start;
+    INT32U cycles;
+    TRACE(TRC_TASK_START, task);
+    start = DWT->CYCCNT;
+    schedTable[task].task();
+    cycles = DWT->CYCCNT - start;
+    TRACE(TRC_TASK_END, task);
+    schedLast[task] = cycles;
+    if(cycles > schedMax[task]){
+        schedMax[task] = cycles;
+    } else{}
+    schedRuns[task]++;
+}
+
+#if SCHED_PREEMPT_EN
+/*******************************************************************************
+* schedThread() - PRIVATE
+*   parameter: task - table index
+*   description: kernel thread that runs one task every period. A release
+*   that has already passed when the task finishes counts as an overrun.
+*******************************************************************************/
+static void schedThread(INT32U task){
+    while(TRUE){
+        schedRunTask((INT8U)task);
+        if(KnlWaitPeriod() != 0){
+            schedOverruns++;
+        } else{}
+    }
+}
+#endif
+
+#if SCHED_LLS_EN
+/*******************************************************************************
+* schedNextDeadline() - PRIVATE
+*   parameter: slot - next slice to run
+*   description: returns the ms until the first slice, from slot on, that runs
+*   a task without SCHED_F_WAKE, or 0xFFFFFFFF if there is none
+*******************************************************************************/
+static INT32U schedNextDeadline(INT16U slot){
+    INT32U deadline = 0xFFFFFFFFU;
+    INT16U ahead;
+    INT16U cur;
+    INT8U task;
+    for(ahead = 0; (ahead < schedHyper) && (deadline == 0xFFFFFFFFU); ahead++){
+        cur = (INT16U)((slot + ahead) % schedHyper);
+        for(task = 0; task < schedNum; task++){
+            if(((schedTable[task].flags & SCHED_F_WAKE) == 0) &&
+               ((cur % schedPeriod[task]) == schedPhase[task])){
+                deadline = (INT32U)(ahead + 1U) * schedSliceMs;
+            } else{}
+        }
+    }
+    return deadline;
+}
+#endif
+
+/*******************************************************************************
+* SchedGetStats(INT8U index, SCHED_STATS_T *stats) - PUBLIC
+*   parameter: index - task index in the table
+*              stats - where the task timing is copied
+*   description: returns 0 if stats is valid, 1 if index is out of range
+*******************************************************************************/
+INT8U SchedGetStats(INT8U index, SCHED_STATS_T *stats){
+    INT8U rval;
+    if(index < schedNum){
+        stats->name = schedTable[index].name;
+        stats->period = schedTable[index].period;
+        stats->phase = (INT16U)(schedPhase[index] * schedSliceMs);
+        stats->runs = schedRuns[index];
+        stats->last = schedLast[index];
+        stats->max = schedMax[index];
+        rval = 0;
+    } else{
+        rval = 1;
+    }
+    return rval;
+}
+
+/*******************************************************************************
+* SchedGetWorstLoad() - PUBLIC
+*   parameter: none
+*   description: returns the estimated worst case slice load in us
+*******************************************************************************/
+INT32U SchedGetWorstLoad(void){
+    return schedWorstLoad;
+}
+
+/*******************************************************************************
+* SchedGetOverruns() - PUBLIC
+*   parameter: none
+*   description: returns the number of slices whose tasks ran past the slice
+*******************************************************************************/
+INT32U SchedGetOverruns(void){
+    return schedOverruns;
+}
+
+/*******************************************************************************
+* SchedSetSliceMs(INT16U ms) - PUBLIC
+*   parameter: ms - new slice length
+*   description: changes the slice at the start of the next slice and places
+*   the tasks again. Every task period must be a multiple of ms and the
+*   hyperperiod at most SCHED_HYPER_MAX slices of ms. Returns 0 if accepted,
+*   1 if not. Not supported in the preemptive build.
+*******************************************************************************/
+INT8U SchedSetSliceMs(INT16U ms){
+    INT8U rval = 0;
+    INT8U task;
+#if SCHED_PREEMPT_EN
+    rval = 1;
+#endif
+    if(ms == 0){
+        rval = 1;
+    } else{
+        for(task = 0; task < schedNum; task++){
+            if((schedTable[task].period % ms) != 0){
+                rval = 1;
+            } else{}
+        }
+        if(schedHyperOf(ms) == 0){
+            rval = 1;
+        } else{}
+    }
+    if(rval == 0){
+        schedSliceNew = ms;
+    } else{}
+    return rval;
+}
+
+/*******************************************************************************
+* SchedGetSliceMs() - PUBLIC
+*   parameter: none
+*   description: returns the slice length in ms
+*******************************************************************************/
+INT16U SchedGetSliceMs(void){
+    return schedSliceMs;
+}
@@ -0,0 +1,119 @@
+/*******************************************************************************
+* TaskSched.h
+*
+* This module contains all function prototypes and the task table type for
+* TaskSched.c
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+#ifndef TASKSCHEDH
+#define TASKSCHEDH
+
+/*******************************************************************************
+* Definition of scheduler macros/constants
+*******************************************************************************/
+#define SCHED_SLICE_MS      5U      /* base slice at start, every period is a multiple */
+#define SCHED_BUDGET_PCT    80U     /* usable part of a slice for the load check */
+#define SCHED_HYPER_MAX     200U    /* max slices in the hyperperiod (1s) */
+#define SCHED_MAX_TASKS     16U
+#define SCHED_PHASE_AUTO    (-1)    /* let SchedInit() pick the phase */
+#define SCHED_PREEMPT_EN    0       /* 1 to run the tasks as preemptive threads */
+#define SCHED_TICKLESS_EN   1       /* 1 to sleep in LLS through PwrIdle(),
+                                       cooperative build only */
+
+/* Task flags */
+#define SCHED_F_NONE        0x00U
+#define SCHED_F_WAKE        0x01U   /* only polls inputs that are also LLS wakeup
+                                       sources, so it is not a sleep deadline */
+
+/*******************************************************************************
+* Task table entry. Priorities are assigned rate-monotonic, 0 is highest, and
+* tasks due in the same slice run in priority order. In the preemptive build a
+* task only preempts tasks of a lower priority, so tasks that share data that
+* is not interrupt safe (LCD, TSI flags) must have the same priority.
+*******************************************************************************/
+typedef struct{
+    void (*task)(void);
+    INT16U period;          /* ms, multiple of SCHED_SLICE_MS */
+    INT16S phase;           /* ms offset into the period or SCHED_PHASE_AUTO */
+    INT8U prio;
+    INT16U wcet;            /* estimated worst case execution time in us */
+    INT8U flags;            /* SCHED_F_ bits */
+    const INT8C *name;
+}SCHED_TASK_T;
+
+typedef struct{
+    const INT8C *name;
+    INT16U period;          /* ms */
+    INT16U phase;           /* ms, as chosen by SchedInit() */
+    INT32U runs;
+    INT32U last;            /* cycles of the last run */
+    INT32U max;             /* cycles of the longest run */
+}SCHED_STATS_T;
+
+/*******************************************************************************
+* SchedInit(const SCHED_TASK_T *table, INT8U num) - PUBLIC
+*   parameter: table - task table, must stay valid while the scheduler runs
+*              num - number of tasks in table
+*   description: orders the tasks by priority, picks the phase of every
+*   SCHED_PHASE_AUTO task to spread the estimated load across slices and
+*   computes the worst case slice load. If that load is over the budget it is
+*   reported on BasicIO. BIOOpen() must be called first. Returns 0, or 1 if
+*   the hyperperiod is over SCHED_HYPER_MAX slices, which is reported and no
+*   task would run, so the caller must halt instead of calling SchedRun().
+*******************************************************************************/
+INT8U SchedInit(const SCHED_TASK_T *table, INT8U num);
+
+/*******************************************************************************
+* SchedRun() - PUBLIC
+*   parameter: none
+*   description: the time slice loop. Waits for every slice with
+*   SysTickWaitEvent() and runs the tasks that are due. A slice change from
+*   SchedSetSliceMs() is applied between slices. With SCHED_TICKLESS_EN
+*   the time until the next task without SCHED_F_WAKE is offered to PwrIdle()
+*   first and the slices it slept are skipped. With SCHED_PREEMPT_EN every task
+*   is started as a kernel thread instead. Never returns.
+*******************************************************************************/
+void SchedRun(void);
+
+/*******************************************************************************
+* SchedGetStats(INT8U index, SCHED_STATS_T *stats) - PUBLIC
+*   parameter: index - task index in the table
+*              stats - where the task timing is copied
+*   description: returns 0 if stats is valid, 1 if index is out of range
+*******************************************************************************/
+INT8U SchedGetStats(INT8U index, SCHED_STATS_T *stats);
+
+/*******************************************************************************
+* SchedGetWorstLoad() - PUBLIC
+*   parameter: none
+*   description: returns the estimated worst case slice load in us
+*******************************************************************************/
+INT32U SchedGetWorstLoad(void);
+
+/*******************************************************************************
+* SchedGetOverruns() - PUBLIC
+*   parameter: none
+*   description: returns the number of slices whose tasks ran past the slice
+*******************************************************************************/
+INT32U SchedGetOverruns(void);
+
+/*******************************************************************************
+* SchedSetSliceMs(INT16U ms) - PUBLIC
+*   parameter: ms - new slice length
+*   description: changes the slice at the start of the next slice and places
+*   the tasks again. Every task period must be a multiple of ms and the
+*   hyperperiod at most SCHED_HYPER_MAX slices of ms. Returns 0 if accepted,
+*   1 if not. Not supported in the preemptive build.
+*******************************************************************************/
+INT8U SchedSetSliceMs(INT16U ms);
+
+/*******************************************************************************
+* SchedGetSliceMs() - PUBLIC
+*   parameter: none
+*   description: returns the slice length in ms
+*******************************************************************************/
+INT16U SchedGetSliceMs(void);
+
+#endif
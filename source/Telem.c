@@ -0,0 +1,200 @@
+/*******************************************************************************
+* Telem.c
+*
+* This module contains a binary telemetry stream for tuning the detectors.
+* Raw channel values are collected into frames with a sequence number and a
+* CRC, COBS encoded so 0x00 only appears as the frame delimiter, and sent by
+* eDMA through BIOWriteBlock(). Two frame buffers are used so one can be
+* filled while the other is sent. The frame layout is in Telem.h and
+* tools/telem_decode.py decodes it to CSV.
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+/*******************************************************************************
+* Includes
+*******************************************************************************/
+#include "MCUType.h"
+#include "BasicIO.h"
+#include "SysTickDelay.h"
+#include "MemoryTools.h"
+#include "Telem.h"
+
+/*******************************************************************************
+* Private Resources
+*******************************************************************************/
+#define TELEM_HDR_LEN       8U
+#define TELEM_RAW_MAX       (TELEM_HDR_LEN + (TELEM_SAMPLES * TELEM_MAX_CH * 2U) + 2U)
+/* COBS adds a byte per 254, plus the two delimiters */
+#define TELEM_TX_MAX        (TELEM_RAW_MAX + (TELEM_RAW_MAX / 254U) + 3U)
+
+static const TELEM_CH_T *telemTable;
+static INT8U telemNum;
+static INT8U telemPeriod;
+static INT8U telemMask;
+static INT8U telemSeq;
+static INT8U telemRaw[TELEM_RAW_MAX];
+static INT16U telemRawLen;
+static INT8U telemSamples;
+static INT8U telemTx[2][TELEM_TX_MAX];
+static INT8U telemTxIdx;                    /* buffer not being sent */
+static TELEM_STATS_T telemStats;
+
+static void telemStart(void);
+static INT16U telemCobs(const INT8U *src, INT16U len, INT8U *dst);
+
+/******************************************************************************
+* Function Code
+******************************************************************************/
+
+/*******************************************************************************
+* TelemInit(const TELEM_CH_T *table, INT8U num, INT8U period) - PUBLIC
+*   parameter: table - channels, must stay valid
+*              num - number of channels, at most TELEM_MAX_CH
+*              period - ms between TelemTask() calls, sent in every frame
+*   description: sets up the stream, stopped. BIOOpen() must be called first.
+*******************************************************************************/
+void TelemInit(const TELEM_CH_T *table, INT8U num, INT8U period){
+    telemTable = table;
+    telemNum = (num > TELEM_MAX_CH) ? TELEM_MAX_CH : num;
+    telemPeriod = period;
+    telemMask = 0;
+    telemSeq = 0;
+    telemTxIdx = 0;
+    telemStats.frames = 0;
+    telemStats.dropped = 0;
+    telemStart();
+}
+
+/*******************************************************************************
+* TelemSetMask(INT8U mask) - PUBLIC
+*   parameter: mask - channels to stream, 0 stops the stream
+*   description: selects the channels. A partly filled frame is discarded.
+*******************************************************************************/
+void TelemSetMask(INT8U mask){
+    telemMask = mask & (INT8U)((1U << telemNum) - 1U);
+    telemStart();
+}
+
+/*******************************************************************************
+* TelemGetMask() - PUBLIC
+*   parameter: none
+*   description: returns the mask of the channels streamed
+*******************************************************************************/
+INT8U TelemGetMask(void){
+    return telemMask;
+}
+
+/*******************************************************************************
+* TelemTask() - PUBLIC
+*   parameter: none
+*   description: cooperative task. Samples every selected channel and, every
+*   TELEM_SAMPLES calls, encodes a frame and starts it with BIOWriteBlock().
+*   A frame that finds the UART busy, or the block channel held by a trace
+*   dump, is dropped but still uses a sequence number, so the host sees the
+*   gap.
+*******************************************************************************/
+void TelemTask(void){
+    INT8U ch;
+    INT16S val;
+    INT16U crc;
+    INT16U len;
+    INT32U now;
+    if(telemMask != 0){
+        if(telemSamples == 0){
+            now = SysTickGetmsCount();
+            telemRaw[2] = (INT8U)now;
+            telemRaw[3] = (INT8U)(now >> 8);
+            telemRaw[4] = (INT8U)(now >> 16);
+            telemRaw[5] = (INT8U)(now >> 24);
+        } else{}
+        for(ch = 0; ch < telemNum; ch++){
+            if((telemMask & (1U << ch)) != 0){
+                val = telemTable[ch].read();
+                telemRaw[telemRawLen] = (INT8U)val;
+                telemRaw[telemRawLen + 1U] = (INT8U)((INT16U)val >> 8);
+                telemRawLen += 2U;
+            } else{}
+        }
+        telemSamples++;
+        if(telemSamples >= TELEM_SAMPLES){
+            telemRaw[0] = telemSeq;
+            telemRaw[7] = telemSamples;
+            crc = MemCrc16(MEM_CRC16_INIT, telemRaw, telemRawLen);
+            telemRaw[telemRawLen] = (INT8U)crc;
+            telemRaw[telemRawLen + 1U] = (INT8U)(crc >> 8);
+            telemRawLen += 2U;
+            telemTx[telemTxIdx][0] = 0;
+            len = telemCobs(telemRaw, telemRawLen, &telemTx[telemTxIdx][1]);
+            telemTx[telemTxIdx][len + 1U] = 0;
+            if((BIOBlockHeld() == 0) &&
+               (BIOWriteBlock(telemTx[telemTxIdx], len + 2U) == 0)){
+                telemTxIdx ^= 1U;
+                telemStats.frames++;
+            } else{
+                telemStats.dropped++;
+            }
+            telemSeq++;
+            telemStart();
+        } else{}
+    } else{}
+}
+
+/*******************************************************************************
+* TelemGetStats(TELEM_STATS_T *stats) - PUBLIC
+*   parameter: stats - where the statistics are copied
+*   description: returns the frame counts
+*******************************************************************************/
+void TelemGetStats(TELEM_STATS_T *stats){
+    stats->frames = telemStats.frames;
+    stats->dropped = telemStats.dropped;
+}
+
+/*******************************************************************************
+* telemStart() - PRIVATE
+*   parameter: none
+*   description: starts a new frame with the fixed part of the header
+*******************************************************************************/
+static void telemStart(void){
+    telemRaw[1] = telemMask;
+    telemRaw[6] = telemPeriod;
+    telemRawLen = TELEM_HDR_LEN;
+    telemSamples = 0;
+}
+
+/*******************************************************************************
+* telemCobs() - PRIVATE
+*   parameter: src - raw frame
+*              len - raw frame length
+*              dst - encoded frame, at least len + len/254 + 1 bytes
+*   description: Consistent Overhead Byte Stuffing. Every 0x00 is replaced by
+*   the distance to the next one, so the encoded frame has no 0x00. Returns
+*   the encoded length.
+*******************************************************************************/
+static INT16U telemCobs(const INT8U *src, INT16U len, INT8U *dst){
+    INT16U in = 0;
+    INT16U out = 1;
+    INT16U code_pos = 0;
+    INT8U code = 1;
+    while(in < len){
+        if(src[in] == 0){
+            dst[code_pos] = code;
+            code_pos = out;
+            out++;
+            code = 1;
+        } else{
+            dst[out] = src[in];
+            out++;
+            code++;
+            if(code == 0xFFU){
+                dst[code_pos] = code;
+                code_pos = out;
+                out++;
+                code = 1;
+            } else{}
+        }
+        in++;
+    }
+    dst[code_pos] = code;
+    return out;
+}
@@ -0,0 +1,77 @@
+/*******************************************************************************
+* Telem.h
+*
+* This module contains all function prototypes and the channel table type for
+* Telem.c
+*
+* Frame, before COBS encoding, all values little-endian:
+*   [0]     sequence number, +1 per frame including frames dropped as busy
+*   [1]     channel mask, bit n is channel n of the table
+*   [2..5]  ms count of the first sample
+*   [6]     ms between samples
+*   [7]     number of samples
+*   [8..]   samples, each one INT16S per channel in the mask, lowest bit first
+*   [last2] CRC-16/CCITT of everything before it, MemCrc16()
+* The encoded frame is sent between two 0x00 delimiters.
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+#ifndef TELEMH
+#define TELEMH
+
+/*******************************************************************************
+* Definition of telemetry macros/constants
+*******************************************************************************/
+#define TELEM_MAX_CH        8U      /* channels in the table, one mask bit each */
+#define TELEM_SAMPLES       5U      /* samples per frame */
+
+typedef struct{
+    INT16S (*read)(void);           /* returns the current value of the channel */
+    const INT8C *name;
+}TELEM_CH_T;
+
+typedef struct{
+    INT32U frames;          /* frames started on the UART */
+    INT32U dropped;         /* frames dropped, UART busy or trace dump */
+}TELEM_STATS_T;
+
+/*******************************************************************************
+* TelemInit(const TELEM_CH_T *table, INT8U num, INT8U period) - PUBLIC
+*   parameter: table - channels, must stay valid
+*              num - number of channels, at most TELEM_MAX_CH
+*              period - ms between TelemTask() calls, sent in every frame
+*   description: sets up the stream, stopped. BIOOpen() must be called first.
+*******************************************************************************/
+void TelemInit(const TELEM_CH_T *table, INT8U num, INT8U period);
+
+/*******************************************************************************
+* TelemSetMask(INT8U mask) - PUBLIC
+*   parameter: mask - channels to stream, 0 stops the stream
+*   description: selects the channels. A partly filled frame is discarded.
+*******************************************************************************/
+void TelemSetMask(INT8U mask);
+
+/*******************************************************************************
+* TelemGetMask() - PUBLIC
+*   parameter: none
+*   description: returns the mask of the channels streamed
+*******************************************************************************/
+INT8U TelemGetMask(void);
+
+/*******************************************************************************
+* TelemTask() - PUBLIC
+*   parameter: none
+*   description: cooperative task. Samples every selected channel and, every
+*   TELEM_SAMPLES calls, encodes a frame and starts it with BIOWriteBlock().
+*******************************************************************************/
+void TelemTask(void);
+
+/*******************************************************************************
+* TelemGetStats(TELEM_STATS_T *stats) - PUBLIC
+*   parameter: stats - where the statistics are copied
+*   description: returns the frame counts
+*******************************************************************************/
+void TelemGetStats(TELEM_STATS_T *stats);
+
+#endif
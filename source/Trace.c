@@ -0,0 +1,162 @@
+/*******************************************************************************
+* Trace.c
+*
+* This module contains a binary trace recorder. TRACE() adds a record with a
+* DWT cycle stamp, an id and an argument to a RAM ring buffer from tasks and
+* ISRs for about twenty cycles, so it can stay on in production builds. The
+* buffer is sent in binary by TraceDumpStep() and tools/trace_view.py turns
+* it into a timeline and per task statistics.
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+/*******************************************************************************
+* Includes
+*******************************************************************************/
+#include "MCUType.h"
+#include "BasicIO.h"
+#include "Trace.h"
+
+/*******************************************************************************
+* Private Resources
+*******************************************************************************/
+typedef enum {TRACE_DUMP_DONE, TRACE_DUMP_HDR, TRACE_DUMP_OLD, TRACE_DUMP_NEW,
+              TRACE_DUMP_WAIT} TRACE_DUMP_T;
+
+static TRACE_REC_T traceBuf[TRACE_LEN];
+static volatile INT32U traceHead;           /* records since TraceInit() */
+static volatile INT32U traceMask;
+static INT32U traceSavedMask;               /* mask to restore after a dump */
+static TRACE_HDR_T traceHdr;
+static TRACE_DUMP_T traceDumpState;
+static INT32U traceDumpOld;                 /* index of the oldest record */
+
+/******************************************************************************
+* Function Code
+******************************************************************************/
+
+/*******************************************************************************
+* TraceInit() - PUBLIC
+*   parameter: none
+*   description: starts the DWT cycle counter and records with
+*   TRACE_MASK_DEFAULT
+*******************************************************************************/
+void TraceInit(void){
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    traceHead = 0;
+    traceDumpState = TRACE_DUMP_DONE;
+    traceMask = TRACE_MASK_DEFAULT;
+}
+
+/*******************************************************************************
+* TraceRec(INT16U id, INT32U arg) - PUBLIC
+*   parameter: id - TRACE_ID_T
+*              arg - record argument
+*   description: adds a record if id is in the mask, the oldest record is
+*   overwritten. The slot is reserved with LDREX/STREX like EvtPost(), so
+*   an ISR that interrupts a record gets the next slot. Runs from SRAM_L like
+*   the RAMFUNC handlers that call it, so a trace point does not take them
+*   back to flash.
+*******************************************************************************/
+RAMFUNC void TraceRec(INT16U id, INT32U arg){
+    TRACE_REC_T *rec;
+    INT32U idx;
+    if((traceMask & ((INT32U)1U << (id & 31U))) != 0){
+        do{
+            idx = __LDREXW((volatile uint32_t *)&traceHead);
+        }while(__STREXW(idx + 1U, (volatile uint32_t *)&traceHead) != 0);
+        rec = &traceBuf[idx & (TRACE_LEN - 1U)];
+        rec->cyc = DWT->CYCCNT;
+        rec->id = id;
+        rec->ctx = (INT16U)__get_IPSR();
+        rec->arg = arg;
+    } else{}
+}
+
+/*******************************************************************************
+* TraceSetMask(INT32U mask) - PUBLIC
+*   parameter: mask - TRACE_MASK() of every id to record, 0 stops recording
+*   description: selects the recorded ids. During a dump the mask is applied
+*   when the dump is done.
+*******************************************************************************/
+void TraceSetMask(INT32U mask){
+    if(traceDumpState == TRACE_DUMP_DONE){
+        traceMask = mask;
+    } else{
+        traceSavedMask = mask;
+    }
+}
+
+/*******************************************************************************
+* TraceGetMask() - PUBLIC
+*   parameter: none
+*   description: returns the recorded ids mask
+*******************************************************************************/
+INT32U TraceGetMask(void){
+    return (traceDumpState == TRACE_DUMP_DONE) ? traceMask : traceSavedMask;
+}
+
+/*******************************************************************************
+* TraceDumpStep(INT8U step) - PUBLIC
+*   parameter: step - 0 to start a dump, then any other value
+*   description: sends the buffer with BIOWriteBlock(), a header then the
+*   records oldest first in up to two blocks, as the ring may wrap. A block
+*   that finds the UART busy is tried again on the next call. The block
+*   channel is held for the whole dump, so no telemetry frame is sent inside
+*   it. Recording starts again when the last block is out. Returns 1 until
+*   the dump is done.
+*******************************************************************************/
+INT8U TraceDumpStep(INT8U step){
+    INT32U count;
+    INT32U newest;
+    if(step == 0){
+        traceSavedMask = traceMask;
+        traceMask = 0;
+        count = (traceHead > TRACE_LEN) ? TRACE_LEN : traceHead;
+        traceDumpOld = (traceHead - count) & (TRACE_LEN - 1U);
+        traceHdr.magic[0] = 'T';
+        traceHdr.magic[1] = 'R';
+        traceHdr.magic[2] = 'C';
+        traceHdr.magic[3] = '1';
+        traceHdr.count = (INT16U)count;
+        traceHdr.rec_size = (INT16U)sizeof(TRACE_REC_T);
+        traceHdr.cpu_hz = TRACE_CPU_HZ;
+        traceHdr.total = traceHead;
+        traceDumpState = TRACE_DUMP_HDR;
+        BIOBlockHold(1);
+    } else{}
+    switch(traceDumpState){
+    case TRACE_DUMP_HDR:
+        if(BIOWriteBlock((const INT8U *)&traceHdr, (INT16U)sizeof(traceHdr)) == 0){
+            traceDumpState = (traceHdr.count != 0) ? TRACE_DUMP_OLD : TRACE_DUMP_WAIT;
+        } else{}
+        break;
+    case TRACE_DUMP_OLD:
+        /* oldest record to the end of the buffer or to the newest record */
+        newest = traceDumpOld + traceHdr.count;
+        count = ((newest > TRACE_LEN) ? TRACE_LEN : newest) - traceDumpOld;
+        if(BIOWriteBlock((const INT8U *)&traceBuf[traceDumpOld],
+                         (INT16U)(count * sizeof(TRACE_REC_T))) == 0){
+            traceDumpState = (newest > TRACE_LEN) ? TRACE_DUMP_NEW : TRACE_DUMP_WAIT;
+        } else{}
+        break;
+    case TRACE_DUMP_NEW:
+        count = traceDumpOld + traceHdr.count - TRACE_LEN;
+        if(BIOWriteBlock((const INT8U *)&traceBuf[0],
+                         (INT16U)(count * sizeof(TRACE_REC_T))) == 0){
+            traceDumpState = TRACE_DUMP_WAIT;
+        } else{}
+        break;
+    case TRACE_DUMP_WAIT:
+        if(BIOTxIdle() != 0){
+            traceMask = traceSavedMask;     /* last block is out, record again */
+            traceDumpState = TRACE_DUMP_DONE;
+            BIOBlockHold(0);
+        } else{}
+        break;
+    default:
+        break;
+    }
+    return (traceDumpState != TRACE_DUMP_DONE) ? 1U : 0U;
+}
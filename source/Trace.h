@@ -0,0 +1,104 @@
+/*******************************************************************************
+* Trace.h
+*
+* This module contains all function prototypes, record types and the TRACE()
+* macro for Trace.c
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+#ifndef TRACEH
+#define TRACEH
+
+/*******************************************************************************
+* Definition of trace macros/constants
+*******************************************************************************/
+#define TRACE_EN            1       /* 0 compiles every TRACE() out */
+#define TRACE_LEN           256U    /* records kept, power of two */
+#define TRACE_CPU_HZ        180000000U  /* DWT cycle rate, sent in the dump */
+/* Ids recorded after TraceInit(). The SysTick and the PIT0 sample interrupt
+ * of the ISR sound backend are left out because they would fill the buffer
+ * in a quarter of a second or less. */
+#define TRACE_MASK_DEFAULT  (0xFFFFFFFFU & ~(TRACE_MASK(TRC_SYSTICK)|TRACE_MASK(TRC_PIT0)))
+#define TRACE_MASK(id)      ((INT32U)1U << (id))
+
+/* Record ids, below 32 so each has a mask bit. tools/trace_view.py has the
+ * same list. */
+typedef enum{
+    TRC_TASK_START = 1,     /* arg: scheduler task index */
+    TRC_TASK_END,           /* arg: scheduler task index */
+    TRC_SYSTICK,            /* arg: ms count */
+    TRC_PIT0,               /* arg: ISR backend CITER */
+    TRC_UART2,              /* arg: UART2 S1 */
+    TRC_UART2_DMA,          /* arg: block length */
+    TRC_LLWU,               /* arg: PWR_WAKE_ source bits */
+    TRC_RTC_SEC,            /* arg: RTC seconds count */
+    TRC_EVT,                /* arg: event type, dispatched */
+    TRC_SLEEP,              /* arg: ms to the next deadline */
+    TRC_WAKE,               /* arg: ms slept */
+    TRC_USER = 24           /* 24-31 free for temporary probes */
+}TRACE_ID_T;
+
+typedef struct{
+    INT32U cyc;             /* DWT cycle count */
+    INT16U id;
+    INT16U ctx;             /* IPSR, 0 in thread mode or the exception number */
+    INT32U arg;
+}TRACE_REC_T;
+
+/* Dump header, sent before the records, oldest record first */
+typedef struct{
+    INT8C magic[4];         /* "TRC1" */
+    INT16U count;           /* records that follow */
+    INT16U rec_size;        /* sizeof(TRACE_REC_T) */
+    INT32U cpu_hz;
+    INT32U total;           /* records since TraceInit(), count is the newest */
+}TRACE_HDR_T;
+
+#if TRACE_EN
+#define TRACE(id, arg)      TraceRec((INT16U)(id), (INT32U)(arg))
+#else
+#define TRACE(id, arg)
+#endif
+
+/*******************************************************************************
+* TraceInit() - PUBLIC
+*   parameter: none
+*   description: starts the DWT cycle counter and records with
+*   TRACE_MASK_DEFAULT
+*******************************************************************************/
+void TraceInit(void);
+
+/*******************************************************************************
+* TraceRec(INT16U id, INT32U arg) - PUBLIC
+*   parameter: id - TRACE_ID_T
+*              arg - record argument
+*   description: adds a record if id is in the mask, the oldest record is
+*   overwritten. Lock-free and safe to call from tasks and ISRs. Use TRACE().
+*******************************************************************************/
+void TraceRec(INT16U id, INT32U arg);
+
+/*******************************************************************************
+* TraceSetMask(INT32U mask) - PUBLIC
+*   parameter: mask - TRACE_MASK() of every id to record, 0 stops recording
+*   description: selects the recorded ids
+*******************************************************************************/
+void TraceSetMask(INT32U mask);
+
+/*******************************************************************************
+* TraceGetMask() - PUBLIC
+*   parameter: none
+*   description: returns the recorded ids mask
+*******************************************************************************/
+INT32U TraceGetMask(void);
+
+/*******************************************************************************
+* TraceDumpStep(INT8U step) - PUBLIC
+*   parameter: step - 0 to start a dump, then any other value
+*   description: sends the buffer with BIOWriteBlock(), a header then the
+*   records oldest first. Recording is stopped until the dump is done. Call
+*   until it returns 0, 1 means the dump is not finished.
+*******************************************************************************/
+INT8U TraceDumpStep(INT8U step);
+
+#endif
@@ -0,0 +1,56 @@
+/*******************************************************************************
+* WaveBank.c
+*
+* This module contains the waveform bank played by every WaveGenDMA.c backend.
+* Every table holds one cycle of 12 bit DAC samples starting at mid-scale, a
+* power of two long and aligned to its own size in bytes so the DMA can wrap
+* it with SMOD. Each waveform has its own sample rate. The tables are in
+* WaveTables.c, generated by tools/wave_tables.py from their waveform,
+* length, amplitude, offset and DAC bit depth.
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+/*******************************************************************************
+* Includes
+*******************************************************************************/
+#include "MCUType.h"
+#include "K65TWR_ClkCfg.h"
+#include "WaveTables.h"
+#include "WaveBank.h"
+
+/*******************************************************************************
+* Private Resources
+*******************************************************************************/
+/* Indexed by WAVE_TBL_T. Rates divide the bus clock exactly. */
+static const WAVE_BANK_T wbBank[WAVE_TBL_NUM] = {
+    {WaveTblSiren,  WAVE_TBL_SIREN_BITS,    19200U, "siren"},
+    {WaveTblSine,   WAVE_TBL_SINE_BITS,     19200U, "sine"},
+    {WaveTblSquare, WAVE_TBL_SQUARE_BITS,    9600U, "square"},
+    {WaveTblSweep,  WAVE_TBL_SWEEP_BITS,    16000U, "sweep"},
+    {WaveTblVoice,  WAVE_TBL_VOICE_BITS,    16000U, "voice"}
+};
+
+/******************************************************************************
+* Function Code
+******************************************************************************/
+
+/*******************************************************************************
+* WaveBankGet(WAVE_TBL_T wave) - PUBLIC
+*   parameter: wave - waveform
+*   description: returns the bank entry of the waveform, the siren sample for
+*   an invalid one
+*******************************************************************************/
+const WAVE_BANK_T *WaveBankGet(WAVE_TBL_T wave){
+    return (wave < WAVE_TBL_NUM) ? &wbBank[wave] : &wbBank[WAVE_TBL_SIREN];
+}
+
+/*******************************************************************************
+* WaveBankReload(INT32U rate) - PUBLIC
+*   parameter: rate - sample rate in Hz
+*   description: returns the PIT LDVAL, or PDB interval, for the rate from
+*   K65TWR_BUS_CLK_HZ, rounded to the nearest
+*******************************************************************************/
+INT32U WaveBankReload(INT32U rate){
+    return ((K65TWR_BUS_CLK_HZ + (rate / 2U)) / rate) - 1U;
+}
@@ -0,0 +1,48 @@
+/*******************************************************************************
+* WaveBank.h
+*
+* This module contains all function prototypes and the waveform ids for
+* WaveBank.c
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+#ifndef WAVEBANKH
+#define WAVEBANKH
+
+/*******************************************************************************
+* Definition of waveform bank macros/constants
+*******************************************************************************/
+typedef enum{
+    WAVE_TBL_SIREN,         /* the original 64 sample siren */
+    WAVE_TBL_SINE,
+    WAVE_TBL_SQUARE,
+    WAVE_TBL_SWEEP,
+    WAVE_TBL_VOICE,
+    WAVE_TBL_NUM
+}WAVE_TBL_T;
+
+typedef struct{
+    const INT16U *table;    /* one cycle, 2^bits samples, aligned to its size */
+    INT8U bits;
+    INT32U rate;            /* sample rate in Hz */
+    const INT8C *name;
+}WAVE_BANK_T;
+
+/*******************************************************************************
+* WaveBankGet(WAVE_TBL_T wave) - PUBLIC
+*   parameter: wave - waveform
+*   description: returns the bank entry of the waveform, the siren sample for
+*   an invalid one
+*******************************************************************************/
+const WAVE_BANK_T *WaveBankGet(WAVE_TBL_T wave);
+
+/*******************************************************************************
+* WaveBankReload(INT32U rate) - PUBLIC
+*   parameter: rate - sample rate in Hz
+*   description: returns the PIT LDVAL, or PDB interval, for the rate from
+*   K65TWR_BUS_CLK_HZ
+*******************************************************************************/
+INT32U WaveBankReload(INT32U rate);
+
+#endif
@@ -2,7 +2,32 @@
 * WaveGenDMA.c
 *
 * This module contains all function needed for producing the sound wave from
-* a lookup table using DMA.
+* a lookup table using DMA. The DMA plays a two block ping-pong buffer to the
+* DAC and interrupts at the half and the end of the buffer. The interrupt
+* refills the block just played from a phase accumulator oscillator (DDS)
+* stepping through the wave table, so the pitch can be swept for the wail,
+* yelp and hi-lo sirens.
+* The output has three backends with the same behavior, WAVE_BE_T. The DMA
+* one moves a sample per PIT0 trigger. The DAC buffer one sends the siren
+* and clips through the 16 word DAC buffer, stepped by the PDB DAC interval
+* trigger, and the DMA refills half of it at a time on the buffer top and
+* bottom flags, one request per WAVE_DAC_BURST samples. The ISR one has no
+* DMA: the PIT0 interrupt runs the same TCDs in software, a sample at a time.
+* WaveGenDMATestStep() measures the CPU cycles per sample of each backend.
+* Fixed patterns of tones and silences (chimes, pulses) are played with no
+* CPU at all by a chain of scatter-gather TCDs, one per segment, which loops
+* in hardware or stops at its end.
+* The waveform comes from WaveBank.c and sets the sample rate, the trigger
+* reload is computed from the bus clock when the siren or a pattern starts.
+* The interrupt handlers and everything they call, the block fills and
+* AdpcmDecode() included, run from SRAM_L, see RAMFUNC. Only the clip data is
+* read from flash. The siren increments are worked out for every siren when
+* the waveform is loaded, so no 64 bit division runs in the interrupt.
+* Recorded sounds from SoundClips.c stream through the same ping-pong buffer,
+* the interrupt decodes the next IMA-ADPCM block instead of running the DDS.
+* The siren and clips go through a gain stage as each block is filled, which
+* ramps up from silence at the start, down to silence before the stop and
+* between volume levels. At full volume the stage is skipped.
 *
 * Khoi Le, 12/01/2022
 *******************************************************************************/
@@ -18,31 +43,181 @@
 #include "SysTickDelay.h"
 #include "LCD.h"
 #include "Key.h"
-#include "WaveGen.h"
+#include "WaveBank.h"
+#include "Adpcm.h"
+#include "SoundClips.h"
 #include "WaveGenDMA.h"
+#include "Trace.h"
 
 /*******************************************************************************
 * Private Resources
 *******************************************************************************/
-static const INT16U wgdWaveTable[64] =
-{0x07FF,0x0CA4,0x0D60,0x0AA6,0x0836,0x085A,0x09A5,0x09AD,
- 0x0877,0x07F1,0x08C9,0x097C,0x08D5,0x07E1,0x0845,0x0989,
- 0x0999,0x0819,0x0793,0x0A36,0x0E4C,0x0F94,0x0C45,0x0763,
- 0x0544,0x06AC,0x089B,0x0889,0x0746,0x0711,0x0828,0x08C2,
- 0x07FF,0x073B,0x07D6,0x08ED,0x08B8,0x0775,0x0763,0x0952,
- 0x0ABA,0x089B,0x03B9,0x006A,0x01B2,0x05C8,0x086B,0x07E5,
- 0x0665,0x0675,0x07B9,0x081D,0x0729,0x0682,0x0735,0x080D,
- 0x0787,0x0651,0x0659,0x07A4,0x07C8,0x0558,0x029E,0x035A};
-
-static const INT16U wgdWaveTableOff[64] =
-{0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,
- 0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,
- 0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,
- 0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,
- 0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,
- 0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,
- 0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,
- 0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF,0x07FF};
+#define WAVE_DAC_MID        0x07FFU     /* DAC output while the siren is off */
+#define WAVE_DMAMUX_CFG     (DMAMUX_CHCFG_TRIG(1)|DMAMUX_CHCFG_SOURCE(60)) /* PIT0 gated, always on */
+#define WAVE_DMAMUX_DAC     DMAMUX_CHCFG_SOURCE(45)     /* DAC0 buffer flags */
+#define WAVE_DAC_BURST      8U          /* samples per DMA request, half the buffer */
+#define WAVE_DAC_DMOD       5U          /* 2^5 bytes, the 16 DAT registers */
+#define WAVE_PDB_TRG_SW     15U
+#define WAVE_PDB_MOD_MAX    0x10000U
+#define WAVE_BUF_SAMPLES    (NUM_BLOCKS*WAVE_SAMPLES_PER_BLOCK)
+#define WAVE_TEST_MS        200U        /* sound time per backend in the self-test */
+#define WAVE_CPU_PER_BUS    (180000000U / K65TWR_BUS_CLK_HZ)   /* PIT to DWT cycles */
+
+#define WAVE_ATTR(smod)     (DMA_ATTR_SMOD(smod) | DMA_ATTR_SSIZE(SIZE_CODE_16BIT) | \
+                             DMA_ATTR_DMOD(0) | DMA_ATTR_DSIZE(SIZE_CODE_16BIT))
+#define WAVE_CITER_MAX      0x7FFFU     /* CITER field without channel linking */
+#define WAVE_GAIN_UNITY     0x7FFF      /* Q15, the largest __SMULWB() factor */
+#define WAVE_DAC_MID2       ((WAVE_DAC_MID << 16) | WAVE_DAC_MID)  /* a sample pair */
+
+/* This CMSIS has no SMULWB/SMULWT intrinsics, same form as cmsis_gcc.h */
+#ifndef __SMULWB
+__STATIC_FORCEINLINE int32_t __SMULWB(int32_t op1, uint32_t op2){
+    int32_t result;
+    __ASM volatile ("smulwb %0, %1, %2" : "=r" (result) : "r" (op1), "r" (op2) );
+    return(result);
+}
+#endif
+#ifndef __SMULWT
+__STATIC_FORCEINLINE int32_t __SMULWT(int32_t op1, uint32_t op2){
+    int32_t result;
+    __ASM volatile ("smulwt %0, %1, %2" : "=r" (result) : "r" (op1), "r" (op2) );
+    return(result);
+}
+#endif
+
+typedef struct{
+    INT16U lo;              /* lowest tone in Hz */
+    INT16U hi;              /* highest tone in Hz */
+    INT16U sweep_ms;        /* lo to hi time, 0 for no sweep */
+    INT16U hold_ms;         /* time per tone for hi-lo, 0 for a sweep */
+}WAVE_SIREN_CFG_T;
+
+/* Indexed by WAVE_SIREN_T */
+static const WAVE_SIREN_CFG_T wgdSirens[WAVE_SIREN_NUM] = {
+    {300,   300,    0,      0},
+    {600,   1200,   2000,   0},
+    {600,   1200,   150,    0},
+    {770,   960,    0,      500}
+};
+
+/* A siren in phase increments and blocks at the sample rate */
+typedef struct{
+    INT32U lo;
+    INT32U hi;
+    INT32U step;            /* per block */
+    INT16U hold;            /* blocks */
+}WAVE_SIREN_INC_T;
+
+/* Hardware TCD layout, loaded by the eDMA from DLAST_SGA */
+typedef struct{
+    INT32U saddr;
+    INT16U soff;
+    INT16U attr;
+    INT32U nbytes;
+    INT32U slast;
+    INT32U daddr;
+    INT16U doff;
+    INT16U citer;
+    INT32U dlast_sga;
+    INT16U csr;
+    INT16U biter;
+}WAVE_TCD_T;
+
+/* Pattern segment: a tone of harm x the waveform base frequency, rate/length,
+ * 300Hz for the 64 sample 19.2kHz ones, or silence for harm 0 */
+typedef struct{
+    INT8U harm;
+    INT16U ms;              /* at most 1700, tones are cut to whole cycles */
+}WAVE_SEG_T;
+
+typedef struct{
+    const WAVE_SEG_T *segs;
+    INT8U num;              /* at most WAVE_TCD_MAX */
+    INT8U loop;             /* 1 to loop in hardware, 0 to play once */
+}WAVE_PAT_CFG_T;
+
+static const WAVE_SEG_T wgdChime[] = {{4, 150}, {0, 40}, {3, 150}, {0, 40}, {2, 300}, {0, 20}};
+static const WAVE_SEG_T wgdPulse[] = {{3, 200}, {0, 800}};
+static const WAVE_SEG_T wgdTone[] = {{2, 1000}};
+
+/* Indexed by WAVE_PAT_T */
+static const WAVE_PAT_CFG_T wgdPats[WAVE_PAT_NUM] = {
+    {wgdChime, (INT8U)(sizeof(wgdChime)/sizeof(wgdChime[0])), 0},
+    {wgdPulse, (INT8U)(sizeof(wgdPulse)/sizeof(wgdPulse[0])), 1},
+    {wgdTone,  (INT8U)(sizeof(wgdTone)/sizeof(wgdTone[0])),   1}
+};
+
+typedef enum {WAVE_MODE_OFF, WAVE_MODE_SIREN, WAVE_MODE_PAT, WAVE_MODE_CLIP} WAVE_MODE_T;
+
+void WAVE_DMA_IRQHandler(void);
+void PIT0_IRQHandler(void);
+
+static WAVE_TCD_T wgdTcds[WAVE_TCD_MAX] __attribute__((aligned(32)));
+static WAVE_TCD_T wgdSirenTcd;
+static const INT16U wgdMid = WAVE_DAC_MID;  /* source of the silence segments */
+static volatile WAVE_MODE_T wgdMode;
+
+static INT16U wgdBuf[NUM_BLOCKS*WAVE_SAMPLES_PER_BLOCK] __attribute__((aligned(4)));
+static WAVE_SIREN_INC_T wgdSirenIncs[WAVE_SIREN_NUM];  /* wgdSirens at wgdRate */
+static volatile WAVE_SIREN_T wgdSirenSel = WAVE_SIREN_WAIL;
+static WAVE_SIREN_T wgdSirenCur;
+static INT32U wgdPhase;
+static INT32U wgdInc;
+static INT32U wgdLo;                        /* siren playing, from wgdSirenIncs */
+static INT32U wgdHi;
+static INT32U wgdStep;                      /* per block */
+static INT16U wgdHold;                      /* blocks */
+static INT16U wgdHoldCnt;
+static INT8U wgdSweepUp;
+
+static volatile WAVE_TBL_T wgdWaveSel = WAVE_TBL_SIREN;
+static const INT16U *wgdTable;              /* waveform playing */
+static INT8U wgdBits;
+static INT32U wgdRate;
+static INT32U wgdReload;
+
+static const SOUND_CLIP_T *wgdClip;         /* clip playing */
+static ADPCM_STATE_T wgdAdpcm;
+static INT32U wgdClipPos;                   /* next sample to decode */
+static INT8U wgdTail;                       /* silent blocks filled before the stop */
+
+static volatile INT8U wgdVol = WAVE_VOL_MAX;
+static volatile INT32S wgdGainVol = WAVE_GAIN_UNITY;   /* wgdVol in Q15 */
+static INT32S wgdGain;                      /* Q15 gain of the last sample pair */
+static INT32S wgdAttack;                    /* gain steps per sample pair */
+static INT32S wgdRelease;
+static volatile INT8U wgdReleasing;         /* ramping down to the stop */
+
+static volatile WAVE_BE_T wgdBe = WAVE_BE_DEFAULT;
+static WAVE_TCD_T wgdSw;                    /* TCD run by PIT0_IRQHandler() */
+static INT32U wgdSwMask;                    /* SMOD wrap of wgdSw.saddr, 0 for none */
+static volatile INT8U wgdProfOn;
+static volatile INT32U wgdProfCyc;          /* CPU cycles in the output interrupts */
+static volatile INT32U wgdProfSamples;      /* samples filled meanwhile */
+static volatile INT32U wgdProfCycMax;
+static volatile INT32U wgdProfLatMax;       /* PIT0 counts */
+static WAVE_BE_T wgdTestBe;
+static WAVE_BE_T wgdTestSaved;
+static INT8U wgdTestClip;                   /* clip tested, or WAVE_TEST_SIREN */
+static INT32U wgdTestStart;
+
+static void wgdWaveLoad(void);
+static void wgdSirenCalc(void);
+static void wgdSirenLoad(void);
+static void wgdStart(void);
+static void wgdFill(INT16U *block);
+static void wgdClipFill(INT16U *block);
+static void wgdNext(INT16U *block);
+static void wgdGainFill(INT16U *block);
+static void wgdRampLoad(void);
+static void wgdStream(void);
+static void wgdStop(void);
+static void wgdRun(const WAVE_TCD_T *tcd, INT8U chcfg);
+static void wgdRunDMA(const WAVE_TCD_T *tcd, INT8U chcfg);
+static void wgdTrigger(void);
+static void wgdRefill(INT16U citer, INT16U biter);
+static void wgdSwLoad(const WAVE_TCD_T *tcd);
+static void wgdTestPlay(void);
 
 /******************************************************************************
 * Function Code
@@ -52,8 +227,10 @@ static const INT16U wgdWaveTableOff[64] =
 * WaveGenDMAInit() - PUBLIC
 *   parameter: none
 *   description: Initialization anything needed to generate the sound wave,
-*   which are PIT, DAC, and DMA. This function must be call before
-*   WaveGenDMAEnable()
+*   which are PIT, PDB, DAC, and DMA, for every backend. The fixed part of
+*   the siren TCD is built here and the output is left off with the DAC at
+*   mid-scale.
+*   This function must be call before WaveGenDMAEnable()
 *******************************************************************************/
 void WaveGenDMAInit(void){
     SIM->SCGC6 |= SIM_SCGC6_DMAMUX_MASK;
@@ -64,62 +241,767 @@ void WaveGenDMAInit(void){
     DAC0->C0 |= DAC_C0_DACRFS(1);
     DAC0->C0 |= DAC_C0_DACTRGSEL(1);
     DAC0->C1 |= DAC_C1_DMAEN(1);
+    DAC0->DAT[0].DATL = DAC_DATL_DATA0(WAVE_DAC_MID);
+    DAC0->DAT[0].DATH = DAC_DATH_DATA1(WAVE_DAC_MID >> 8);
 
     SIM->SCGC6 |= SIM_SCGC6_PIT(1); //Turn on PIT clock
     PIT->MCR = PIT_MCR_MDIS(0);     //Enable PIT clock
-    PIT->CHANNEL[0].LDVAL = 3124;   //set Tep to 52us (Buss clock = 60MHz)
-    // Enable ints, start Timer 0
-    PIT->CHANNEL[0].TCTRL = (PIT_TCTRL_TIE(1)|PIT_TCTRL_TEN(1));
+    PIT->CHANNEL[0].TCTRL = 0;      //Timer 0 only runs while a sound plays
+    SIM->SCGC6 |= SIM_SCGC6_PDB_MASK;
+    DAC0->C2 = DAC_C2_DACBFUP(15U);
+
+    DMAMUX->CHCFG[WAVE_DMA_OUT_CH] = WAVE_DMAMUX_CFG;
+    wgdSirenTcd.saddr = (INT32U)wgdBuf;
+    wgdSirenTcd.soff = WAVE_BYTES_PER_SAMPLE;
+    wgdSirenTcd.slast = (INT32U)(-(WAVE_BYTES_PER_BUFFER));
+    wgdSirenTcd.daddr = (INT32U)&DAC0->DAT[0].DATL;
+    wgdSirenTcd.dlast_sga = 0;
+    wgdSirenTcd.csr = DMA_CSR_BWC(3) | DMA_CSR_INTHALF(1) | DMA_CSR_INTMAJOR(1);
+    wgdMode = WAVE_MODE_OFF;
+    NVIC_EnableIRQ(WAVE_DMA_IRQn);
+    NVIC_EnableIRQ(PIT0_IRQn);
 }
 
 /*******************************************************************************
 * WaveGenDMAEnable(INT8U mode) - PUBLIC
 *   parameter: mode - 1 to enable wave, 0 to disable wave
 *   description: the function takes the parameter (mode) to either enable or
-*   disable the sound wave
+*   disable the sound wave. Off stops the siren or pattern and parks the DAC
+*   at mid-scale, so no DMA requests are made. The siren or a clip ramps down
+*   first over WAVE_RELEASE_MS and stops in the output interrupt. On fills both
+*   blocks from phase 0 and gain 0, loads the siren TCD and starts it.
 *******************************************************************************/
 void WaveGenDMAEnable(INT8U mode){
     if(mode == 1){
-        DMAMUX->CHCFG[WAVE_DMA_OUT_CH] &= ~(DMAMUX_CHCFG_ENBL_MASK|DMAMUX_CHCFG_TRIG_MASK);
-        DMA0->TCD[WAVE_DMA_OUT_CH].SADDR = DMA_SADDR_SADDR(wgdWaveTable);
-        DMA0->TCD[WAVE_DMA_OUT_CH].ATTR = DMA_ATTR_SMOD(0) | DMA_ATTR_SSIZE(SIZE_CODE_16BIT)
-                                        | DMA_ATTR_DMOD(0) | DMA_ATTR_DSIZE(SIZE_CODE_16BIT);
-        DMA0->TCD[WAVE_DMA_OUT_CH].SOFF = DMA_SOFF_SOFF(WAVE_BYTES_PER_SAMPLE);
-        DMA0->TCD[WAVE_DMA_OUT_CH].SLAST = DMA_SLAST_SLAST(-(WAVE_BYTES_PER_BLOCK));
-        DMA0->TCD[WAVE_DMA_OUT_CH].DADDR = DMA_DADDR_DADDR(&DAC0->DAT[0].DATL);
-        DMA0->TCD[WAVE_DMA_OUT_CH].DOFF = DMA_DOFF_DOFF(0);
-        DMA0->TCD[WAVE_DMA_OUT_CH].DLAST_SGA = DMA_DLAST_SGA_DLASTSGA(0);
-        DMA0->TCD[WAVE_DMA_OUT_CH].NBYTES_MLNO = DMA_NBYTES_MLNO_NBYTES(WAVE_BYTES_PER_SAMPLE);
-        DMA0->TCD[WAVE_DMA_OUT_CH].CITER_ELINKNO = DMA_CITER_ELINKNO_ELINK(0)|
-                                                   DMA_CITER_ELINKNO_CITER(WAVE_SAMPLES_PER_BLOCK);
-        DMA0->TCD[WAVE_DMA_OUT_CH].BITER_ELINKNO = DMA_BITER_ELINKNO_ELINK(0)|
-                                                   DMA_BITER_ELINKNO_BITER(WAVE_SAMPLES_PER_BLOCK);
-        DMA0->TCD[WAVE_DMA_OUT_CH].CSR = DMA_CSR_ESG(0) | DMA_CSR_MAJORELINK(0) |
-                                         DMA_CSR_BWC(3) | DMA_CSR_INTHALF(0) |
-                                         DMA_CSR_INTMAJOR(0) | DMA_CSR_DREQ(0) |
-                                         DMA_CSR_START(0);
-        DMAMUX->CHCFG[WAVE_DMA_OUT_CH] = DMAMUX_CHCFG_ENBL(1)|DMAMUX_CHCFG_TRIG(1)|DMAMUX_CHCFG_SOURCE(60);
-        DMA0->SERQ = DMA_SERQ_SERQ(WAVE_DMA_OUT_CH);
+        wgdStop();
+        wgdWaveLoad();
+        wgdStart();
+        wgdMode = WAVE_MODE_SIREN;
+        wgdRampLoad();
+        wgdNext(&wgdBuf[0]);
+        wgdNext(&wgdBuf[WAVE_SAMPLES_PER_BLOCK]);
+        wgdStream();
     } else if(mode == 0){
-        DMAMUX->CHCFG[WAVE_DMA_OUT_CH] &= ~(DMAMUX_CHCFG_ENBL_MASK|DMAMUX_CHCFG_TRIG_MASK);
-        DMA0->TCD[WAVE_DMA_OUT_CH].SADDR = DMA_SADDR_SADDR(wgdWaveTableOff);
-        DMA0->TCD[WAVE_DMA_OUT_CH].ATTR = DMA_ATTR_SMOD(0) | DMA_ATTR_SSIZE(SIZE_CODE_16BIT)
-                                        | DMA_ATTR_DMOD(0) | DMA_ATTR_DSIZE(SIZE_CODE_16BIT);
-        DMA0->TCD[WAVE_DMA_OUT_CH].SOFF = DMA_SOFF_SOFF(WAVE_BYTES_PER_SAMPLE);
-        DMA0->TCD[WAVE_DMA_OUT_CH].SLAST = DMA_SLAST_SLAST(-(WAVE_BYTES_PER_BLOCK));
-        DMA0->TCD[WAVE_DMA_OUT_CH].DADDR = DMA_DADDR_DADDR(&DAC0->DAT[0].DATL);
-        DMA0->TCD[WAVE_DMA_OUT_CH].DOFF = DMA_DOFF_DOFF(0);
-        DMA0->TCD[WAVE_DMA_OUT_CH].DLAST_SGA = DMA_DLAST_SGA_DLASTSGA(0);
-        DMA0->TCD[WAVE_DMA_OUT_CH].NBYTES_MLNO = DMA_NBYTES_MLNO_NBYTES(WAVE_BYTES_PER_SAMPLE);
-        DMA0->TCD[WAVE_DMA_OUT_CH].CITER_ELINKNO = DMA_CITER_ELINKNO_ELINK(0)|
-                                                   DMA_CITER_ELINKNO_CITER(WAVE_SAMPLES_PER_BLOCK);
-        DMA0->TCD[WAVE_DMA_OUT_CH].BITER_ELINKNO = DMA_BITER_ELINKNO_ELINK(0)|
-                                                   DMA_BITER_ELINKNO_BITER(WAVE_SAMPLES_PER_BLOCK);
-        DMA0->TCD[WAVE_DMA_OUT_CH].CSR = DMA_CSR_ESG(0) | DMA_CSR_MAJORELINK(0) |
-                                         DMA_CSR_BWC(3) | DMA_CSR_INTHALF(0) |
-                                         DMA_CSR_INTMAJOR(0) | DMA_CSR_DREQ(0) |
-                                         DMA_CSR_START(0);
-        DMAMUX->CHCFG[WAVE_DMA_OUT_CH] = DMAMUX_CHCFG_ENBL(1)|DMAMUX_CHCFG_TRIG(1)|DMAMUX_CHCFG_SOURCE(60);
-        DMA0->SERQ = DMA_SERQ_SERQ(WAVE_DMA_OUT_CH);
+        if(((wgdMode == WAVE_MODE_SIREN) || (wgdMode == WAVE_MODE_CLIP)) && (wgdGain != 0)){
+            wgdReleasing = 1;
+        } else{
+            wgdStop();
+        }
+    } else{}
+}
+
+/*******************************************************************************
+* WaveGenDMAPlayClip(INT8U clip) - PUBLIC
+*   parameter: clip - SoundClips.c clip number
+*   description: stops the output and plays a recorded clip at its own sample
+*   rate. Both blocks are decoded here, then the DMA interrupt decodes a block
+*   at a time, about 25 cycles a sample. The output stops by itself after the
+*   last sample. Returns 0 if started, 1 if there is no such clip.
+*******************************************************************************/
+INT8U WaveGenDMAPlayClip(INT8U clip){
+    INT8U rval = 0;
+    const SOUND_CLIP_T *sound = SoundClipGet(clip);
+    if(sound != (const SOUND_CLIP_T *)0){
+        wgdStop();
+        wgdClip = sound;
+        wgdAdpcm.pred = sound->pred;
+        wgdAdpcm.index = sound->index;
+        wgdClipPos = 0;
+        wgdRate = sound->rate;
+        wgdReload = WaveBankReload(wgdRate);
+        wgdMode = WAVE_MODE_CLIP;
+        wgdRampLoad();
+        wgdNext(&wgdBuf[0]);
+        wgdNext(&wgdBuf[WAVE_SAMPLES_PER_BLOCK]);
+        wgdStream();
+    } else{
+        rval = 1;
+    }
+    return rval;
+}
+
+/*******************************************************************************
+* WaveGenDMAPlay(WAVE_PAT_T pat) - PUBLIC
+*   parameter: pat - pattern to play
+*   description: stops the output, builds a scatter-gather TCD per segment of
+*   the pattern and starts the chain. The DMA plays it with no interrupts,
+*   except one at the end of a pattern that plays once. The ISR backend steps
+*   through the same chain in PIT0_IRQHandler().
+*******************************************************************************/
+void WaveGenDMAPlay(WAVE_PAT_T pat){
+    const WAVE_PAT_CFG_T *cfg;
+    const WAVE_SEG_T *seg;
+    WAVE_TCD_T *tcd;
+    INT32U samples;
+    INT32U len;
+    INT8U idx;
+    if(pat < WAVE_PAT_NUM){
+        wgdStop();
+        wgdWaveLoad();
+        len = (INT32U)1U << wgdBits;
+        cfg = &wgdPats[pat];
+        for(idx = 0; idx < cfg->num; idx++){
+            seg = &cfg->segs[idx];
+            tcd = &wgdTcds[idx];
+            samples = ((INT32U)seg->ms * wgdRate) / 1000U;
+            if(samples > WAVE_CITER_MAX){
+                samples = WAVE_CITER_MAX;
+            } else{}
+            if(seg->harm != 0){
+                /* whole cycles so the next segment starts from mid-scale */
+                samples &= ~(len - 1U);
+                if(samples == 0){
+                    samples = len;
+                } else{}
+                tcd->saddr = (INT32U)wgdTable;
+                tcd->soff = (INT16U)(seg->harm * WAVE_BYTES_PER_SAMPLE);
+                tcd->attr = WAVE_ATTR(wgdBits + 1U);    /* SMOD wraps the table */
+            } else{
+                if(samples == 0){
+                    samples = 1;
+                } else{}
+                tcd->saddr = (INT32U)&wgdMid;
+                tcd->soff = 0;
+                tcd->attr = WAVE_ATTR(0);
+            }
+            tcd->nbytes = WAVE_BYTES_PER_SAMPLE;
+            tcd->slast = 0;
+            tcd->daddr = (INT32U)&DAC0->DAT[0].DATL;
+            tcd->doff = 0;
+            tcd->citer = (INT16U)samples;
+            tcd->biter = (INT16U)samples;
+            if((idx + 1U) < cfg->num){
+                tcd->dlast_sga = (INT32U)&wgdTcds[idx + 1U];
+                tcd->csr = DMA_CSR_BWC(3) | DMA_CSR_ESG(1);
+            } else if(cfg->loop != 0){
+                tcd->dlast_sga = (INT32U)&wgdTcds[0];
+                tcd->csr = DMA_CSR_BWC(3) | DMA_CSR_ESG(1);
+            } else{
+                tcd->dlast_sga = 0;
+                tcd->csr = DMA_CSR_BWC(3) | DMA_CSR_DREQ(1) | DMA_CSR_INTMAJOR(1);
+            }
+        }
+        wgdMode = WAVE_MODE_PAT;
+        wgdRun(&wgdTcds[0], WAVE_DMAMUX_CFG);
+        wgdTrigger();
+    } else{}
+}
+
+/*******************************************************************************
+* WaveGenDMAActive() - PUBLIC
+*   parameter: none
+*   description: returns 1 while the siren, a pattern or a clip plays, 0 if
+*   not
+*******************************************************************************/
+INT8U WaveGenDMAActive(void){
+    return (wgdMode != WAVE_MODE_OFF) ? 1U : 0U;
+}
+
+/*******************************************************************************
+* WaveGenDMASetSiren(WAVE_SIREN_T siren) - PUBLIC
+*   parameter: siren - tone pattern
+*   description: selects the siren. While the siren plays the change is made
+*   at the next block, with no phase step.
+*******************************************************************************/
+void WaveGenDMASetSiren(WAVE_SIREN_T siren){
+    if(siren < WAVE_SIREN_NUM){
+        wgdSirenSel = siren;
+    } else{}
+}
+
+/*******************************************************************************
+* WaveGenDMAGetSiren() - PUBLIC
+*   parameter: none
+*   description: returns the selected siren
+*******************************************************************************/
+WAVE_SIREN_T WaveGenDMAGetSiren(void){
+    return wgdSirenSel;
+}
+
+/*******************************************************************************
+* WaveGenDMASetWave(WAVE_TBL_T wave) - PUBLIC
+*   parameter: wave - waveform of the bank
+*   description: selects the waveform, and with it the sample rate, for the
+*   next WaveGenDMAEnable(1) or WaveGenDMAPlay()
+*******************************************************************************/
+void WaveGenDMASetWave(WAVE_TBL_T wave){
+    if(wave < WAVE_TBL_NUM){
+        wgdWaveSel = wave;
+    } else{}
+}
+
+/*******************************************************************************
+* WaveGenDMAGetWave() - PUBLIC
+*   parameter: none
+*   description: returns the selected waveform
+*******************************************************************************/
+WAVE_TBL_T WaveGenDMAGetWave(void){
+    return wgdWaveSel;
+}
+
+/*******************************************************************************
+* WaveGenDMASetVolume(INT8U vol) - PUBLIC
+*   parameter: vol - 0 to WAVE_VOL_MAX
+*   description: sets the siren and clip volume. While they play the gain
+*   ramps to the new level at the attack or release rate, no table changes.
+*******************************************************************************/
+void WaveGenDMASetVolume(INT8U vol){
+    if(vol <= WAVE_VOL_MAX){
+        wgdVol = vol;
+        wgdGainVol = ((INT32S)vol * WAVE_GAIN_UNITY) / (INT32S)WAVE_VOL_MAX;
+    } else{}
+}
+
+/*******************************************************************************
+* WaveGenDMAGetVolume() - PUBLIC
+*   parameter: none
+*   description: returns the volume
+*******************************************************************************/
+INT8U WaveGenDMAGetVolume(void){
+    return wgdVol;
+}
+
+/*******************************************************************************
+* WaveGenDMASetBackend(WAVE_BE_T be) - PUBLIC
+*   parameter: be - output backend
+*   description: stops the output and selects the backend of the next sound
+*******************************************************************************/
+void WaveGenDMASetBackend(WAVE_BE_T be){
+    if(be < WAVE_BE_NUM){
+        wgdStop();
+        wgdBe = be;
+    } else{}
+}
+
+/*******************************************************************************
+* WaveGenDMAGetBackend() - PUBLIC
+*   parameter: none
+*   description: returns the output backend
+*******************************************************************************/
+WAVE_BE_T WaveGenDMAGetBackend(void){
+    return wgdBe;
+}
+
+/*******************************************************************************
+* WaveGenDMAProfStart() - PUBLIC
+*   parameter: none
+*   description: starts the DWT cycle counter if it is off and counts the
+*   cycles spent in the output interrupts and the samples they fill from 0
+*******************************************************************************/
+void WaveGenDMAProfStart(void){
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    wgdProfOn = 0;
+    wgdProfCyc = 0;
+    wgdProfSamples = 0;
+    wgdProfCycMax = 0;
+    wgdProfLatMax = 0;
+    wgdProfOn = 1;
+}
+
+/*******************************************************************************
+* WaveGenDMAProfGet(WAVE_PROF_T *prof) - PUBLIC
+*   parameter: prof - cycles and samples since WaveGenDMAProfStart()
+*   description: reads the counts and stops counting
+*******************************************************************************/
+void WaveGenDMAProfGet(WAVE_PROF_T *prof){
+    wgdProfOn = 0;
+    prof->cycles = wgdProfCyc;
+    prof->samples = wgdProfSamples;
+    prof->cyc_max = wgdProfCycMax;
+    prof->lat_max = wgdProfLatMax * WAVE_CPU_PER_BUS;
+}
+
+/*******************************************************************************
+* WaveGenDMATestStep(INT8U step, INT8U clip, WAVE_PROF_T *prof) - PUBLIC
+*   parameter: step - 0 to start the self-test, then any other value
+*              clip - SoundClips.c clip to profile, or WAVE_TEST_SIREN
+*              prof - WAVE_BE_NUM results, indexed by WAVE_BE_T
+*   description: plays the selected siren or the clip WAVE_TEST_MS on each
+*   backend in turn and profiles it, without blocking. The first block fills,
+*   with the attack ramp, are included as they would be in use. A clip
+*   shorter than that is profiled to its end. The output is left off with the
+*   backend as it was. Returns 1 until the test is done.
+*******************************************************************************/
+INT8U WaveGenDMATestStep(INT8U step, INT8U clip, WAVE_PROF_T *prof){
+    INT8U rval = 1;
+    if(step == 0){
+        wgdTestSaved = wgdBe;
+        wgdTestClip = clip;
+        wgdTestBe = (WAVE_BE_T)0;
+        wgdTestPlay();
+    } else if((SysTickGetmsCount() - wgdTestStart) >= WAVE_TEST_MS){
+        WaveGenDMAProfGet(&prof[wgdTestBe]);
+        wgdTestBe++;
+        if(wgdTestBe < WAVE_BE_NUM){
+            wgdTestPlay();
+        } else{
+            WaveGenDMASetBackend(wgdTestSaved);
+            rval = 0;
+        }
     } else{}
+    return rval;
+}
+
+/*******************************************************************************
+* wgdTestPlay() - PRIVATE
+*   parameter: none
+*   description: starts the sound of the self-test on wgdTestBe and profiles
+*   it from the start
+*******************************************************************************/
+static void wgdTestPlay(void){
+    WaveGenDMASetBackend(wgdTestBe);
+    if(wgdTestClip == WAVE_TEST_SIREN){
+        WaveGenDMAEnable(1);
+    } else{
+        (void)WaveGenDMAPlayClip(wgdTestClip);
+    }
+    WaveGenDMAProfStart();
+    wgdTestStart = SysTickGetmsCount();
+}
+
+/*******************************************************************************
+* WAVE_DMA_IRQHandler() - PRIVATE
+*   parameter: none
+*   description: DMA half and major loop interrupt. For the siren and clips
+*   the block the DMA is not reading is refilled, see wgdRefill(). For a
+*   pattern it is the end of a pattern that plays once. Runs from SRAM_L.
+*******************************************************************************/
+RAMFUNC void WAVE_DMA_IRQHandler(void){
+    INT32U start = DWT->CYCCNT;
+    INT32U cyc;
+    DMA0->CINT = DMA_CINT_CINT(WAVE_DMA_OUT_CH);
+    wgdRefill((INT16U)(DMA0->TCD[WAVE_DMA_OUT_CH].CITER_ELINKNO & DMA_CITER_ELINKNO_CITER_MASK),
+              wgdSirenTcd.biter);
+    if(wgdProfOn != 0){
+        cyc = DWT->CYCCNT - start;
+        wgdProfCyc += cyc;
+        if(cyc > wgdProfCycMax){
+            wgdProfCycMax = cyc;
+        } else{}
+    } else{}
+}
+
+/*******************************************************************************
+* PIT0_IRQHandler() - PIT0 interrupt service routine
+*   parameter: none
+*   description: the ISR backend. Sends a sample to the DAC and steps wgdSw
+*   the way the eDMA steps a TCD: SOFF with the SMOD wrap, SLAST and a
+*   scatter-gather load at the major loop end, and a refill at the half and
+*   major loop interrupts, so it plays the same siren, clip and pattern TCDs.
+*   Runs from SRAM_L. The PIT counts down from LDVAL after the trigger, so
+*   LDVAL - CVAL at entry is the entry latency.
+*******************************************************************************/
+RAMFUNC void PIT0_IRQHandler(void){
+    INT32U lat = PIT->CHANNEL[0].LDVAL - PIT->CHANNEL[0].CVAL;
+    INT32U start = DWT->CYCCNT;
+    INT32U cyc;
+    INT16U sample;
+    PIT->CHANNEL[0].TFLG = PIT_TFLG_TIF(1);
+    TRACE(TRC_PIT0, wgdSw.citer);
+    sample = *(const INT16U *)wgdSw.saddr;
+    DAC0->DAT[0].DATL = DAC_DATL_DATA0(sample);
+    DAC0->DAT[0].DATH = DAC_DATH_DATA1(sample >> 8);
+    if(wgdSwMask != 0){
+        wgdSw.saddr = (wgdSw.saddr & ~wgdSwMask) | ((wgdSw.saddr + wgdSw.soff) & wgdSwMask);
+    } else{
+        wgdSw.saddr += wgdSw.soff;
+    }
+    wgdSw.citer--;
+    if(wgdSw.citer == 0){
+        wgdSw.saddr += wgdSw.slast;
+        wgdSw.citer = wgdSw.biter;
+        if((wgdSw.csr & DMA_CSR_ESG_MASK) != 0){
+            wgdSwLoad((const WAVE_TCD_T *)wgdSw.dlast_sga);
+        } else if((wgdSw.csr & DMA_CSR_INTMAJOR_MASK) != 0){
+            wgdRefill(wgdSw.citer, wgdSw.biter);
+        } else{}
+    } else if(((wgdSw.csr & DMA_CSR_INTHALF_MASK) != 0) &&
+              (wgdSw.citer == (wgdSw.biter >> 1))){
+        wgdRefill(wgdSw.citer, wgdSw.biter);
+    } else{}
+    if(wgdProfOn != 0){
+        cyc = DWT->CYCCNT - start;
+        wgdProfCyc += cyc;
+        if(cyc > wgdProfCycMax){
+            wgdProfCycMax = cyc;
+        } else{}
+        if(lat > wgdProfLatMax){
+            wgdProfLatMax = lat;
+        } else{}
+    } else{}
+}
+
+/*******************************************************************************
+* wgdRefill() - PRIVATE
+*   parameter: citer - siren TCD CITER after the half or major loop
+*              biter - siren TCD BITER
+*   description: CITER shows the block being read and the other one is
+*   refilled, about 400 cycles every WAVE_SAMPLES_PER_BLOCK samples. The
+*   siren or clip stops once both blocks have played silence, a pattern at
+*   its end.
+*******************************************************************************/
+RAMFUNC static void wgdRefill(INT16U citer, INT16U biter){
+    INT16U *block = (citer > (biter >> 1)) ? &wgdBuf[WAVE_SAMPLES_PER_BLOCK] : &wgdBuf[0];
+    if(((wgdMode == WAVE_MODE_SIREN) || (wgdMode == WAVE_MODE_CLIP)) &&
+       (wgdTail < NUM_BLOCKS)){
+        wgdNext(block);
+        wgdProfSamples += WAVE_SAMPLES_PER_BLOCK;
+    } else{
+        wgdStop();
+    }
+}
+
+/*******************************************************************************
+* wgdSwLoad() - PRIVATE
+*   parameter: tcd - TCD for PIT0_IRQHandler() to run
+*   description: copies the TCD and works out its SMOD wrap mask. Runs from
+*   SRAM_L, PIT0_IRQHandler() calls it at a scatter-gather load.
+*******************************************************************************/
+RAMFUNC static void wgdSwLoad(const WAVE_TCD_T *tcd){
+    INT32U smod = ((INT32U)tcd->attr & DMA_ATTR_SMOD_MASK) >> DMA_ATTR_SMOD_SHIFT;
+    wgdSw = *tcd;
+    wgdSwMask = (smod != 0) ? (((INT32U)1U << smod) - 1U) : 0;
+}
+
+/*******************************************************************************
+* wgdStream() - PRIVATE
+*   parameter: none
+*   description: completes the siren TCD for the backend and starts it on
+*   the ping-pong buffer, both blocks filled, with its sample trigger at
+*   wgdReload
+*******************************************************************************/
+static void wgdStream(void){
+    INT8U idx;
+    if(wgdBe == WAVE_BE_DAC_BUF){
+        /* Fills DAT[0-7] and DAT[8-15] in turn, DMOD wraps back to DAT[0] */
+        wgdSirenTcd.attr = DMA_ATTR_SMOD(0) | DMA_ATTR_SSIZE(SIZE_CODE_16BIT) |
+                           DMA_ATTR_DMOD(WAVE_DAC_DMOD) | DMA_ATTR_DSIZE(SIZE_CODE_16BIT);
+        wgdSirenTcd.nbytes = WAVE_DAC_BURST*WAVE_BYTES_PER_SAMPLE;
+        wgdSirenTcd.doff = WAVE_BYTES_PER_SAMPLE;
+        wgdSirenTcd.citer = WAVE_BUF_SAMPLES / WAVE_DAC_BURST;
+    } else{
+        wgdSirenTcd.attr = WAVE_ATTR(0);
+        wgdSirenTcd.nbytes = WAVE_BYTES_PER_SAMPLE;
+        wgdSirenTcd.doff = 0;
+        wgdSirenTcd.citer = WAVE_BUF_SAMPLES;
+    }
+    wgdSirenTcd.biter = wgdSirenTcd.citer;
+    if(wgdBe == WAVE_BE_DAC_BUF){
+        /* The buffer starts with 16 mid-scale samples, the DMA refills
+         * DAT[0-7] at the bottom flag, then DAT[8-15] at the top flag */
+        for(idx = 0; idx < 16U; idx++){
+            DAC0->DAT[idx].DATL = DAC_DATL_DATA0(WAVE_DAC_MID);
+            DAC0->DAT[idx].DATH = DAC_DATH_DATA1(WAVE_DAC_MID >> 8);
+        }
+        DAC0->C2 = DAC_C2_DACBFUP(15U) | DAC_C2_DACBFRP(0);
+        DAC0->SR = 0;
+        DAC0->C0 = (DAC0->C0 & ~DAC_C0_DACTRGSEL_MASK) | DAC_C0_DACBTIEN_MASK |
+                   DAC_C0_DACBBIEN_MASK;
+        DAC0->C1 |= DAC_C1_DACBFEN_MASK;
+        wgdRun(&wgdSirenTcd, WAVE_DMAMUX_DAC);
+        /* counter period a multiple of the DAC interval so it never cuts one */
+        PDB0->MOD = ((WAVE_PDB_MOD_MAX / (wgdReload + 1U)) * (wgdReload + 1U)) - 1U;
+        PDB0->DAC[0].INT = PDB_INT_INT(wgdReload);
+        PDB0->DAC[0].INTC = PDB_INTC_TOE_MASK;
+        PDB0->SC = PDB_SC_PDBEN_MASK | PDB_SC_CONT_MASK | PDB_SC_TRGSEL(WAVE_PDB_TRG_SW) |
+                   PDB_SC_LDOK_MASK;
+        PDB0->SC |= PDB_SC_SWTRIG_MASK;
+    } else{
+        wgdRun(&wgdSirenTcd, WAVE_DMAMUX_CFG);
+        wgdTrigger();
+    }
+}
+
+/*******************************************************************************
+* wgdTrigger() - PRIVATE
+*   parameter: none
+*   description: starts PIT0 at wgdReload, the first sample one period later.
+*   It triggers the DMA, or interrupts for the ISR backend.
+*******************************************************************************/
+static void wgdTrigger(void){
+    PIT->CHANNEL[0].LDVAL = wgdReload;
+    PIT->CHANNEL[0].TFLG = PIT_TFLG_TIF(1);
+    if(wgdBe == WAVE_BE_ISR){
+        PIT->CHANNEL[0].TCTRL = PIT_TCTRL_TIE(1)|PIT_TCTRL_TEN(1);
+    } else{
+        PIT->CHANNEL[0].TCTRL = PIT_TCTRL_TEN(1);
+    }
+}
+
+/*******************************************************************************
+* wgdStop() - PRIVATE
+*   parameter: none
+*   description: stops the PIT and PDB triggers and the DMAMUX channel, so
+*   no DMA requests or PIT0 interrupts are made, and parks the DAC at
+*   mid-scale with its buffer off. Runs from SRAM_L, wgdRefill() calls it.
+*******************************************************************************/
+RAMFUNC static void wgdStop(void){
+    PIT->CHANNEL[0].TCTRL = 0;
+    PIT->CHANNEL[0].TFLG = PIT_TFLG_TIF(1);
+    PDB0->SC = 0;
+    DAC0->C0 = (DAC0->C0 & ~(DAC_C0_DACBTIEN_MASK|DAC_C0_DACBBIEN_MASK)) |
+               DAC_C0_DACTRGSEL_MASK;
+    DAC0->C1 &= ~DAC_C1_DACBFEN_MASK;
+    DMAMUX->CHCFG[WAVE_DMA_OUT_CH] = WAVE_DMAMUX_CFG;
+    DMA0->CINT = DMA_CINT_CINT(WAVE_DMA_OUT_CH);
+    NVIC_ClearPendingIRQ(WAVE_DMA_IRQn);
+    NVIC_ClearPendingIRQ(PIT0_IRQn);
+    DAC0->DAT[0].DATL = DAC_DATL_DATA0(WAVE_DAC_MID);
+    DAC0->DAT[0].DATH = DAC_DATH_DATA1(WAVE_DAC_MID >> 8);
+    wgdMode = WAVE_MODE_OFF;
+}
+
+/*******************************************************************************
+* wgdRun() - PRIVATE
+*   parameter: tcd - first TCD, 32 byte aligned if it has ESG set
+*              chcfg - DMAMUX source and trigger
+*   description: loads the TCD into the idle channel and enables its DMA
+*   requests, or hands it to PIT0_IRQHandler() for the ISR backend. The
+*   caller then starts the sample trigger.
+*******************************************************************************/
+static void wgdRun(const WAVE_TCD_T *tcd, INT8U chcfg){
+    if(wgdBe == WAVE_BE_ISR){
+        wgdSwLoad(tcd);
+    } else{
+        wgdRunDMA(tcd, chcfg);
+    }
+}
+
+/*******************************************************************************
+* wgdRunDMA() - PRIVATE
+*   parameter: tcd - first TCD, 32 byte aligned if it has ESG set
+*              chcfg - DMAMUX source and trigger
+*   description: loads the TCD into the idle DMA channel and enables its
+*   requests
+*******************************************************************************/
+static void wgdRunDMA(const WAVE_TCD_T *tcd, INT8U chcfg){
+    DMA0->CDNE = DMA_CDNE_CDNE(WAVE_DMA_OUT_CH);    /* ESG is ignored with DONE set */
+    DMA0->TCD[WAVE_DMA_OUT_CH].SADDR = tcd->saddr;
+    DMA0->TCD[WAVE_DMA_OUT_CH].SOFF = tcd->soff;
+    DMA0->TCD[WAVE_DMA_OUT_CH].ATTR = tcd->attr;
+    DMA0->TCD[WAVE_DMA_OUT_CH].NBYTES_MLNO = tcd->nbytes;
+    DMA0->TCD[WAVE_DMA_OUT_CH].SLAST = tcd->slast;
+    DMA0->TCD[WAVE_DMA_OUT_CH].DADDR = tcd->daddr;
+    DMA0->TCD[WAVE_DMA_OUT_CH].DOFF = tcd->doff;
+    DMA0->TCD[WAVE_DMA_OUT_CH].CITER_ELINKNO = tcd->citer;
+    DMA0->TCD[WAVE_DMA_OUT_CH].BITER_ELINKNO = tcd->biter;
+    DMA0->TCD[WAVE_DMA_OUT_CH].DLAST_SGA = tcd->dlast_sga;
+    DMA0->TCD[WAVE_DMA_OUT_CH].CSR = tcd->csr;
+    DMA0->SERQ = DMA_SERQ_SERQ(WAVE_DMA_OUT_CH);    /* DREQ cleared it at a pattern end */
+    DMAMUX->CHCFG[WAVE_DMA_OUT_CH] = chcfg|DMAMUX_CHCFG_ENBL(1);
+}
+
+/*******************************************************************************
+* wgdWaveLoad() - PRIVATE
+*   parameter: none
+*   description: takes the selected waveform, computes the trigger reload
+*   of its sample rate and the siren increments at it. Output must be stopped.
+*******************************************************************************/
+static void wgdWaveLoad(void){
+    const WAVE_BANK_T *wave = WaveBankGet(wgdWaveSel);
+    wgdTable = wave->table;
+    wgdBits = wave->bits;
+    wgdRate = wave->rate;
+    wgdReload = WaveBankReload(wgdRate);
+    wgdSirenCalc();
+}
+
+/*******************************************************************************
+* wgdSirenCalc() - PRIVATE
+*   parameter: none
+*   description: converts every siren of wgdSirens to phase increments and
+*   blocks at wgdRate. Done here, not at a siren change in the interrupt, as
+*   it divides in 64 bits.
+*******************************************************************************/
+static void wgdSirenCalc(void){
+    const WAVE_SIREN_CFG_T *cfg;
+    WAVE_SIREN_INC_T *inc;
+    INT32U blocks;
+    INT8U siren;
+    for(siren = 0; siren < WAVE_SIREN_NUM; siren++){
+        cfg = &wgdSirens[siren];
+        inc = &wgdSirenIncs[siren];
+        inc->lo = (INT32U)(((INT64U)cfg->lo << 32) / wgdRate);
+        inc->hi = (INT32U)(((INT64U)cfg->hi << 32) / wgdRate);
+        blocks = ((INT32U)cfg->sweep_ms * wgdRate) / (1000U * WAVE_SAMPLES_PER_BLOCK);
+        inc->step = (blocks != 0) ? ((inc->hi - inc->lo) / blocks) : 0;
+        inc->hold = (INT16U)(((INT32U)cfg->hold_ms * wgdRate) /
+                             (1000U * WAVE_SAMPLES_PER_BLOCK));
+    }
+}
+
+/*******************************************************************************
+* wgdSirenLoad() - PRIVATE
+*   parameter: none
+*   description: loads the wgdSirenCur increments and starts it at its lowest
+*   tone. Runs from SRAM_L, wgdFill() calls it at a siren change.
+*******************************************************************************/
+RAMFUNC static void wgdSirenLoad(void){
+    const WAVE_SIREN_INC_T *inc = &wgdSirenIncs[wgdSirenCur];
+    wgdLo = inc->lo;
+    wgdHi = inc->hi;
+    wgdStep = inc->step;
+    wgdHold = inc->hold;
+    wgdInc = wgdLo;
+    wgdHoldCnt = 0;
+    wgdSweepUp = 1;
+}
+
+/*******************************************************************************
+* wgdStart() - PRIVATE
+*   parameter: none
+*   description: starts the selected siren from phase 0 at its lowest tone
+*******************************************************************************/
+static void wgdStart(void){
+    wgdSirenCur = wgdSirenSel;
+    wgdPhase = 0;
+    wgdSirenLoad();
+}
+
+/*******************************************************************************
+* wgdFill() - PRIVATE
+*   parameter: block - WAVE_SAMPLES_PER_BLOCK samples to fill
+*   description: runs the oscillator for a block, then moves the tone one
+*   block along the siren pattern. The phase carries over a siren change.
+*******************************************************************************/
+RAMFUNC static void wgdFill(INT16U *block){
+    const INT16U *table = wgdTable;
+    INT32U phase = wgdPhase;
+    INT32U inc = wgdInc;
+    INT8U shift = 32U - wgdBits;                /* phase bits to a table index */
+    INT8U idx;
+    for(idx = 0; idx < WAVE_SAMPLES_PER_BLOCK; idx++){
+        block[idx] = table[phase >> shift];
+        phase += inc;
+    }
+    wgdPhase = phase;
+    if(wgdSirenSel != wgdSirenCur){
+        wgdSirenCur = wgdSirenSel;
+        wgdSirenLoad();
+        inc = wgdInc;
+    } else if(wgdHold != 0){
+        wgdHoldCnt++;
+        if(wgdHoldCnt >= wgdHold){
+            wgdHoldCnt = 0;
+            inc = (inc == wgdLo) ? wgdHi : wgdLo;
+        } else{}
+    } else if(wgdSweepUp != 0){
+        if((wgdHi - inc) <= wgdStep){
+            inc = wgdHi;
+            wgdSweepUp = 0;
+        } else{
+            inc += wgdStep;
+        }
+    } else{
+        if((inc - wgdLo) <= wgdStep){
+            inc = wgdLo;
+            wgdSweepUp = 1;
+        } else{
+            inc -= wgdStep;
+        }
+    }
+    wgdInc = inc;
+}
+
+/*******************************************************************************
+* wgdClipFill() - PRIVATE
+*   parameter: block - WAVE_SAMPLES_PER_BLOCK samples to fill
+*   description: decodes the next block of the clip in place and scales it to
+*   the 12 bit DAC. Past the end the block is filled with mid-scale and
+*   counted in wgdTail. Runs from SRAM_L.
+*******************************************************************************/
+RAMFUNC static void wgdClipFill(INT16U *block){
+    INT16S *pcm = (INT16S *)block;
+    INT32U left = wgdClip->samples - wgdClipPos;
+    INT8U num = (left > WAVE_SAMPLES_PER_BLOCK) ? WAVE_SAMPLES_PER_BLOCK : (INT8U)left;
+    INT8U idx;
+    if(num != 0){
+        AdpcmDecode(&wgdAdpcm, wgdClip->data, wgdClipPos, num, pcm);
+        wgdClipPos += num;
+    } else{
+        wgdTail++;
+    }
+    for(idx = 0; idx < num; idx++){
+        block[idx] = (INT16U)(((INT32S)pcm[idx] + 32768) >> 4);
+    }
+    for(idx = num; idx < WAVE_SAMPLES_PER_BLOCK; idx++){
+        block[idx] = WAVE_DAC_MID;
+    }
+}
+
+/*******************************************************************************
+* wgdNext() - PRIVATE
+*   parameter: block - WAVE_SAMPLES_PER_BLOCK samples to fill
+*   description: fills the block from the siren oscillator or the clip and
+*   applies the gain
+*******************************************************************************/
+RAMFUNC static void wgdNext(INT16U *block){
+    if(wgdMode == WAVE_MODE_SIREN){
+        wgdFill(block);
+    } else{
+        wgdClipFill(block);
+    }
+    wgdGainFill(block);
+}
+
+/*******************************************************************************
+* wgdGainFill() - PRIVATE
+*   parameter: block - WAVE_SAMPLES_PER_BLOCK samples, 32 bit aligned
+*   description: scales the block around mid-scale, a sample pair at a time
+*   with __SMULWB()/__SMULWT() on the two halves, five instructions a pair.
+*   The gain moves one step a pair towards the volume, or towards 0 when
+*   releasing. At unity the block is left as it is, at 0 it is mid-scale and
+*   counts towards the stop when releasing.
+*******************************************************************************/
+RAMFUNC static void wgdGainFill(INT16U *block){
+    INT32U *pair = (INT32U *)block;
+    INT32S gain = wgdGain;
+    INT32S target = (wgdReleasing != 0) ? 0 : wgdGainVol;
+    INT32U ctr;
+    INT8U idx;
+    if((gain == target) && (gain == WAVE_GAIN_UNITY)){
+        /* unity, no per sample cost */
+    } else if((gain == target) && (gain == 0)){
+        for(idx = 0; idx < (WAVE_SAMPLES_PER_BLOCK/2U); idx++){
+            pair[idx] = WAVE_DAC_MID2;
+        }
+        if(wgdReleasing != 0){
+            wgdTail++;
+        } else{}
+    } else{
+        for(idx = 0; idx < (WAVE_SAMPLES_PER_BLOCK/2U); idx++){
+            if(gain < target){
+                gain += wgdAttack;
+                if(gain > target){
+                    gain = target;
+                } else{}
+            } else if(gain > target){
+                gain -= wgdRelease;
+                if(gain < target){
+                    gain = target;
+                } else{}
+            } else{}
+            /* signed halves around mid-scale, x gain in Q16, back to 12 bit */
+            ctr = __SSUB16(pair[idx], WAVE_DAC_MID2);
+            pair[idx] = __SADD16(__PKHBT((INT32U)__SMULWB(gain << 1, ctr),
+                                         (INT32U)__SMULWT(gain << 1, ctr), 16),
+                                 WAVE_DAC_MID2);
+        }
+        wgdGain = gain;
+    }
+}
+
+/*******************************************************************************
+* wgdRampLoad() - PRIVATE
+*   parameter: none
+*   description: converts the attack and release times to gain steps per
+*   sample pair at wgdRate, and starts from silence with no stop pending
+*******************************************************************************/
+static void wgdRampLoad(void){
+    wgdAttack = ((WAVE_GAIN_UNITY * 2000) / (INT32S)(WAVE_ATTACK_MS * wgdRate)) + 1;
+    wgdRelease = ((WAVE_GAIN_UNITY * 2000) / (INT32S)(WAVE_RELEASE_MS * wgdRate)) + 1;
+    wgdGain = 0;
+    wgdReleasing = 0;
+    wgdTail = 0;
 }
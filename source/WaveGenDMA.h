@@ -1,7 +1,8 @@
 /*******************************************************************************
 * WaveGenDMA.h
 *
-* This module contains all function prototypes for WaveGenDMA.c
+* This module contains all function prototypes for WaveGenDMA.c, the sound
+* output of every backend
 *
 * Khoi Le, 12/01/2022
 *******************************************************************************/
@@ -12,19 +13,64 @@
 /*******************************************************************************
 * Definition of sample stream macros/constants
 *******************************************************************************/
+#define WAVE_BE_DEFAULT             WAVE_BE_DAC_BUF
 #define WAVE_DMA_OUT_CH             0
-#define NUM_BLOCKS                  1
+#define WAVE_DMA_IRQn               DMA0_DMA16_IRQn
+#define WAVE_DMA_IRQHandler         DMA0_DMA16_IRQHandler
+#define NUM_BLOCKS                  2       /* ping-pong, 256 bytes of RAM */
 #define WAVE_BYTES_PER_SAMPLE       2
 #define WAVE_SAMPLES_PER_BLOCK      64
 #define WAVE_BYTES_PER_BLOCK        128
-#define WAVE_BYTES_PER_BUFFER       (NUM_BLOCKS*BYTES_PER_BLOCK)
+#define WAVE_BYTES_PER_BUFFER       (NUM_BLOCKS*WAVE_BYTES_PER_BLOCK)
+#define WAVE_TCD_MAX                8       /* segments in a pattern */
 #define SIZE_CODE_16BIT             001
+#define WAVE_VOL_MAX                0x40U   /* full volume, the gain stage is skipped */
+#define WAVE_ATTACK_MS              30U     /* silence to full volume */
+#define WAVE_RELEASE_MS             60U     /* full volume to silence */
+#define WAVE_TEST_SIREN             0xFFU   /* WaveGenDMATestStep() of the siren */
+
+/* Output backends, the same sounds on each. Per product variant, pick by the
+ * cycles per sample of WaveGenDMATestStep() and the free DMA channels. */
+typedef enum{
+    WAVE_BE_ISR,            /* PIT0 interrupt writes each sample, no DMA */
+    WAVE_BE_DMA,            /* PIT0 triggers a DMA transfer per sample */
+    WAVE_BE_DAC_BUF,        /* siren and clips 8 samples a DMA request through
+                             * the DAC buffer, PDB paced, patterns as DMA */
+    WAVE_BE_NUM
+}WAVE_BE_T;
+
+typedef struct{
+    INT32U cycles;          /* CPU cycles in the output interrupt handlers */
+    INT32U samples;         /* samples filled meanwhile */
+    INT32U cyc_max;         /* longest handler run, CPU cycles */
+    INT32U lat_max;         /* longest PIT0 trigger to handler entry, CPU cycles,
+                             * ISR backend only */
+}WAVE_PROF_T;
+
+typedef enum{
+    WAVE_SIREN_STEADY,      /* 300Hz, the original single tone */
+    WAVE_SIREN_WAIL,        /* 600-1200Hz up and down in 2s each way */
+    WAVE_SIREN_YELP,        /* 600-1200Hz up and down in 150ms each way */
+    WAVE_SIREN_HILO,        /* 960Hz and 770Hz alternating every 500ms */
+    WAVE_SIREN_NUM
+}WAVE_SIREN_T;
+
+/* Patterns played by a scatter-gather TCD chain. Tones are multiples of the
+ * waveform base frequency, 300Hz for the 64 sample 19.2kHz waveforms. */
+typedef enum{
+    WAVE_PAT_CHIME,         /* 4, 3, 2 x base falling chime, once */
+    WAVE_PAT_PULSE,         /* 3 x base 200ms every second, loops */
+    WAVE_PAT_TONE,          /* steady 2 x base, loops */
+    WAVE_PAT_NUM
+}WAVE_PAT_T;
 
 /*******************************************************************************
 * WaveGenDMAEnable(INT8U mode) - PUBLIC
 *   parameter: mode - 1 to enable wave, 0 to disable wave
 *   description: the function takes the parameter (mode) to either enable or
-*   disable the sound wave
+*   disable the sound wave. Off stops the siren or pattern and parks the DAC
+*   at mid-scale, after a release ramp for the siren or a clip. On starts the
+*   siren from its first sample with an attack ramp.
 *******************************************************************************/
 void WaveGenDMAEnable(INT8U mode);
 
@@ -32,9 +78,122 @@ void WaveGenDMAEnable(INT8U mode);
 * WaveGenDMAInit() - PUBLIC
 *   parameter: none
 *   description: Initialization anything needed to generate the sound wave,
-*   which are PIT, DAC, and DMA. This function must be call before
-*   WaveGenDMAEnable()
+*   which are PIT, DAC, and DMA. The siren is left off. This function must
+*   be call before WaveGenDMAEnable()
 *******************************************************************************/
 void WaveGenDMAInit(void);
 
+/*******************************************************************************
+* WaveGenDMAPlay(WAVE_PAT_T pat) - PUBLIC
+*   parameter: pat - pattern to play
+*   description: stops the output and plays a pattern from a scatter-gather
+*   TCD chain, with no CPU. WaveGenDMAEnable(0) stops it.
+*******************************************************************************/
+void WaveGenDMAPlay(WAVE_PAT_T pat);
+
+/*******************************************************************************
+* WaveGenDMAPlayClip(INT8U clip) - PUBLIC
+*   parameter: clip - SoundClips.c clip number
+*   description: stops the output and plays an IMA-ADPCM clip at its own
+*   sample rate, decoded a block at a time in the DMA interrupt. Stops by
+*   itself at the end. Returns 0 if started, 1 if there is no such clip.
+*******************************************************************************/
+INT8U WaveGenDMAPlayClip(INT8U clip);
+
+/*******************************************************************************
+* WaveGenDMAActive() - PUBLIC
+*   parameter: none
+*   description: returns 1 while the siren, a pattern or a clip plays, 0 if
+*   not
+*******************************************************************************/
+INT8U WaveGenDMAActive(void);
+
+/*******************************************************************************
+* WaveGenDMASetSiren(WAVE_SIREN_T siren) - PUBLIC
+*   parameter: siren - tone pattern
+*   description: selects the siren, WAVE_SIREN_WAIL after reset. While the
+*   siren plays the change is made at the next block.
+*******************************************************************************/
+void WaveGenDMASetSiren(WAVE_SIREN_T siren);
+
+/*******************************************************************************
+* WaveGenDMAGetSiren() - PUBLIC
+*   parameter: none
+*   description: returns the selected siren
+*******************************************************************************/
+WAVE_SIREN_T WaveGenDMAGetSiren(void);
+
+/*******************************************************************************
+* WaveGenDMASetWave(WAVE_TBL_T wave) - PUBLIC
+*   parameter: wave - waveform of the bank
+*   description: selects the waveform, and with it the sample rate, for the
+*   next WaveGenDMAEnable(1) or WaveGenDMAPlay(). WaveBank.h must be
+*   included before this file.
+*******************************************************************************/
+void WaveGenDMASetWave(WAVE_TBL_T wave);
+
+/*******************************************************************************
+* WaveGenDMAGetWave() - PUBLIC
+*   parameter: none
+*   description: returns the selected waveform
+*******************************************************************************/
+WAVE_TBL_T WaveGenDMAGetWave(void);
+
+/*******************************************************************************
+* WaveGenDMASetVolume(INT8U vol) - PUBLIC
+*   parameter: vol - 0 to WAVE_VOL_MAX
+*   description: sets the siren and clip volume, WAVE_VOL_MAX after reset.
+*   While they play the gain ramps to the new level. Patterns are played by
+*   the DMA straight from the table and are always at full volume.
+*******************************************************************************/
+void WaveGenDMASetVolume(INT8U vol);
+
+/*******************************************************************************
+* WaveGenDMAGetVolume() - PUBLIC
+*   parameter: none
+*   description: returns the volume
+*******************************************************************************/
+INT8U WaveGenDMAGetVolume(void);
+
+/*******************************************************************************
+* WaveGenDMASetBackend(WAVE_BE_T be) - PUBLIC
+*   parameter: be - output backend
+*   description: stops the output and selects the backend of the next sound,
+*   WAVE_BE_DEFAULT after reset
+*******************************************************************************/
+void WaveGenDMASetBackend(WAVE_BE_T be);
+
+/*******************************************************************************
+* WaveGenDMAGetBackend() - PUBLIC
+*   parameter: none
+*   description: returns the output backend
+*******************************************************************************/
+WAVE_BE_T WaveGenDMAGetBackend(void);
+
+/*******************************************************************************
+* WaveGenDMAProfStart() - PUBLIC
+*   parameter: none
+*   description: counts the DWT cycles spent in the output interrupts and the
+*   samples they fill, and the longest run and entry latency, from 0
+*******************************************************************************/
+void WaveGenDMAProfStart(void);
+
+/*******************************************************************************
+* WaveGenDMAProfGet(WAVE_PROF_T *prof) - PUBLIC
+*   parameter: prof - cycles and samples since WaveGenDMAProfStart()
+*   description: reads the counts and stops counting
+*******************************************************************************/
+void WaveGenDMAProfGet(WAVE_PROF_T *prof);
+
+/*******************************************************************************
+* WaveGenDMATestStep(INT8U step, INT8U clip, WAVE_PROF_T *prof) - PUBLIC
+*   parameter: step - 0 to start the self-test, then any other value
+*              clip - SoundClips.c clip to profile, or WAVE_TEST_SIREN
+*              prof - WAVE_BE_NUM results, indexed by WAVE_BE_T
+*   description: plays the siren or the clip a moment on each backend in
+*   turn and profiles it. Call until it returns 0, the output is then off
+*   with the backend as it was.
+*******************************************************************************/
+INT8U WaveGenDMATestStep(INT8U step, INT8U clip, WAVE_PROF_T *prof);
+
 #endif
@@ -0,0 +1,105 @@
+/*******************************************************************************
+* WaveTables.c
+*
+* Waveform tables of WaveBank.c, one cycle each, aligned to their size and
+* copied to SRAM_L at boot.
+* Generated by tools/wave_tables.py from the parameters there, do not edit.
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+/*******************************************************************************
+* Includes
+*******************************************************************************/
+#include "MCUType.h"
+#include "WaveTables.h"
+
+/*******************************************************************************
+* Tables
+*******************************************************************************/
+/* The original siren sample */
+const INT16U WaveTblSiren[64] RAMDATA __attribute__((aligned(128))) =
+{0x07FF,0x0CA4,0x0D60,0x0AA6,0x0836,0x085A,0x09A5,0x09AD,
+ 0x0877,0x07F1,0x08C9,0x097C,0x08D5,0x07E1,0x0845,0x0989,
+ 0x0999,0x0819,0x0793,0x0A36,0x0E4C,0x0F94,0x0C45,0x0763,
+ 0x0544,0x06AC,0x089B,0x0889,0x0746,0x0711,0x0828,0x08C2,
+ 0x07FF,0x073B,0x07D6,0x08ED,0x08B8,0x0775,0x0763,0x0952,
+ 0x0ABA,0x089B,0x03B9,0x006A,0x01B2,0x05C8,0x086B,0x07E5,
+ 0x0665,0x0675,0x07B9,0x081D,0x0729,0x0682,0x0735,0x080D,
+ 0x0787,0x0651,0x0659,0x07A4,0x07C8,0x0558,0x029E,0x035A};
+
+/* Full scale sine */
+const INT16U WaveTblSine[64] RAMDATA __attribute__((aligned(128))) =
+{0x07FF,0x08C8,0x098E,0x0A51,0x0B0E,0x0BC4,0x0C70,0x0D12,
+ 0x0DA6,0x0E2D,0x0EA5,0x0F0C,0x0F62,0x0FA6,0x0FD7,0x0FF4,
+ 0x0FFE,0x0FF4,0x0FD7,0x0FA6,0x0F62,0x0F0C,0x0EA5,0x0E2D,
+ 0x0DA6,0x0D12,0x0C70,0x0BC4,0x0B0E,0x0A51,0x098E,0x08C8,
+ 0x07FF,0x0736,0x0670,0x05AD,0x04F0,0x043A,0x038E,0x02EC,
+ 0x0258,0x01D1,0x0159,0x00F2,0x009C,0x0058,0x0027,0x000A,
+ 0x0000,0x000A,0x0027,0x0058,0x009C,0x00F2,0x0159,0x01D1,
+ 0x0258,0x02EC,0x038E,0x043A,0x04F0,0x05AD,0x0670,0x0736};
+
+/* Square with a mid-scale sample at each edge */
+const INT16U WaveTblSquare[64] RAMDATA __attribute__((aligned(128))) =
+{0x07FF,0x0DFF,0x0DFF,0x0DFF,0x0DFF,0x0DFF,0x0DFF,0x0DFF,
+ 0x0DFF,0x0DFF,0x0DFF,0x0DFF,0x0DFF,0x0DFF,0x0DFF,0x0DFF,
+ 0x0DFF,0x0DFF,0x0DFF,0x0DFF,0x0DFF,0x0DFF,0x0DFF,0x0DFF,
+ 0x0DFF,0x0DFF,0x0DFF,0x0DFF,0x0DFF,0x0DFF,0x0DFF,0x0DFF,
+ 0x07FF,0x01FF,0x01FF,0x01FF,0x01FF,0x01FF,0x01FF,0x01FF,
+ 0x01FF,0x01FF,0x01FF,0x01FF,0x01FF,0x01FF,0x01FF,0x01FF,
+ 0x01FF,0x01FF,0x01FF,0x01FF,0x01FF,0x01FF,0x01FF,0x01FF,
+ 0x01FF,0x01FF,0x01FF,0x01FF,0x01FF,0x01FF,0x01FF,0x01FF};
+
+/* Chirp from 2 to 6 cycles per table, 4 cycles in all so it joins up */
+const INT16U WaveTblSweep[256] RAMDATA __attribute__((aligned(512))) =
+{0x07FF,0x0857,0x08B0,0x0909,0x0962,0x09BB,0x0A13,0x0A6B,
+ 0x0AC2,0x0B17,0x0B6B,0x0BBD,0x0C0D,0x0C5A,0x0CA5,0x0CED,
+ 0x0D31,0x0D72,0x0DAF,0x0DE8,0x0E1C,0x0E4C,0x0E77,0x0E9D,
+ 0x0EBD,0x0ED8,0x0EED,0x0EFC,0x0F05,0x0F07,0x0F03,0x0EF8,
+ 0x0EE7,0x0ECE,0x0EAF,0x0E8A,0x0E5D,0x0E2A,0x0DF0,0x0DB0,
+ 0x0D69,0x0D1C,0x0CCA,0x0C71,0x0C13,0x0BB0,0x0B49,0x0ADD,
+ 0x0A6D,0x09FA,0x0983,0x090B,0x0890,0x0814,0x0797,0x071A,
+ 0x069D,0x0622,0x05A8,0x0530,0x04BC,0x044B,0x03DF,0x0378,
+ 0x0316,0x02BB,0x0266,0x0219,0x01D4,0x0198,0x0164,0x013A,
+ 0x011A,0x0104,0x00F9,0x00F8,0x0102,0x0117,0x0137,0x0162,
+ 0x0198,0x01D9,0x0224,0x0279,0x02D7,0x033F,0x03AF,0x0428,
+ 0x04A7,0x052D,0x05B9,0x0649,0x06DD,0x0774,0x080C,0x08A5,
+ 0x093E,0x09D4,0x0A68,0x0AF8,0x0B83,0x0C08,0x0C85,0x0CFA,
+ 0x0D66,0x0DC7,0x0E1C,0x0E66,0x0EA2,0x0ED1,0x0EF1,0x0F03,
+ 0x0F06,0x0EFA,0x0EDF,0x0EB4,0x0E7A,0x0E32,0x0DDB,0x0D77,
+ 0x0D05,0x0C88,0x0C00,0x0B6D,0x0AD2,0x0A30,0x0987,0x08DB,
+ 0x082B,0x077B,0x06CB,0x061D,0x0573,0x04D0,0x0433,0x03A0,
+ 0x0318,0x029C,0x022E,0x01CE,0x017F,0x0142,0x0116,0x00FD,
+ 0x00F7,0x0105,0x0127,0x015B,0x01A3,0x01FE,0x0269,0x02E6,
+ 0x0372,0x040C,0x04B2,0x0562,0x061B,0x06DA,0x079E,0x0863,
+ 0x0928,0x09EA,0x0AA6,0x0B5B,0x0C06,0x0CA4,0x0D34,0x0DB4,
+ 0x0E21,0x0E7B,0x0EBF,0x0EED,0x0F04,0x0F04,0x0EEB,0x0EBB,
+ 0x0E73,0x0E15,0x0DA1,0x0D19,0x0C7E,0x0BD3,0x0B1A,0x0A55,
+ 0x0987,0x08B2,0x07DA,0x0702,0x062E,0x055F,0x0499,0x03E0,
+ 0x0336,0x029E,0x021A,0x01AC,0x0158,0x011D,0x00FD,0x00F9,
+ 0x0111,0x0145,0x0195,0x01FF,0x0283,0x031D,0x03CC,0x048D,
+ 0x055E,0x063A,0x071E,0x0807,0x08F0,0x09D6,0x0AB4,0x0B88,
+ 0x0C4C,0x0CFE,0x0D9A,0x0E1D,0x0E85,0x0ECF,0x0EFB,0x0F07,
+ 0x0EF2,0x0EBD,0x0E68,0x0DF5,0x0D65,0x0CBB,0x0BFA,0x0B25,
+ 0x0A41,0x0951,0x0859,0x0760,0x0669,0x0578,0x0494,0x03C1,
+ 0x0302,0x025D,0x01D3,0x0169,0x0121,0x00FC,0x00FB,0x0120,
+ 0x0169,0x01D5,0x0262,0x030E,0x03D4,0x04B2,0x05A3,0x06A1};
+
+/* Eight harmonics with a peak at the fourth, a buzzy voice-like vowel */
+const INT16U WaveTblVoice[128] RAMDATA __attribute__((aligned(256))) =
+{0x07FF,0x09CB,0x0B7B,0x0CF2,0x0E1C,0x0EEB,0x0F5A,0x0F6B,
+ 0x0F29,0x0EA5,0x0DF3,0x0D29,0x0C5D,0x0BA1,0x0B02,0x0A88,
+ 0x0A34,0x0A03,0x09ED,0x09E9,0x09EC,0x09EC,0x09E3,0x09CD,
+ 0x09A9,0x097B,0x0948,0x0918,0x08F2,0x08DD,0x08DC,0x08F2,
+ 0x091B,0x0954,0x0995,0x09D8,0x0A12,0x0A3D,0x0A52,0x0A4F,
+ 0x0A34,0x0A02,0x09BD,0x096D,0x0917,0x08C2,0x0874,0x0831,
+ 0x07FC,0x07D5,0x07BC,0x07AE,0x07A9,0x07A9,0x07AD,0x07B2,
+ 0x07B8,0x07BD,0x07C2,0x07C8,0x07D0,0x07D9,0x07E4,0x07F1,
+ 0x07FF,0x080D,0x081A,0x0825,0x082E,0x0836,0x083C,0x0841,
+ 0x0846,0x084C,0x0851,0x0855,0x0855,0x0850,0x0842,0x0829,
+ 0x0802,0x07CD,0x078A,0x073C,0x06E7,0x0691,0x0641,0x05FC,
+ 0x05CA,0x05AF,0x05AC,0x05C1,0x05EC,0x0626,0x0669,0x06AA,
+ 0x06E3,0x070C,0x0722,0x0721,0x070C,0x06E6,0x06B6,0x0683,
+ 0x0655,0x0631,0x061B,0x0612,0x0612,0x0615,0x0611,0x05FB,
+ 0x05CA,0x0576,0x04FC,0x045D,0x03A1,0x02D5,0x020B,0x0159,
+ 0x00D5,0x0093,0x00A4,0x0113,0x01E2,0x030C,0x0483,0x0633};
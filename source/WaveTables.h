@@ -0,0 +1,28 @@
+/*******************************************************************************
+* WaveTables.h
+*
+* This module contains the waveform table declarations of WaveTables.c
+* Generated by tools/wave_tables.py, do not edit.
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+#ifndef WAVETABLESH
+#define WAVETABLESH
+
+/*******************************************************************************
+* Definition of waveform table macros/constants
+*******************************************************************************/
+#define WAVE_TBL_SIREN_BITS       6U
+#define WAVE_TBL_SINE_BITS        6U
+#define WAVE_TBL_SQUARE_BITS      6U
+#define WAVE_TBL_SWEEP_BITS       8U
+#define WAVE_TBL_VOICE_BITS       7U
+
+extern const INT16U WaveTblSiren[64];
+extern const INT16U WaveTblSine[64];
+extern const INT16U WaveTblSquare[64];
+extern const INT16U WaveTblSweep[256];
+extern const INT16U WaveTblVoice[128];
+
+#endif
@@ -0,0 +1,177 @@
+/*******************************************************************************
+* Zone.c
+*
+* This module contains the alarm zone layer. Each zone in zoneTable[] maps one
+* input bit of a source (TSI, GPIO or accelerometer) to a zone type. Every
+* source is read once per slice and all zones are evaluated in one pass into a
+* 32-bit active mask, so inputs are added to the table and not to the tasks.
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+/*******************************************************************************
+* Includes
+*******************************************************************************/
+#include "MCUType.h"
+#include "K65TWR_GPIO.h"
+#include "K65TWR_TSI.h"
+#include "Zone.h"
+#include "EventBus.h"
+
+/*******************************************************************************
+* Private Resources
+*******************************************************************************/
+#define ZONE_NUM_PORTS 5U
+
+static const ZONE_CFG_T zoneTable[] = {
+    {ZONE_SRC_TSI,   0, BRD_PAD1_CH, 0, ZONE_INSTANT},   /* ZONE_ID_PAD1 */
+    {ZONE_SRC_TSI,   0, BRD_PAD2_CH, 0, ZONE_INSTANT},   /* ZONE_ID_PAD2 */
+    {ZONE_SRC_ACCEL, 0, 0,           0, ZONE_TAMPER}     /* ZONE_ID_ACCEL */
+};
+#define ZONE_NUM (sizeof(zoneTable)/sizeof(zoneTable[0]))
+
+static GPIO_Type *const zonePorts[ZONE_NUM_PORTS] = {GPIOA, GPIOB, GPIOC, GPIOD, GPIOE};
+
+static INT32U zoneSrcWord[ZONE_SRC_NUM + ZONE_NUM_PORTS];
+static INT8U zoneSrcIndex[ZONE_NUM];    /* zoneSrcWord[] index of each zone */
+static INT32U zoneBitMask[ZONE_NUM];
+static INT32U zoneInvMask[ZONE_NUM];
+static INT32U zoneTypeMask[ZONE_TYPE_NUM];
+static INT32U zoneSrcMask[ZONE_SRC_NUM];
+static INT16U zoneTsiChs;
+static INT8U zonePortsUsed;
+static INT32U zoneActive;
+static INT16U zoneLastTsiFlags;
+
+/******************************************************************************
+* Function Code
+******************************************************************************/
+
+/*******************************************************************************
+* ZoneInit() - PUBLIC
+*   parameter: none
+*   description: builds the per-type and per-source zone masks and the TSI
+*   channel set from the zone table. This function must be called before
+*   ZoneTask() and after the sources it reads have been initialized.
+*******************************************************************************/
+void ZoneInit(void){
+    INT8U zone;
+    INT8U type;
+    INT8U src;
+    for(type = 0; type < ZONE_TYPE_NUM; type++){
+        zoneTypeMask[type] = 0;
+    }
+    for(src = 0; src < ZONE_SRC_NUM; src++){
+        zoneSrcMask[src] = 0;
+    }
+    zoneTsiChs = 0;
+    zonePortsUsed = 0;
+    for(zone = 0; (zone < ZONE_NUM) && (zone < ZONE_MAX); zone++){
+        if(zoneTable[zone].src == ZONE_SRC_GPIO){
+            /* GPIO words follow the other sources, one per port */
+            zoneSrcIndex[zone] = (INT8U)(ZONE_SRC_NUM + zoneTable[zone].port);
+            zonePortsUsed |= (INT8U)(1U << zoneTable[zone].port);
+        } else{
+            zoneSrcIndex[zone] = (INT8U)zoneTable[zone].src;
+        }
+        zoneBitMask[zone] = (INT32U)1U << zoneTable[zone].bit;
+        zoneInvMask[zone] = (zoneTable[zone].active_low == 1) ? zoneBitMask[zone] : 0U;
+        zoneTypeMask[zoneTable[zone].type] |= ZONE_MASK(zone);
+        zoneSrcMask[zoneTable[zone].src] |= ZONE_MASK(zone);
+        if(zoneTable[zone].src == ZONE_SRC_TSI){
+            zoneTsiChs |= (INT16U)(1U << zoneTable[zone].bit);
+        } else{}
+    }
+    zoneActive = 0;
+    zoneLastTsiFlags = 0;
+}
+
+/*******************************************************************************
+* ZoneTask() - PUBLIC
+*   parameter: none
+*   description: reads every source once and evaluates all zones in a single
+*   pass. The TSI pads are scanned on alternate slices so a TSI input counts as
+*   active if it was set in this slice or the one before. A change of the
+*   active mask is posted as EVT_ZONE.
+*******************************************************************************/
+void ZoneTask(void){
+    INT8U zone;
+    INT8U port;
+    INT16U tsi_flags;
+    INT32U active = 0;
+    tsi_flags = TSIGetSensorFlags();
+    zoneSrcWord[ZONE_SRC_TSI] = (INT32U)(tsi_flags | zoneLastTsiFlags);
+    zoneLastTsiFlags = tsi_flags;
+    for(port = 0; port < ZONE_NUM_PORTS; port++){
+        if((zonePortsUsed & (1U << port)) != 0){
+            zoneSrcWord[ZONE_SRC_NUM + port] = zonePorts[port]->PDIR;
+        } else{}
+    }
+    for(zone = 0; (zone < ZONE_NUM) && (zone < ZONE_MAX); zone++){
+        if(((zoneSrcWord[zoneSrcIndex[zone]] ^ zoneInvMask[zone]) & zoneBitMask[zone]) != 0){
+            active |= ZONE_MASK(zone);
+        } else{}
+    }
+    if(active != zoneActive){
+        (void)EvtPost(EVT_ZONE, EVT_PRIO_HIGH, active);
+    } else{}
+    zoneActive = active;
+}
+
+/*******************************************************************************
+* ZoneSrcPost(ZONE_SRC_T src, INT32U bits) - PUBLIC
+*   parameter: src - source that is updated by a task instead of read by
+*                    ZoneTask(), currently ZONE_SRC_ACCEL
+*              bits - new input bits of the source
+*   description: posts the current inputs of a task driven source
+*******************************************************************************/
+void ZoneSrcPost(ZONE_SRC_T src, INT32U bits){
+    if(src == ZONE_SRC_ACCEL){
+        zoneSrcWord[ZONE_SRC_ACCEL] = bits;
+    } else{}
+}
+
+/*******************************************************************************
+* ZoneGetActive() - PUBLIC
+*   parameter: none
+*   description: returns the mask of zones that were active in the last pass
+*******************************************************************************/
+INT32U ZoneGetActive(void){
+    return zoneActive;
+}
+
+/*******************************************************************************
+* ZoneGetTypeMask(ZONE_TYPE_T type) - PUBLIC
+*   parameter: type - zone type
+*   description: returns the mask of all zones of that type
+*******************************************************************************/
+INT32U ZoneGetTypeMask(ZONE_TYPE_T type){
+    INT32U mask = 0;
+    if(type < ZONE_TYPE_NUM){
+        mask = zoneTypeMask[type];
+    } else{}
+    return mask;
+}
+
+/*******************************************************************************
+* ZoneGetSrcMask(ZONE_SRC_T src) - PUBLIC
+*   parameter: src - zone source
+*   description: returns the mask of all zones read from that source
+*******************************************************************************/
+INT32U ZoneGetSrcMask(ZONE_SRC_T src){
+    INT32U mask = 0;
+    if(src < ZONE_SRC_NUM){
+        mask = zoneSrcMask[src];
+    } else{}
+    return mask;
+}
+
+/*******************************************************************************
+* ZoneGetTsiChannels() - PUBLIC
+*   parameter: none
+*   description: returns a bit per TSI channel that a zone reads, so the LLS
+*   wakeup scans exactly the pads in the zone table
+*******************************************************************************/
+INT16U ZoneGetTsiChannels(void){
+    return zoneTsiChs;
+}
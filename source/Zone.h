@@ -0,0 +1,106 @@
+/*******************************************************************************
+* Zone.h
+*
+* This module contains all function prototypes and zone definitions for
+* Zone.c
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+#ifndef ZONEH
+#define ZONEH
+
+/*******************************************************************************
+* Zone sources and types
+*******************************************************************************/
+typedef enum {
+    ZONE_SRC_TSI,       /* bit is the TSI channel */
+    ZONE_SRC_GPIO,      /* port is 0-4 for PORTA-PORTE, bit is the pin */
+    ZONE_SRC_ACCEL,     /* bit is set by the accelerometer task */
+    ZONE_SRC_NUM
+} ZONE_SRC_T;
+
+typedef enum {
+    ZONE_INSTANT,       /* trips the alarm immediately when armed */
+    ZONE_DELAYED,       /* trips the alarm after the entry delay when armed */
+    ZONE_TAMPER,        /* 24-hour zone, reported in every state */
+    ZONE_TYPE_NUM
+} ZONE_TYPE_T;
+
+typedef struct{
+    ZONE_SRC_T src;
+    INT8U port;
+    INT8U bit;
+    INT8U active_low;   /* 1 if the input is active when the bit is 0 */
+    ZONE_TYPE_T type;
+}ZONE_CFG_T;
+
+/*******************************************************************************
+* Zone IDs. These are the indexes into the zone table in Zone.c and the bit
+* numbers of the zone masks.
+*******************************************************************************/
+#define ZONE_ID_PAD1        0
+#define ZONE_ID_PAD2        1
+#define ZONE_ID_ACCEL       2
+#define ZONE_MAX            32
+#define ZONE_MASK(id)       ((INT32U)1U << (id))
+#define ZONE_ACCEL_TILT     0x01U   /* accelerometer source bit */
+#define ZONE_ENTRY_DLY_MS   15000U  /* entry delay for ZONE_DELAYED zones */
+
+/*******************************************************************************
+* ZoneInit() - PUBLIC
+*   parameter: none
+*   description: builds the per-type and per-source zone masks and the TSI
+*   channel set from the zone table. This function must be called before
+*   ZoneTask() and after the sources it reads have been initialized.
+*******************************************************************************/
+void ZoneInit(void);
+
+/*******************************************************************************
+* ZoneTask() - PUBLIC
+*   parameter: none
+*   description: reads every source once and evaluates all zones in a single
+*   pass and posts EVT_ZONE when the active mask changes. Must be called once
+*   per slice before the tasks that use the zones.
+*******************************************************************************/
+void ZoneTask(void);
+
+/*******************************************************************************
+* ZoneSrcPost(ZONE_SRC_T src, INT32U bits) - PUBLIC
+*   parameter: src - source that is updated by a task instead of read by
+*                    ZoneTask(), currently ZONE_SRC_ACCEL
+*              bits - new input bits of the source
+*   description: posts the current inputs of a task driven source
+*******************************************************************************/
+void ZoneSrcPost(ZONE_SRC_T src, INT32U bits);
+
+/*******************************************************************************
+* ZoneGetActive() - PUBLIC
+*   parameter: none
+*   description: returns the mask of zones that were active in the last pass
+*******************************************************************************/
+INT32U ZoneGetActive(void);
+
+/*******************************************************************************
+* ZoneGetTypeMask(ZONE_TYPE_T type) - PUBLIC
+*   parameter: type - zone type
+*   description: returns the mask of all zones of that type
+*******************************************************************************/
+INT32U ZoneGetTypeMask(ZONE_TYPE_T type);
+
+/*******************************************************************************
+* ZoneGetSrcMask(ZONE_SRC_T src) - PUBLIC
+*   parameter: src - zone source
+*   description: returns the mask of all zones read from that source
+*******************************************************************************/
+INT32U ZoneGetSrcMask(ZONE_SRC_T src);
+
+/*******************************************************************************
+* ZoneGetTsiChannels() - PUBLIC
+*   parameter: none
+*   description: returns a bit per TSI channel that a zone reads, so the LLS
+*   wakeup scans exactly the pads in the zone table
+*******************************************************************************/
+INT16U ZoneGetTsiChannels(void);
+
+#endif
@@ -517,7 +517,9 @@ void ResetISR(void) {
     // Load base address of Global Section Table
     SectionTableAddr = &__data_section_table;
 
-    // Copy the data sections from flash to SRAM.
+    // Copy the data sections from flash to SRAM. With RAMFUNC or RAMDATA
+    // in use (MCUType.h) the table has a .data_RAM2 entry too, which copies
+    // the SRAM_L code and tables, so nothing in SRAM_L may run before here.
     while (SectionTableAddr < &__data_section_table_end) {
         LoadAddr = *SectionTableAddr++;
         ExeAddr = *SectionTableAddr++;
@@ -0,0 +1,29 @@
+/*******************************************************************************
+* MCUType.h
+*
+* Host stand-in for source/MCUType.h, used by adpcm_check.c only. It has the
+* same include guard, so it must be included before the modules under test,
+* and gives the target types their target sizes.
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+#ifndef  MCU_TYPE_PRESENT
+#define  MCU_TYPE_PRESENT
+
+#include <stdint.h>
+
+typedef char        INT8C;
+typedef uint8_t     INT8U;
+typedef int8_t      INT8S;
+typedef uint16_t    INT16U;
+typedef int16_t     INT16S;
+typedef uint32_t    INT32U;
+typedef int32_t     INT32S;
+typedef uint64_t    INT64U;
+typedef int64_t     INT64S;
+
+#define RAMFUNC
+#define RAMDATA
+
+#endif
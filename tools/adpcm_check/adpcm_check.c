@@ -0,0 +1,88 @@
+/*******************************************************************************
+* adpcm_check.c
+*
+* Host test of source/Adpcm.c against the clips of source/SoundClips.c. Every
+* clip is decoded with AdpcmDecode() in WAVE_SAMPLES_PER_BLOCK sample blocks,
+* the state carried from block to block as wgdClipFill() does in the DMA
+* interrupt, and the MemCrc16() of the samples compared with the crc that
+* tools/adpcm_encode.py stored from its own decoder.
+*
+*   cc -O2 -Wall -Wextra -o adpcm_check tools/adpcm_check/adpcm_check.c
+*   ./adpcm_check
+*
+* Prints each clip and ok, and exits 0, or exits 1 on a CRC mismatch.
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+/*******************************************************************************
+* Includes
+*******************************************************************************/
+#include "MCUType.h"                /* the host stand-in, before the modules */
+#include "../../source/Adpcm.c"
+#include "../../source/MemoryTools.c"
+#include "../../source/SoundClips.c"
+#include <stdio.h>
+
+/*******************************************************************************
+* Private Resources
+*******************************************************************************/
+#define ACK_BLOCK       64U         /* WAVE_SAMPLES_PER_BLOCK */
+
+static INT16U ackClipCrc(const SOUND_CLIP_T *clip);
+
+/******************************************************************************
+* Function Code
+******************************************************************************/
+
+/*******************************************************************************
+* main() - PUBLIC
+*   parameter: none
+*   description: checks every clip and reports
+*******************************************************************************/
+int main(void){
+    const SOUND_CLIP_T *clip;
+    INT16U crc;
+    INT8U num;
+    INT8U fail = 0;
+    for(num = 0; (clip = SoundClipGet(num)) != (const SOUND_CLIP_T *)0; num++){
+        crc = ackClipCrc(clip);
+        printf("%u %s %lu samples crc %04X %s\n", (unsigned)num, clip->name,
+               (unsigned long)clip->samples, (unsigned)crc,
+               (crc == clip->crc) ? "ok" : "FAIL");
+        if(crc != clip->crc){
+            fail = 1;
+        } else{}
+    }
+    printf("%s\n", ((fail == 0) && (num != 0)) ? "ok" : "FAIL");
+    return ((fail == 0) && (num != 0)) ? 0 : 1;
+}
+
+/*******************************************************************************
+* ackClipCrc() - PRIVATE
+*   parameter: clip - clip to decode
+*   description: decodes the clip a block at a time from its start state and
+*   returns the CRC of the little-endian INT16S samples
+*******************************************************************************/
+static INT16U ackClipCrc(const SOUND_CLIP_T *clip){
+    ADPCM_STATE_T state;
+    INT16S pcm[ACK_BLOCK];
+    INT8U bytes[ACK_BLOCK * 2U];
+    INT32U pos = 0;
+    INT16U crc = MEM_CRC16_INIT;
+    INT16U num;
+    INT16U idx;
+    state.pred = clip->pred;
+    state.index = clip->index;
+    while(pos < clip->samples){
+        num = ((clip->samples - pos) > ACK_BLOCK) ? ACK_BLOCK : (INT16U)(clip->samples - pos);
+        AdpcmDecode(&state, clip->data, pos, num, pcm);
+        for(idx = 0; idx < num; idx++){
+            bytes[2U * idx] = (INT8U)((INT16U)pcm[idx] & 0xFFU);
+            bytes[(2U * idx) + 1U] = (INT8U)((INT16U)pcm[idx] >> 8);
+        }
+        crc = MemCrc16(crc, bytes, (INT32U)num * 2U);
+        pos += num;
+    }
+    return crc;
+}
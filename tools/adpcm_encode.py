@@ -0,0 +1,231 @@
+#!/usr/bin/env python3
+"""Encode sound clips to IMA-ADPCM for the HomeAlarmSystem sound table.
+
+Reads mono 16 bit WAV files and writes source/SoundClips.c, the flash table
+played by WaveGenDMAPlayClip(). The clip name is the file name without its
+extension. --chime adds a synthesized two tone chime for boards with no
+recordings yet.
+
+    adpcm_encode.py armed.wav enter_code.wav --chime -o source/SoundClips.c
+    adpcm_encode.py --selftest
+
+Every clip entry carries the CRC-16/CCITT (MemCrc16()) of the samples the
+decoder must produce, as little-endian INT16S. tools/adpcm_check builds
+source/Adpcm.c on the host, decodes every clip in 64 sample blocks as the DMA
+interrupt does and compares, and the shell command "clip check" does the same
+on the target, so Adpcm.c is checked bit for bit against decode() below.
+Run adpcm_check after every new SoundClips.c. --selftest only checks that
+decode() and the encoder's own reconstruction agree, over a test signal.
+"""
+
+import argparse
+import math
+import os
+import struct
+import sys
+import wave
+
+# Standard IMA-ADPCM tables, the same as Adpcm.c
+STEPS = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41,
+    45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209,
+    230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876,
+    963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749,
+    3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630,
+    9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385,
+    24623, 27086, 29794, 32767]
+INDEX_ADJ = [-1, -1, -1, -1, 2, 4, 6, 8]
+
+CHIME_RATE = 8000
+
+
+def clamp(val, low, high):
+    return low if val < low else high if val > high else val
+
+
+def step_code(pred, index, code):
+    """One decoder step, returns the new (pred, index)."""
+    step = STEPS[index]
+    diff = step >> 3
+    if code & 4:
+        diff += step
+    if code & 2:
+        diff += step >> 1
+    if code & 1:
+        diff += step >> 2
+    pred = pred - diff if code & 8 else pred + diff
+    return clamp(pred, -32768, 32767), clamp(index + INDEX_ADJ[code & 7], 0, 88)
+
+
+def encode(samples):
+    """Returns (data, first sample, first index, reconstruction)."""
+    pred = samples[0] if samples else 0
+    index = 0
+    first = (pred, index)
+    codes = []
+    recon = []
+    for sample in samples:
+        step = STEPS[index]
+        diff = sample - pred
+        code = 8 if diff < 0 else 0
+        diff = abs(diff)
+        if diff >= step:
+            code |= 4
+            diff -= step
+        if diff >= step >> 1:
+            code |= 2
+            diff -= step >> 1
+        if diff >= step >> 2:
+            code |= 1
+        pred, index = step_code(pred, index, code)
+        codes.append(code)
+        recon.append(pred)
+    if len(codes) & 1:
+        codes.append(0)
+    data = bytes(codes[n] | (codes[n + 1] << 4) for n in range(0, len(codes), 2))
+    return data, first[0], first[1], recon
+
+
+def decode(data, count, pred, index):
+    """Decodes count samples, low nibble first."""
+    out = []
+    for byte in data:
+        for code in (byte & 0x0F, byte >> 4):
+            if len(out) == count:
+                return out
+            pred, index = step_code(pred, index, code)
+            out.append(pred)
+    return out
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/CCITT, the same as MemCrc16()."""
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def read_wav(path):
+    with wave.open(path, "rb") as wav:
+        if wav.getnchannels() != 1 or wav.getsampwidth() != 2:
+            sys.exit("%s: must be mono 16 bit" % path)
+        rate = wav.getframerate()
+        raw = wav.readframes(wav.getnframes())
+    return rate, list(struct.unpack("<%dh" % (len(raw) // 2), raw))
+
+
+def chime():
+    """Two decaying tones, ding-dong."""
+    out = []
+    for freq, secs in ((659.3, 0.35), (523.3, 0.5)):
+        for n in range(int(secs * CHIME_RATE)):
+            t = n / CHIME_RATE
+            env = math.exp(-t * 5.0) * min(1.0, n / 40.0)
+            val = math.sin(2 * math.pi * freq * t) + 0.3 * math.sin(4 * math.pi * freq * t)
+            out.append(int(round(14000 * env * val)))
+    return CHIME_RATE, out
+
+
+def c_name(name):
+    return "".join(ch if ch.isalnum() else "_" for ch in name)
+
+
+def write_table(path, clips):
+    lines = [
+        "/" + "*" * 79,
+        "* SoundClips.c",
+        "*",
+        "* IMA-ADPCM sound clips played by WaveGenDMAPlayClip(). Generated by",
+        "* tools/adpcm_encode.py, do not edit.",
+        "*",
+        "* Khoi Le, 19/10/2026",
+        "*" * 79 + "/",
+        "",
+        "/" + "*" * 79,
+        "* Includes",
+        "*" * 79 + "/",
+        '#include "MCUType.h"',
+        '#include "SoundClips.h"',
+        "",
+        "/" + "*" * 79,
+        "* Private Resources",
+        "*" * 79 + "/",
+    ]
+    for name, rate, data, pred, index, count, crc in clips:
+        lines.append("static const INT8U scData_%s[%d] = {" % (c_name(name), len(data)))
+        for pos in range(0, len(data), 12):
+            chunk = ",".join("0x%02X" % b for b in data[pos:pos + 12])
+            lines.append("    " + chunk + ("," if pos + 12 < len(data) else ""))
+        lines.append("};")
+        lines.append("")
+    lines.append("static const SOUND_CLIP_T scClips[] = {")
+    for num, (name, rate, data, pred, index, count, crc) in enumerate(clips):
+        lines.append('    {scData_%s, %dU, %dU, %d, %dU, 0x%04XU, "%s"}%s' %
+                     (c_name(name), count, rate, pred, index, crc, name,
+                      "," if num + 1 < len(clips) else ""))
+    lines += [
+        "};",
+        "",
+        "/" + "*" * 78,
+        "* Function Code",
+        "*" * 78 + "/",
+        "",
+        "/" + "*" * 79,
+        "* SoundClipGet(INT8U clip) - PUBLIC",
+        "*   parameter: clip - clip number",
+        "*   description: returns the clip, or NULL past the last one",
+        "*" * 79 + "/",
+        "const SOUND_CLIP_T *SoundClipGet(INT8U clip){",
+        "    return (clip < (INT8U)(sizeof(scClips)/sizeof(scClips[0]))) ?",
+        "           &scClips[clip] : (const SOUND_CLIP_T *)0;",
+        "}",
+        "",
+    ]
+    with open(path, "w", newline="\n") as out:
+        out.write("\n".join(lines))
+
+
+def selftest():
+    rate, samples = chime()
+    noise = [int(12000 * math.sin(n * 0.37) * math.sin(n * 0.011)) for n in range(5000)]
+    for signal in (samples, noise, [32767, -32768] * 200):
+        data, pred, index, recon = encode(signal)
+        if decode(data, len(signal), pred, index) != recon:
+            sys.exit("selftest failed")
+    print("selftest ok")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("wavs", nargs="*", help="mono 16 bit WAV files")
+    parser.add_argument("--chime", action="store_true", help="add the synthesized chime")
+    parser.add_argument("-o", "--output", default=os.path.join("source", "SoundClips.c"))
+    parser.add_argument("--selftest", action="store_true")
+    args = parser.parse_args()
+
+    if args.selftest:
+        selftest()
+        return
+    sources = []
+    if args.chime:
+        sources.append(("chime",) + chime())
+    for path in args.wavs:
+        sources.append((os.path.splitext(os.path.basename(path))[0],) + read_wav(path))
+    if not sources:
+        parser.error("give WAV files or --chime")
+
+    clips = []
+    for name, rate, samples in sources:
+        data, pred, index, recon = encode(samples)
+        crc = crc16(struct.pack("<%dh" % len(recon), *recon))
+        clips.append((name, rate, data, pred, index, len(samples), crc))
+        print("%-12s %6d samples %5d Hz %6d bytes" % (name, len(samples), rate, len(data)),
+              file=sys.stderr)
+    write_table(args.output, clips)
+
+
+if __name__ == "__main__":
+    main()
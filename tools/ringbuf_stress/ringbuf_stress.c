@@ -0,0 +1,225 @@
+/*******************************************************************************
+* ringbuf_stress.c
+*
+* Host stress test of source/RingBuf.c. A producer and a consumer thread
+* hand a counting sequence through a small ring, so both sides wrap and meet
+* full and empty all the time, and the consumer checks every element. Three
+* runs cover the word copy (4 byte elements), the byte copy (3 byte
+* elements) and the single byte calls mixed with the block calls.
+*
+*   cc -O2 -pthread -o ringbuf_stress tools/ringbuf_stress/ringbuf_stress.c
+*   ./ringbuf_stress [elements per run, 2000000 by default]
+*
+* Prints ok and exits 0, or prints the first bad element and exits 1.
+*
+* Khoi Le, 19/10/2026
+*******************************************************************************/
+
+/*******************************************************************************
+* Includes
+*******************************************************************************/
+#include "MCUType.h"                /* the host stand-in, before the module */
+#include "../../source/RingBuf.c"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*******************************************************************************
+* Private Resources
+*******************************************************************************/
+#define RBS_COUNT       64U         /* ring elements, small so it wraps a lot */
+#define RBS_CHUNK_MAX   40U         /* largest block pushed or popped at once */
+#define RBS_ELEM_MAX    4U
+#define RBS_DEFAULT     2000000UL
+
+typedef enum{
+    RBS_WORD,                       /* RingBufPush/Pop of 4 byte elements */
+    RBS_BYTES3,                     /* RingBufPush/Pop of 3 byte elements */
+    RBS_SINGLE,                     /* RingBufPutByte/GetByte mixed with blocks */
+    RBS_NUM
+}RBS_MODE_T;
+
+typedef struct{
+    RINGBUF_T rb;
+    RBS_MODE_T mode;
+    INT32U elem_size;
+    INT32U seq_mask;                /* sequence bits an element holds */
+    INT32U total;                   /* elements to pass */
+    volatile INT32U bad_at;         /* first bad element, or total if none */
+    INT8U store[RB_STORE_SIZE(RBS_COUNT, RBS_ELEM_MAX)] __attribute__((aligned(4)));
+}RBS_RUN_T;
+
+static const char *const rbsNames[RBS_NUM] = {"word", "bytes3", "single"};
+
+static INT32U rbsRand(INT32U *seed);
+static void rbsPut(INT8U *elem, INT32U elem_size, INT32U seq);
+static INT32U rbsGet(const INT8U *elem, INT32U elem_size);
+static void *rbsProducer(void *arg);
+static void *rbsConsumer(void *arg);
+static INT8U rbsRun(RBS_MODE_T mode, INT32U total);
+
+/******************************************************************************
+* Function Code
+******************************************************************************/
+
+/*******************************************************************************
+* main() - PUBLIC
+*   parameter: argc/argv - optional elements per run
+*   description: runs every mode and reports
+*******************************************************************************/
+int main(int argc, char *argv[]){
+    INT32U total = (argc > 1) ? (INT32U)strtoul(argv[1], 0, 0) : (INT32U)RBS_DEFAULT;
+    INT8U fail = 0;
+    RBS_MODE_T mode;
+    for(mode = RBS_WORD; mode < RBS_NUM; mode++){
+        fail |= rbsRun(mode, total);
+    }
+    printf("%s\n", (fail == 0) ? "ok" : "FAIL");
+    return (fail == 0) ? 0 : 1;
+}
+
+/*******************************************************************************
+* rbsRun() - PRIVATE
+*   parameter: mode - calls and element size
+*              total - elements to pass
+*   description: runs a producer and a consumer thread to the end, returns 0
+*   if every element came out in order, 1 if not
+*******************************************************************************/
+static INT8U rbsRun(RBS_MODE_T mode, INT32U total){
+    static RBS_RUN_T run;
+    pthread_t prod;
+    pthread_t cons;
+    INT8U rval = 0;
+    run.mode = mode;
+    run.elem_size = (mode == RBS_WORD) ? 4U : (mode == RBS_BYTES3) ? 3U : 1U;
+    run.seq_mask = (run.elem_size == 4U) ? 0xFFFFFFFFU : ((1U << (8U * run.elem_size)) - 1U);
+    run.total = total;
+    run.bad_at = total;
+    (void)RingBufInit(&run.rb, run.store, run.elem_size, RBS_COUNT);
+    (void)pthread_create(&cons, 0, rbsConsumer, &run);
+    (void)pthread_create(&prod, 0, rbsProducer, &run);
+    (void)pthread_join(prod, 0);
+    (void)pthread_join(cons, 0);
+    if(run.bad_at != total){
+        printf("%-6s bad element %lu\n", rbsNames[mode], (unsigned long)run.bad_at);
+        rval = 1;
+    } else{
+        printf("%-6s %lu elements\n", rbsNames[mode], (unsigned long)total);
+    }
+    return rval;
+}
+
+/*******************************************************************************
+* rbsProducer() - PRIVATE
+*   parameter: arg - the run
+*   description: pushes the sequence 0 .. total-1 in random sized blocks, and
+*   in RBS_SINGLE every other block one byte at a time. Stops early when the
+*   consumer finds a bad element.
+*******************************************************************************/
+static void *rbsProducer(void *arg){
+    RBS_RUN_T *run = (RBS_RUN_T *)arg;
+    INT8U buf[RBS_CHUNK_MAX * RBS_ELEM_MAX] __attribute__((aligned(4)));
+    INT32U seed = 0x1234567U;
+    INT32U seq = 0;
+    INT32U num;
+    INT32U done;
+    INT32U idx;
+    while((seq < run->total) && (run->bad_at == run->total)){
+        num = (rbsRand(&seed) % RBS_CHUNK_MAX) + 1U;
+        if(num > (run->total - seq)){
+            num = run->total - seq;
+        } else{}
+        for(idx = 0; idx < num; idx++){
+            rbsPut(&buf[idx * run->elem_size], run->elem_size, seq + idx);
+        }
+        if((run->mode == RBS_SINGLE) && ((num & 1U) != 0)){
+            done = 0;
+            while((done < num) && (RingBufPutByte(&run->rb, buf[done]) == 0)){
+                done++;
+            }
+        } else{
+            done = RingBufPush(&run->rb, buf, num);
+        }
+        seq += done;
+        if(done < num){
+            (void)sched_yield();
+        } else{}
+    }
+    return 0;
+}
+
+/*******************************************************************************
+* rbsConsumer() - PRIVATE
+*   parameter: arg - the run
+*   description: pops in random sized blocks, and in RBS_SINGLE every other
+*   block one byte at a time, and checks each element against its place in
+*   the sequence. Stops at the end or the first bad element.
+*******************************************************************************/
+static void *rbsConsumer(void *arg){
+    RBS_RUN_T *run = (RBS_RUN_T *)arg;
+    INT8U buf[RBS_CHUNK_MAX * RBS_ELEM_MAX] __attribute__((aligned(4)));
+    INT32U seed = 0x89ABCDEU;
+    INT32U seq = 0;
+    INT32U num;
+    INT32U done;
+    INT32U idx;
+    while((seq < run->total) && (run->bad_at == run->total)){
+        num = (rbsRand(&seed) % RBS_CHUNK_MAX) + 1U;
+        if((run->mode == RBS_SINGLE) && ((num & 1U) != 0)){
+            done = 0;
+            while((done < num) && (RingBufGetByte(&run->rb, &buf[done]) == 0)){
+                done++;
+            }
+        } else{
+            done = RingBufPop(&run->rb, buf, num);
+        }
+        for(idx = 0; idx < done; idx++){
+            if((rbsGet(&buf[idx * run->elem_size], run->elem_size) !=
+                ((seq + idx) & run->seq_mask)) &&
+               (run->bad_at == run->total)){
+                run->bad_at = seq + idx;
+            } else{}
+        }
+        seq += done;
+        if(done == 0){
+            (void)sched_yield();
+        } else{}
+    }
+    return 0;
+}
+
+/*******************************************************************************
+* rbsPut()/rbsGet() - PRIVATE
+*   parameter: elem - element bytes
+*              elem_size - 1, 3 or 4
+*              seq - sequence number
+*   description: store and load the low elem_size bytes of a sequence number
+*******************************************************************************/
+static void rbsPut(INT8U *elem, INT32U elem_size, INT32U seq){
+    INT32U idx;
+    for(idx = 0; idx < elem_size; idx++){
+        elem[idx] = (INT8U)(seq >> (8U * idx));
+    }
+}
+
+static INT32U rbsGet(const INT8U *elem, INT32U elem_size){
+    INT32U idx;
+    INT32U seq = 0;
+    for(idx = 0; idx < elem_size; idx++){
+        seq |= (INT32U)elem[idx] << (8U * idx);
+    }
+    return seq;
+}
+
+/*******************************************************************************
+* rbsRand() - PRIVATE
+*   parameter: seed - xorshift state of the thread
+*   description: returns the next pseudo random number
+*******************************************************************************/
+static INT32U rbsRand(INT32U *seed){
+    *seed ^= *seed << 13;
+    *seed ^= *seed >> 17;
+    *seed ^= *seed << 5;
+    return *seed;
+}
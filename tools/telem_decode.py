@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+"""Decode the HomeAlarmSystem telemetry stream (source/Telem.c) to CSV.
+
+Reads a raw capture file, or a serial port when pyserial is installed, splits
+it at 0x00 delimiters, COBS decodes every frame and checks its CRC. Shell text
+mixed into the stream lands between frames and is dropped as a bad frame.
+
+    telem_decode.py capture.bin -o out.csv
+    telem_decode.py --port /dev/ttyACM0 --baud 115200 -o out.csv
+
+One CSV row is written per sample: time_ms, seq and one column per channel.
+Gaps in the sequence numbers (frames dropped as busy or lost) are reported on
+stderr.
+"""
+
+import argparse
+import csv
+import struct
+import sys
+
+# Channel table of Lab5Main.c, mask bit 0 first: (name, signed)
+CHANNELS = [
+    ("tsi1", False),
+    ("tsi2", False),
+    ("ax", True),
+    ("ay", True),
+    ("az", True),
+]
+
+HDR = struct.Struct("<BBIBB")   # seq, mask, t0 ms, period ms, samples
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/CCITT, the same as MemCrc16()."""
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    """Returns the decoded frame or None if the encoding is broken."""
+    out = bytearray()
+    idx = 0
+    while idx < len(data):
+        code = data[idx]
+        if code == 0 or idx + code > len(data):
+            return None
+        out += data[idx + 1:idx + code]
+        idx += code
+        if code < 0xFF and idx < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def parse_frame(raw):
+    """Returns (seq, t0, period, [sample rows]) or None."""
+    if raw is None or len(raw) < HDR.size + 2:
+        return None
+    body, crc = raw[:-2], struct.unpack("<H", raw[-2:])[0]
+    if crc16(body) != crc:
+        return None
+    seq, mask, t0, period, count = HDR.unpack_from(body)
+    chans = [ch for ch in range(len(CHANNELS)) if mask & (1 << ch)]
+    if len(body) != HDR.size + count * len(chans) * 2:
+        return None
+    rows = []
+    pos = HDR.size
+    for _ in range(count):
+        row = {}
+        for ch in chans:
+            name, signed = CHANNELS[ch]
+            row[name] = struct.unpack_from("<h" if signed else "<H", body, pos)[0]
+            pos += 2
+        rows.append(row)
+    return seq, t0, period, rows
+
+
+def chunks(stream):
+    """Yields the bytes between 0x00 delimiters."""
+    buf = bytearray()
+    while True:
+        data = stream.read(256)
+        if not data:
+            break
+        for byte in data:
+            if byte == 0:
+                if buf:
+                    yield bytes(buf)
+                    buf.clear()
+            else:
+                buf.append(byte)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", nargs="?", help="raw capture file")
+    parser.add_argument("--port", help="serial port to read instead of a file")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("-o", "--output", help="CSV file, default stdout")
+    args = parser.parse_args()
+
+    if args.port:
+        import serial  # pyserial, only needed for live capture
+        stream = serial.Serial(args.port, args.baud, timeout=None)
+    elif args.capture:
+        stream = open(args.capture, "rb")
+    else:
+        parser.error("give a capture file or --port")
+
+    out = open(args.output, "w", newline="") if args.output else sys.stdout
+    writer = csv.writer(out)
+    writer.writerow(["time_ms", "seq"] + [name for name, _ in CHANNELS])
+
+    last_seq = None
+    bad = 0
+    frames = 0
+    try:
+        for chunk in chunks(stream):
+            frame = parse_frame(cobs_decode(chunk))
+            if frame is None:
+                bad += 1
+                continue
+            seq, t0, period, rows = frame
+            frames += 1
+            if last_seq is not None and seq != (last_seq + 1) & 0xFF:
+                print("seq gap: %d -> %d" % (last_seq, seq), file=sys.stderr)
+            last_seq = seq
+            for idx, row in enumerate(rows):
+                writer.writerow([t0 + idx * period, seq] +
+                                [row.get(name, "") for name, _ in CHANNELS])
+    except KeyboardInterrupt:
+        pass
+    print("%d frames, %d bad chunks" % (frames, bad), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
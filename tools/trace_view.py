@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""Render a HomeAlarmSystem trace dump (source/Trace.c) as a timeline.
+
+Reads a raw capture file, or a serial port when pyserial is installed, looks
+for the "TRC1" header sent by the shell command "trace dump" and decodes the
+records that follow. Shell text before the header is skipped.
+
+    trace_view.py capture.bin
+    trace_view.py --port /dev/ttyACM0 --baud 115200 --stats
+
+The timeline has one line per record: time in us from the first record, the
+context (thread or the exception name), the id and its argument. --stats
+prints per task run times from the TASK_START/TASK_END pairs and the count
+and rate of every other id instead.
+"""
+
+import argparse
+import struct
+import sys
+
+HDR = struct.Struct("<4sHHII")  # magic, count, rec_size, cpu_hz, total
+REC = struct.Struct("<IHHI")    # cycles, id, ctx (IPSR), arg
+MAGIC = b"TRC1"
+
+# TRACE_ID_T of Trace.h
+IDS = {
+    1: "TASK_START",
+    2: "TASK_END",
+    3: "SYSTICK",
+    4: "PIT0",
+    5: "UART2",
+    6: "UART2_DMA",
+    7: "LLWU",
+    8: "RTC_SEC",
+    9: "EVT",
+    10: "SLEEP",
+    11: "WAKE",
+}
+
+# Task table of Lab5Main.c, scheduler index order
+TASKS = ["Accel", "TSI", "Key", "Zone", "Evt", "Ctrl", "LED", "Clock", "CSum",
+         "Line", "Shell", "Telem"]
+
+# IPSR exception numbers, IRQn + 16 for the peripheral interrupts
+CONTEXTS = {
+    0: "thread",
+    11: "SVCall",
+    14: "PendSV",
+    15: "SysTick",
+    16 + 15: "DMA15",
+    16 + 21: "LLWU",
+    16 + 35: "UART2",
+    16 + 47: "RTC_Sec",
+    16 + 48: "PIT0",
+}
+
+
+def id_name(rec_id):
+    if rec_id in IDS:
+        return IDS[rec_id]
+    if rec_id >= 24:
+        return "USER%d" % (rec_id - 24)
+    return "ID%d" % rec_id
+
+
+def ctx_name(ctx):
+    return CONTEXTS.get(ctx, "exc%d" % ctx)
+
+
+def read_dump(stream):
+    """Returns (header tuple, [records]) of the first dump in the stream."""
+    buf = bytearray()
+    while True:
+        idx = buf.find(MAGIC)
+        if idx >= 0 and len(buf) - idx >= HDR.size:
+            buf = buf[idx:]
+            break
+        data = stream.read(256)
+        if not data:
+            return None
+        buf += data
+    hdr = HDR.unpack_from(buf)
+    _, count, rec_size, _, _ = hdr
+    if rec_size != REC.size:
+        sys.exit("record size %d, expected %d" % (rec_size, REC.size))
+    need = HDR.size + count * rec_size
+    while len(buf) < need:
+        data = stream.read(need - len(buf))
+        if not data:
+            sys.exit("dump cut short: %d of %d records" %
+                     ((len(buf) - HDR.size) // rec_size, count))
+        buf += data
+    recs = [REC.unpack_from(buf, HDR.size + n * rec_size) for n in range(count)]
+    return hdr, recs
+
+
+def unwrap(recs):
+    """Returns the cycle stamps made monotonic across 32 bit wraps."""
+    times = []
+    base = 0
+    last = None
+    for cyc, _, _, _ in recs:
+        if last is not None and cyc < last:
+            base += 1 << 32
+        times.append(base + cyc)
+        last = cyc
+    return times
+
+
+def timeline(recs, times, cpu_hz, tasks):
+    start = times[0]
+    prev = start
+    for (_, rec_id, ctx, arg), now in zip(recs, times):
+        name = id_name(rec_id)
+        if rec_id in (1, 2) and arg < len(tasks):
+            detail = tasks[arg]
+        elif rec_id in (5, 7):
+            detail = "0x%02X" % arg
+        else:
+            detail = str(arg)
+        print("%12.2f %+9.2f  %-8s %-10s %s" %
+              ((now - start) * 1e6 / cpu_hz, (now - prev) * 1e6 / cpu_hz,
+               ctx_name(ctx), name, detail))
+        prev = now
+
+
+def stats(recs, times, cpu_hz, tasks):
+    span = (times[-1] - times[0]) / cpu_hz if len(times) > 1 else 0.0
+    started = {}
+    runs = {}
+    counts = {}
+    for (_, rec_id, _, arg), now in zip(recs, times):
+        if rec_id == 1:
+            started[arg] = now
+        elif rec_id == 2:
+            if arg in started:
+                runs.setdefault(arg, []).append(now - started.pop(arg))
+        else:
+            counts[rec_id] = counts.get(rec_id, 0) + 1
+    print("%-8s %6s %10s %10s %10s" % ("task", "runs", "min us", "avg us", "max us"))
+    for task in sorted(runs):
+        us = [c * 1e6 / cpu_hz for c in runs[task]]
+        name = tasks[task] if task < len(tasks) else "task%d" % task
+        print("%-8s %6d %10.2f %10.2f %10.2f" %
+              (name, len(us), min(us), sum(us) / len(us), max(us)))
+    print()
+    print("%-10s %8s %10s" % ("id", "count", "per s"))
+    for rec_id in sorted(counts):
+        rate = counts[rec_id] / span if span > 0 else 0.0
+        print("%-10s %8d %10.1f" % (id_name(rec_id), counts[rec_id], rate))
+    print()
+    print("%d records over %.3f s" % (len(recs), span))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", nargs="?", help="raw capture file")
+    parser.add_argument("--port", help="serial port to read instead of a file")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--stats", action="store_true",
+                        help="per task and per id statistics, no timeline")
+    parser.add_argument("--tasks", help="comma separated task names, "
+                        "scheduler index order")
+    args = parser.parse_args()
+
+    if args.port:
+        import serial  # pyserial, only needed for live capture
+        stream = serial.Serial(args.port, args.baud, timeout=5)
+    elif args.capture:
+        stream = open(args.capture, "rb")
+    else:
+        parser.error("give a capture file or --port")
+    tasks = args.tasks.split(",") if args.tasks else TASKS
+
+    dump = read_dump(stream)
+    if dump is None:
+        sys.exit("no trace header found")
+    (_, count, _, cpu_hz, total), recs = dump
+    print("%d records, %d lost to wrap, %d Hz" % (count, total - count, cpu_hz),
+          file=sys.stderr)
+    if not recs:
+        return
+    times = unwrap(recs)
+    if args.stats:
+        stats(recs, times, cpu_hz, tasks)
+    else:
+        timeline(recs, times, cpu_hz, tasks)
+
+
+if __name__ == "__main__":
+    main()
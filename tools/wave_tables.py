@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+"""Generate the HomeAlarmSystem waveform tables from their parameters.
+
+Writes source/WaveTables.c and source/WaveTables.h, the tables of WaveBank.c
+played by every WaveGenDMA.c backend. They are RAMDATA, copied from flash to
+SRAM_L at boot. Each table in TABLES below is one cycle of a waveform, built
+from:
+
+    kind       sine, square, chirp, harmonics or sample (recorded values)
+    length     samples, a power of two so the DMA can wrap it with SMOD
+    amplitude  peak in DAC counts from the offset
+    offset     DAC value of 0, mid-scale by default
+    bits       DAC bit depth, samples are clamped to 0 .. 2^bits - 1
+
+Tables are aligned to their size in bytes. Edit TABLES and run
+
+    wave_tables.py              regenerate source/WaveTables.c/.h
+    wave_tables.py --check      compare the sources with a fresh generation
+
+--check also tests every table against reference values worked out by hand
+(peaks, zero crossings, edges), and exits non-zero on any difference.
+"""
+
+import argparse
+import math
+import os
+import sys
+
+DAC_BITS = 12
+
+# The original siren, a recorded sample, kept as it was
+SIREN = [
+    0x07FF, 0x0CA4, 0x0D60, 0x0AA6, 0x0836, 0x085A, 0x09A5, 0x09AD,
+    0x0877, 0x07F1, 0x08C9, 0x097C, 0x08D5, 0x07E1, 0x0845, 0x0989,
+    0x0999, 0x0819, 0x0793, 0x0A36, 0x0E4C, 0x0F94, 0x0C45, 0x0763,
+    0x0544, 0x06AC, 0x089B, 0x0889, 0x0746, 0x0711, 0x0828, 0x08C2,
+    0x07FF, 0x073B, 0x07D6, 0x08ED, 0x08B8, 0x0775, 0x0763, 0x0952,
+    0x0ABA, 0x089B, 0x03B9, 0x006A, 0x01B2, 0x05C8, 0x086B, 0x07E5,
+    0x0665, 0x0675, 0x07B9, 0x081D, 0x0729, 0x0682, 0x0735, 0x080D,
+    0x0787, 0x0651, 0x0659, 0x07A4, 0x07C8, 0x0558, 0x029E, 0x035A]
+
+# WAVE_TBL_T order of WaveBank.h
+TABLES = [
+    dict(name="Siren", kind="sample", length=64, values=SIREN,
+         comment="The original siren sample"),
+    dict(name="Sine", kind="sine", length=64, amplitude=2047,
+         comment="Full scale sine"),
+    dict(name="Square", kind="square", length=64, amplitude=0x600,
+         comment="Square with a mid-scale sample at each edge"),
+    dict(name="Sweep", kind="chirp", length=256, amplitude=1800, cycles=(2, 6),
+         comment="Chirp from 2 to 6 cycles per table, 4 cycles in all so it joins up"),
+    dict(name="Voice", kind="harmonics", length=128, amplitude=1900,
+         harmonics=(1, 0.8, 0.6, 0.9, 0.5, 0.3, 0.4, 0.2),
+         comment="Eight harmonics with a peak at the fourth, a buzzy voice-like vowel"),
+]
+
+
+def build(spec):
+    """Returns the table samples of a spec."""
+    bits = spec.get("bits", DAC_BITS)
+    top = (1 << bits) - 1
+    offset = spec.get("offset", top >> 1)
+    length = spec["length"]
+    amp = spec.get("amplitude", 0)
+    kind = spec["kind"]
+    if length & (length - 1):
+        sys.exit("%s: length %d is not a power of two" % (spec["name"], length))
+    if kind == "sample":
+        vals = list(spec["values"])
+        if len(vals) != length:
+            sys.exit("%s: %d values, length %d" % (spec["name"], len(vals), length))
+    elif kind == "sine":
+        vals = [offset + round(amp * math.sin(2 * math.pi * n / length))
+                for n in range(length)]
+    elif kind == "square":
+        half = length // 2
+        vals = [offset if n in (0, half) else offset + amp if n < half else offset - amp
+                for n in range(length)]
+    elif kind == "chirp":
+        # frequency rises linearly, the phase is the running sum
+        low, high = spec["cycles"]
+        phase = 0.0
+        vals = []
+        for n in range(length):
+            vals.append(offset + round(amp * math.sin(phase)))
+            phase += 2 * math.pi * (low + (high - low) * n / length) / length
+    elif kind == "harmonics":
+        raw = [sum(a * math.sin((k + 1) * 2 * math.pi * n / length)
+                   for k, a in enumerate(spec["harmonics"])) for n in range(length)]
+        peak = max(abs(x) for x in raw)
+        vals = [offset + round(amp * x / peak) for x in raw]
+    else:
+        sys.exit("%s: unknown kind %s" % (spec["name"], kind))
+    return [min(max(v, 0), top) for v in vals]
+
+
+def banner(name, text):
+    return ["/" + "*" * 79, "* " + name, "*"] + ["* " + t for t in text] + \
+           ["*", "* Khoi Le, 19/10/2026", "*" * 79 + "/"]
+
+
+def section(title):
+    return ["/" + "*" * 79, "* " + title, "*" * 79 + "/"]
+
+
+def c_source(tables):
+    lines = banner("WaveTables.c", [
+        "Waveform tables of WaveBank.c, one cycle each, aligned to their size and",
+        "copied to SRAM_L at boot.",
+        "Generated by tools/wave_tables.py from the parameters there, do not edit."])
+    lines += [""] + section("Includes") + ['#include "MCUType.h"', '#include "WaveTables.h"',
+                                           ""] + section("Tables")
+    for spec, vals in tables:
+        lines.append("/* %s */" % spec["comment"])
+        lines.append("const INT16U WaveTbl%s[%d] RAMDATA __attribute__((aligned(%d))) =" %
+                     (spec["name"], len(vals), 2 * len(vals)))
+        rows = [",".join("0x%04X" % v for v in vals[n:n + 8]) for n in range(0, len(vals), 8)]
+        lines.append("{" + ",\n ".join(rows) + "};")
+        lines.append("")
+    return "\n".join(lines)
+
+
+def c_header(tables):
+    lines = banner("WaveTables.h", [
+        "This module contains the waveform table declarations of WaveTables.c",
+        "Generated by tools/wave_tables.py, do not edit."])
+    lines += ["", "#ifndef WAVETABLESH", "#define WAVETABLESH", ""]
+    lines += section("Definition of waveform table macros/constants")
+    for spec, vals in tables:
+        lines.append("#define WAVE_TBL_%s_BITS%s%dU" %
+                     (spec["name"].upper(), " " * (12 - len(spec["name"])),
+                      len(vals).bit_length() - 1))
+    lines.append("")
+    for spec, vals in tables:
+        lines.append("extern const INT16U WaveTbl%s[%d];" % (spec["name"], len(vals)))
+    lines += ["", "#endif", ""]
+    return "\n".join(lines)
+
+
+def references(tables):
+    """Hand-worked values each table must hold, returns the failures."""
+    by_name = {spec["name"]: vals for spec, vals in tables}
+    mid = 0x7FF
+    checks = [
+        ("Siren", 0, mid), ("Siren", 32, mid), ("Siren", 21, 0x0F94),
+        ("Sine", 0, mid), ("Sine", 16, mid + 2047), ("Sine", 32, mid),
+        ("Sine", 48, mid - 2047), ("Sine", 8, mid + round(2047 * math.sqrt(0.5))),
+        ("Square", 0, mid), ("Square", 1, 0x0DFF), ("Square", 31, 0x0DFF),
+        ("Square", 32, mid), ("Square", 33, 0x01FF), ("Square", 63, 0x01FF),
+        ("Sweep", 0, mid), ("Voice", 0, mid), ("Voice", 64, mid),
+    ]
+    fails = []
+    for name, idx, want in checks:
+        if by_name[name][idx] != want:
+            fails.append("%s[%d] = 0x%04X, expected 0x%04X" % (name, idx, by_name[name][idx], want))
+    for spec, vals in tables:
+        top = (1 << spec.get("bits", DAC_BITS)) - 1
+        if min(vals) < 0 or max(vals) > top:
+            fails.append("%s out of the DAC range" % spec["name"])
+        if spec["kind"] in ("sine", "square", "harmonics") and \
+                abs(max(vals) - mid - spec["amplitude"]) > 1:
+            fails.append("%s peak %d, amplitude %d" % (spec["name"], max(vals) - mid,
+                                                       spec["amplitude"]))
+    return fails
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--check", action="store_true",
+                        help="compare the sources and the reference values, write nothing")
+    parser.add_argument("-d", "--dir", default="source", help="output directory")
+    args = parser.parse_args()
+
+    tables = [(spec, build(spec)) for spec in TABLES]
+    out = {"WaveTables.c": c_source(tables), "WaveTables.h": c_header(tables)}
+    if args.check:
+        fails = references(tables)
+        for name, text in out.items():
+            path = os.path.join(args.dir, name)
+            if not os.path.exists(path) or open(path).read() != text:
+                fails.append("%s differs from a fresh generation" % path)
+        for fail in fails:
+            print(fail, file=sys.stderr)
+        print("check %s" % ("failed" if fails else "ok"))
+        sys.exit(1 if fails else 0)
+    for name, text in out.items():
+        with open(os.path.join(args.dir, name), "w", newline="\n") as dst:
+            dst.write(text)
+    for spec, vals in tables:
+        print("%-8s %4d samples, aligned %d" % (spec["name"], len(vals), 2 * len(vals)),
+              file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()